@@ -0,0 +1,430 @@
+/**
+  * @file cachingdataimporter.cpp implements the CachingDataImporter class.
+  * @date 16.10.2026
+  */
+
+#include "cachingdataimporter.hh"
+
+#include <QTimer>
+
+#include <algorithm>
+
+namespace DataImporting
+{
+
+CachingDataImporter::CachingDataImporter(DataImporter* importer,
+                                         QObject* parent) :
+    DataImporter(parent), importer_(importer), cache_()
+{
+    importer_->setParent(this);
+
+    connect(importer_, &DataImporter::dataFetched,
+            this, &CachingDataImporter::storeFetchedData);
+    connect(importer_, &DataImporter::fetchProgressed,
+            this, &DataImporter::fetchProgressed);
+    connect(importer_, &DataImporter::fetchCancelled,
+            this, &CachingDataImporter::cancelFetchedPart);
+}
+
+CachingDataImporter::~CachingDataImporter()
+{
+    // Keep what arrived of unfinished fetches too
+    for (const auto& key : unwrittenEntries_)
+    {
+        cache_.writeEntry(importer_->getSourceName(), key.first, key.second,
+                          entries_.at(key));
+    }
+
+    if (!unwrittenEntries_.empty())
+    {
+        cache_.evictOldEntries();
+    }
+}
+
+void CachingDataImporter::fetchData(const ApiDataType& dataType,
+    const QDateTime& startTime, const QDateTime& endTime,
+    const std::string& location)
+{
+    qint64 startSecs = startTime.toSecsSinceEpoch();
+    qint64 endSecs = endTime.toSecsSinceEpoch();
+
+    for (ApiDataType thisDataType : DataImporter::separateDataTypes(dataType))
+    {
+        if (!importer_->canFetchDataType(thisDataType))
+        {
+            continue;
+        }
+
+        std::vector<TimeInterval> missingParts = missingIntervals(
+            getEntry(thisDataType, location), startSecs, endSecs);
+
+        if (missingParts.empty())
+        {
+            // Emit later so that the caller always receives data after
+            // fetchData has returned, just like when fetching
+            QTimer::singleShot(0, this,
+                [this, thisDataType, location, startSecs, endSecs]()
+            {
+                emitCachedData(thisDataType, location, startSecs, endSecs);
+            });
+
+            continue;
+        }
+
+        IntervalSet missingIntervals;
+
+        for (const TimeInterval& missingPart : missingParts)
+        {
+            missingIntervals.add(missingPart.first, missingPart.second);
+        }
+
+        pendingFetches_.push_back({ thisDataType, location,
+                                    startSecs, endSecs, missingIntervals,
+                                    IntervalSet() });
+
+        // Data types missing the same parts can be fetched with the same
+        // calls, also when they were requested by separate calls
+        for (const TimeInterval& missingPart : missingParts)
+        {
+            if (queuedFetches_.empty())
+            {
+                QTimer::singleShot(0, this,
+                                   &CachingDataImporter::fetchQueuedData);
+            }
+
+            auto queuedIt = queuedFetches_.find({ location, missingPart });
+
+            if (queuedIt == queuedFetches_.end())
+            {
+                queuedFetches_.insert({ { location, missingPart },
+                                        thisDataType });
+            }
+            else
+            {
+                queuedIt->second = queuedIt->second | thisDataType;
+            }
+        }
+    }
+}
+
+std::vector<ApiDataType> CachingDataImporter::getAvailableDataTypes()
+{
+    return importer_->getAvailableDataTypes();
+}
+
+std::vector<std::string> CachingDataImporter::getAvailableLocations()
+{
+    return importer_->getAvailableLocations();
+}
+
+bool CachingDataImporter::canFetchDataType(const ApiDataType& dataType)
+{
+    return importer_->canFetchDataType(dataType);
+}
+
+std::string CachingDataImporter::getSourceName()
+{
+    return importer_->getSourceName();
+}
+
+void CachingDataImporter::setVisibleTimeRange(const QDateTime& startTime,
+                                              const QDateTime& endTime)
+{
+    importer_->setVisibleTimeRange(startTime, endTime);
+}
+
+void CachingDataImporter::cancelFetchesOutside(const QDateTime& startTime,
+                                               const QDateTime& endTime)
+{
+    qint64 startSecs = startTime.toSecsSinceEpoch();
+    qint64 endSecs = endTime.toSecsSinceEpoch();
+
+    for (auto it = queuedFetches_.begin(); it != queuedFetches_.end();)
+    {
+        const TimeInterval& part = it->first.second;
+
+        if (part.first < endSecs && part.second > startSecs)
+        {
+            it++;
+            continue;
+        }
+
+        for (ApiDataType thisDataType :
+             DataImporter::separateDataTypes(it->second))
+        {
+            cancelPendingFetches(thisDataType, it->first.first,
+                                 part.first, part.second);
+        }
+
+        it = queuedFetches_.erase(it);
+    }
+
+    importer_->cancelFetchesOutside(startTime, endTime);
+}
+
+void CachingDataImporter::storeFetchedData(DataFetchDetails fetchDetails,
+                                           std::shared_ptr<TimeSeries> data)
+{
+    qint64 startSecs = fetchDetails.startDateTime.toSecsSinceEpoch();
+    qint64 endSecs = fetchDetails.endDateTime.toSecsSinceEpoch();
+
+    SegmentCacheEntry& entry =
+        getEntry(fetchDetails.dataType, fetchDetails.dataLocation);
+
+    // An empty reply might just be a failed fetch, so don't let it replace
+    // cached data or mark its range as covered
+    if (!data->empty())
+    {
+        entry.unitOfMeasurement = fetchDetails.unitOfMeasurement;
+        entry.data.replaceRange(startSecs, endSecs, *data);
+
+        qint64 currentSecs = QDateTime::currentSecsSinceEpoch();
+        qint64 settledUntilSecs = currentSecs - SETTLE_DELAY_SECONDS;
+
+        entry.settledCoverage.add(startSecs,
+                                  std::min(endSecs, settledUntilSecs));
+
+        if (endSecs > settledUntilSecs)
+        {
+            // Throw away expired recent coverage, otherwise keep the time of
+            // its oldest fetch
+            if (currentSecs - entry.recentFetchedAtSecs
+                >= RECENT_DATA_LIFETIME_SECONDS)
+            {
+                entry.recentCoverage.clear();
+                entry.recentFetchedAtSecs = currentSecs;
+            }
+
+            entry.recentCoverage.add(std::max(startSecs, settledUntilSecs),
+                                     endSecs);
+        }
+
+        unwrittenEntries_.insert({ fetchDetails.dataType,
+                                   fetchDetails.dataLocation });
+
+        fetchDetails.importer = this;
+        emit segmentDownloaded(fetchDetails, data);
+    }
+
+    // Update every fetch operation that was waiting for this part, the ones
+    // requesting the same part were merged into one fetch. The part may be
+    // just a segment of what was requested from importer_.
+    std::vector<PendingFetch> completedFetches;
+    bool partStillAwaited = false;
+
+    for (auto it = pendingFetches_.begin(); it != pendingFetches_.end();)
+    {
+        if (it->dataType != fetchDetails.dataType
+            || it->dataLocation != fetchDetails.dataLocation
+            || it->missingIntervals.covered(startSecs, endSecs).empty())
+        {
+            it++;
+            continue;
+        }
+
+        it->missingIntervals.remove(startSecs, endSecs);
+
+        if (it->missingIntervals.empty())
+        {
+            completedFetches.push_back(*it);
+            it = pendingFetches_.erase(it);
+        }
+        else
+        {
+            partStillAwaited = true;
+            it++;
+        }
+    }
+
+    // Show the part right away if some fetch operation is still waiting for
+    // the rest of its data
+    if (partStillAwaited && !data->empty())
+    {
+        emitCachedData(fetchDetails.dataType, fetchDetails.dataLocation,
+                       startSecs, endSecs);
+
+        for (PendingFetch& pendingFetch : pendingFetches_)
+        {
+            if (pendingFetch.dataType == fetchDetails.dataType
+                && pendingFetch.dataLocation == fetchDetails.dataLocation)
+            {
+                pendingFetch.emittedIntervals.add(startSecs, endSecs);
+            }
+        }
+
+        for (PendingFetch& completedFetch : completedFetches)
+        {
+            completedFetch.emittedIntervals.add(startSecs, endSecs);
+        }
+    }
+
+    // Emit only what the receiver hasn't got yet, the rest of a long fetch
+    // would otherwise be sent again
+    for (const PendingFetch& completedFetch : completedFetches)
+    {
+        for (const TimeInterval& part : completedFetch.emittedIntervals.gaps(
+                 completedFetch.startSecs, completedFetch.endSecs))
+        {
+            emitCachedData(completedFetch.dataType,
+                           completedFetch.dataLocation,
+                           part.first, part.second);
+        }
+    }
+
+    writeEntryIfIdle(fetchDetails.dataType, fetchDetails.dataLocation);
+}
+
+void CachingDataImporter::fetchQueuedData()
+{
+    // Fetching may queue more parts, which are fetched on the next turn
+    std::map<std::pair<std::string, TimeInterval>, ApiDataType> queuedFetches;
+    queuedFetches.swap(queuedFetches_);
+
+    for (auto& queuedFetch : queuedFetches)
+    {
+        importer_->fetchData(queuedFetch.second,
+                             QDateTime::fromSecsSinceEpoch(
+                                 queuedFetch.first.second.first),
+                             QDateTime::fromSecsSinceEpoch(
+                                 queuedFetch.first.second.second),
+                             queuedFetch.first.first);
+    }
+}
+
+void CachingDataImporter::cancelFetchedPart(DataFetchDetails fetchDetails)
+{
+    cancelPendingFetches(fetchDetails.dataType, fetchDetails.dataLocation,
+                         fetchDetails.startDateTime.toSecsSinceEpoch(),
+                         fetchDetails.endDateTime.toSecsSinceEpoch());
+}
+
+SegmentCacheEntry& CachingDataImporter::getEntry(
+    ApiDataType dataType, const std::string& dataLocation)
+{
+    auto key = std::make_pair(dataType, dataLocation);
+    auto entryIt = entries_.find(key);
+
+    if (entryIt == entries_.end())
+    {
+        SegmentCacheEntry entry = { "", IntervalSet(), IntervalSet(), 0,
+                                    TimeSeries() };
+
+        if (!cache_.readEntry(importer_->getSourceName(), dataType,
+                              dataLocation, entry))
+        {
+            // Start over if the file was missing or broken
+            entry = { "", IntervalSet(), IntervalSet(), 0, TimeSeries() };
+        }
+
+        entryIt = entries_.insert({ key, entry }).first;
+    }
+
+    return entryIt->second;
+}
+
+std::vector<TimeInterval> CachingDataImporter::missingIntervals(
+    const SegmentCacheEntry& entry, qint64 startSecs, qint64 endSecs) const
+{
+    IntervalSet coverage = entry.settledCoverage;
+    qint64 currentSecs = QDateTime::currentSecsSinceEpoch();
+
+    if (currentSecs - entry.recentFetchedAtSecs < RECENT_DATA_LIFETIME_SECONDS)
+    {
+        for (TimeInterval& interval : entry.recentCoverage.intervals())
+        {
+            // Recent data fetched up to the moment of fetching is treated as
+            // up to date until it expires
+            if (interval.second >= entry.recentFetchedAtSecs)
+            {
+                interval.second = std::max(interval.second, currentSecs);
+            }
+
+            coverage.add(interval.first, interval.second);
+        }
+    }
+
+    std::vector<TimeInterval> missingParts =
+        coverage.gaps(startSecs, endSecs);
+
+    // Leave out tiny parts at the ends of the range
+    missingParts.erase(
+        std::remove_if(missingParts.begin(), missingParts.end(),
+            [startSecs, endSecs](const TimeInterval& part)
+    {
+        return part.second - part.first < MIN_EDGE_GAP_SECONDS
+               && (part.first == startSecs || part.second == endSecs)
+               && !(part.first == startSecs && part.second == endSecs);
+    }), missingParts.end());
+
+    return missingParts;
+}
+
+void CachingDataImporter::cancelPendingFetches(ApiDataType dataType,
+    const std::string& dataLocation, qint64 startSecs, qint64 endSecs)
+{
+    for (auto it = pendingFetches_.begin(); it != pendingFetches_.end();)
+    {
+        if (it->dataType != dataType || it->dataLocation != dataLocation
+            || it->missingIntervals.covered(startSecs, endSecs).empty())
+        {
+            it++;
+            continue;
+        }
+
+        // The rest of the fetch can't complete without the cancelled part
+        emit fetchCancelled({ dataType, dataLocation, "", this,
+                              QDateTime::fromSecsSinceEpoch(it->startSecs),
+                              QDateTime::fromSecsSinceEpoch(it->endSecs),
+                              0, 0 });
+
+        it = pendingFetches_.erase(it);
+    }
+
+    // The parts that did arrive are still worth keeping
+    writeEntryIfIdle(dataType, dataLocation);
+}
+
+void CachingDataImporter::emitCachedData(ApiDataType dataType,
+                                         const std::string& dataLocation,
+                                         qint64 startSecs, qint64 endSecs)
+{
+    SegmentCacheEntry& entry = getEntry(dataType, dataLocation);
+
+    std::shared_ptr<TimeSeries> data = std::make_shared<TimeSeries>(
+        entry.data.slice(startSecs, endSecs));
+
+    std::pair<float, float> minMax = data->minMaxValues();
+
+    emit dataFetched({ dataType, dataLocation, entry.unitOfMeasurement, this,
+                       QDateTime::fromSecsSinceEpoch(startSecs),
+                       QDateTime::fromSecsSinceEpoch(endSecs),
+                       minMax.second, minMax.first }, data);
+}
+
+void CachingDataImporter::writeEntryIfIdle(ApiDataType dataType,
+                                           const std::string& dataLocation)
+{
+    auto key = std::make_pair(dataType, dataLocation);
+
+    if (unwrittenEntries_.find(key) == unwrittenEntries_.end())
+    {
+        return;
+    }
+
+    for (const PendingFetch& pendingFetch : pendingFetches_)
+    {
+        if (pendingFetch.dataType == dataType
+            && pendingFetch.dataLocation == dataLocation)
+        {
+            return;
+        }
+    }
+
+    cache_.writeEntry(importer_->getSourceName(), dataType, dataLocation,
+                      entries_.at(key));
+    unwrittenEntries_.erase(key);
+
+    cache_.evictOldEntries();
+}
+
+}
@@ -0,0 +1,246 @@
+/**
+  * @file cachingdataimporter.hh declares the CachingDataImporter class, which
+  * is used to serve data from a disk cache and fetch only what's missing.
+  * @date 16.10.2026
+  */
+
+#ifndef CACHINGDATAIMPORTER_HH
+#define CACHINGDATAIMPORTER_HH
+
+#include "dataimporter.hh"
+#include "segmentcache.hh"
+
+#include <list>
+#include <map>
+#include <set>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The CachingDataImporter class wraps another DataImporter and keeps
+ * the data it fetches in a SegmentCache. Requested data that is already
+ * cached is served from the cache and only the missing parts of the
+ * requested time range are fetched with the wrapped DataImporter.
+ *
+ * Missing parts are fetched at the end of the event loop turn they were
+ * requested in, so that the data types of every fetchData call made during
+ * the turn that miss the same part are fetched with a single call.
+ */
+class CachingDataImporter : public DataImporter
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief The default constructor.
+     * @param importer: The DataImporter to fetch uncached data with. The new
+     * CachingDataImporter takes ownership of it.
+     * @param parent: The QObject to parent this CachingDataImporter to
+     */
+    explicit CachingDataImporter(DataImporter* importer,
+                                 QObject* parent = nullptr);
+
+    /**
+     * @brief The default destructor.
+     */
+    virtual ~CachingDataImporter();
+
+    /**
+     * @brief fetchData serves the requested data from the cache, fetching
+     * any parts of it that aren't cached first. Fetched parts are emitted
+     * with dataFetched as they arrive, and once all of the data of a data
+     * type is available, the parts of the time period not emitted yet are
+     * emitted.
+     * @param dataType: The type(s) of the data to fetch
+     * @param startTime: The start of the time period to fetch data from
+     * @param endTime: The end of the time period to fetch data from
+     * @param location: The location to fetch data from
+     */
+    void fetchData(const ApiDataType& dataType,
+        const QDateTime& startTime, const QDateTime& endTime,
+        const std::string& location) override;
+
+    /**
+     * @brief getAvailableDataTypes returns all the data types the wrapped
+     * DataImporter is able to fetch.
+     * @return A vector containing an enum for each data type
+     */
+    virtual std::vector<ApiDataType> getAvailableDataTypes() override;
+
+    /**
+     * @brief getAvailableLocations returns all the locations the wrapped
+     * DataImporter is able to fetch data from.
+     * @return A vector containing the name of each location
+     */
+    virtual std::vector<std::string> getAvailableLocations() override;
+
+    /**
+     * @brief canFetchDataType checks whether the wrapped DataImporter can
+     * fetch the given type of data.
+     * @param dataType: The type of data to check for
+     * @return True if this type of data can be fetched, otherwise false
+     */
+    virtual bool canFetchDataType(const ApiDataType& dataType) override;
+
+    /**
+     * @brief getSourceName returns the name of the wrapped DataImporter's
+     * source.
+     * @return The full name of the data source
+     */
+    virtual std::string getSourceName() override;
+
+    /**
+     * @brief setVisibleTimeRange passes the visible time range on to the
+     * wrapped DataImporter.
+     * @param startTime: The start of the visible time range
+     * @param endTime: The end of the visible time range
+     */
+    void setVisibleTimeRange(const QDateTime& startTime,
+                             const QDateTime& endTime) override;
+
+    /**
+     * @brief cancelFetchesOutside drops the queued parts entirely outside the
+     * given time range and cancels the fetches of the wrapped DataImporter
+     * outside it. Every fetch operation missing a cancelled part is
+     * cancelled as a whole, the parts of it that still arrive are only
+     * cached.
+     * @param startTime: The start of the time range still needed
+     * @param endTime: The end of the time range still needed
+     */
+    void cancelFetchesOutside(const QDateTime& startTime,
+                              const QDateTime& endTime) override;
+
+private slots:
+    /**
+     * @brief storeFetchedData stores data fetched by importer_ in the cache
+     * and completes the fetch operations that were waiting for it.
+     * @param fetchDetails: The details of the fetched data
+     * @param data: The fetched data
+     */
+    void storeFetchedData(DataFetchDetails fetchDetails,
+                          std::shared_ptr<TimeSeries> data);
+
+    /**
+     * @brief fetchQueuedData fetches the missing parts queued during this
+     * event loop turn with the wrapped DataImporter.
+     */
+    void fetchQueuedData();
+
+    /**
+     * @brief cancelFetchedPart cancels the fetch operations that were waiting
+     * for a part importer_ cancelled.
+     * @param fetchDetails: The details of the cancelled part
+     */
+    void cancelFetchedPart(DataFetchDetails fetchDetails);
+
+private:
+    /**
+     * @brief The PendingFetch struct stores a fetchData request of a single
+     * data type that is waiting for its missing parts to be fetched.
+     */
+    struct PendingFetch
+    {
+        ApiDataType dataType;
+        std::string dataLocation;
+        qint64 startSecs;
+        qint64 endSecs;
+        IntervalSet missingIntervals;
+
+        // The parts already emitted while the rest was still missing
+        IntervalSet emittedIntervals;
+    };
+
+    // Stores how long data has to be in the past before it's assumed to
+    // never change
+    static const qint64 SETTLE_DELAY_SECONDS = 24 * 60 * 60;
+
+    // Stores how long recent data is served from the cache before it's
+    // fetched again
+    static const qint64 RECENT_DATA_LIFETIME_SECONDS = 60 * 60;
+
+    // Stores how short a missing part at either end of a requested range can
+    // be to be left unfetched. Shorter than the interval between data points
+    // for most data types, so it saves a request for nothing.
+    static const qint64 MIN_EDGE_GAP_SECONDS = 15 * 60;
+
+    // Stores the DataImporter used to fetch uncached data
+    DataImporter* importer_;
+
+    // Stores the cache files on disk
+    SegmentCache cache_;
+
+    // Stores the cache entries read so far per data type and location
+    std::map<std::pair<ApiDataType, std::string>, SegmentCacheEntry>
+        entries_;
+
+    // Stores the entries changed since they were last written to disk
+    std::set<std::pair<ApiDataType, std::string>> unwrittenEntries_;
+
+    // Stores the fetch operations waiting for data from importer_
+    std::list<PendingFetch> pendingFetches_;
+
+    // Stores the missing parts to fetch at the end of this event loop turn
+    // per location, along with the data types to fetch them for
+    std::map<std::pair<std::string, TimeInterval>, ApiDataType> queuedFetches_;
+
+    /**
+     * @brief getEntry returns the cache entry of the given data, reading it
+     * from disk the first time.
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @return The cache entry
+     */
+    SegmentCacheEntry& getEntry(ApiDataType dataType,
+                                const std::string& dataLocation);
+
+    /**
+     * @brief missingIntervals computes the parts of the given time range
+     * that aren't covered by a cache entry.
+     * @param entry: The cache entry
+     * @param startSecs: The start of the time range
+     * @param endSecs: The end of the time range
+     * @return The missing parts in chronological order
+     */
+    std::vector<TimeInterval> missingIntervals(const SegmentCacheEntry& entry,
+                                               qint64 startSecs,
+                                               qint64 endSecs) const;
+
+    /**
+     * @brief cancelPendingFetches cancels every fetch operation of the given
+     * data that is missing a part of the given time range and emits
+     * fetchCancelled for it.
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @param startSecs: The start of the cancelled time range
+     * @param endSecs: The end of the cancelled time range
+     */
+    void cancelPendingFetches(ApiDataType dataType,
+                              const std::string& dataLocation,
+                              qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief emitCachedData emits dataFetched with the cached data of the
+     * given time range.
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @param startSecs: The start of the time range
+     * @param endSecs: The end of the time range
+     */
+    void emitCachedData(ApiDataType dataType, const std::string& dataLocation,
+                        qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief writeEntryIfIdle writes the cache entry of the given data to
+     * disk if it has changed and no fetch operation is waiting for more of
+     * its data, so that a fetch split into many parts is written only once.
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     */
+    void writeEntryIfIdle(ApiDataType dataType,
+                          const std::string& dataLocation);
+};
+
+}
+
+#endif // CACHINGDATAIMPORTER_HH
@@ -139,6 +139,20 @@ DataImporter::DataImporter(QObject* parent) : QObject(parent)
 
 }
 
+void DataImporter::setVisibleTimeRange(const QDateTime& startTime,
+                                       const QDateTime& endTime)
+{
+    Q_UNUSED(startTime);
+    Q_UNUSED(endTime);
+}
+
+void DataImporter::cancelFetchesOutside(const QDateTime& startTime,
+                                        const QDateTime& endTime)
+{
+    Q_UNUSED(startTime);
+    Q_UNUSED(endTime);
+}
+
 std::vector<ApiDataType> DataImporter::separateDataTypes(
     const ApiDataType& dataType)
 {
@@ -9,6 +9,8 @@
 #ifndef DATAIMPORTER_HH
 #define DATAIMPORTER_HH
 
+#include "timeseries.hh"
+
 #include <QDateTime>
 #include <QObject>
 
@@ -74,11 +76,11 @@ ApiDataType getDataTypeFromName(const std::string& dataTypeName);
 
 /**
  * @brief The DataPoint struct represents a data point with a data value and a
- * time and date from when it was taken.
+ * time and date from when it was taken (in seconds since the epoch).
  */
 struct DataPoint
 {
-    QDateTime dateTime;
+    qint64 secsSinceEpoch;
     float value;
 };
 
@@ -153,15 +155,69 @@ public:
      */
     virtual std::string getSourceName() = 0;
 
+    /**
+     * @brief setVisibleTimeRange tells this DataImporter which time range is
+     * currently shown to the user, so that data inside it can be fetched
+     * first. Does nothing by default.
+     * @param startTime: The start of the visible time range
+     * @param endTime: The end of the visible time range
+     */
+    virtual void setVisibleTimeRange(const QDateTime& startTime,
+                                     const QDateTime& endTime);
+
+    /**
+     * @brief cancelFetchesOutside cancels the unfinished fetches of data
+     * entirely outside the given time range, for example when the user has
+     * moved on to another time range. fetchCancelled is emitted for each
+     * cancelled fetch instead of dataFetched. Does nothing by default.
+     * @param startTime: The start of the time range still needed
+     * @param endTime: The end of the time range still needed
+     */
+    virtual void cancelFetchesOutside(const QDateTime& startTime,
+                                      const QDateTime& endTime);
+
 signals:
     /**
      * @brief dataFetched is a signal that is emitted when the DataImporter
-     * has successfully fetched data from a REST API.
+     * has successfully fetched data from a REST API. Long time periods may be
+     * fetched in parts, which are emitted separately as they arrive.
      * @param fetchDetails: Details about the fetched data
-     * @param data: The fetched data in a vector
+     * @param data: The fetched data
      */
     void dataFetched(DataFetchDetails fetchDetails,
-        std::shared_ptr<std::vector<DataPoint>> data) const;
+        std::shared_ptr<TimeSeries> data) const;
+
+    /**
+     * @brief fetchProgressed is a signal that is emitted whenever a segment
+     * of the data requested by a fetchData call has been received.
+     * @param dataType: The type of the data being fetched
+     * @param dataLocation: The location of the data being fetched
+     * @param receivedSegmentCount: How many segments have been received
+     * @param segmentCount: How many segments the data was split into
+     */
+    void fetchProgressed(ApiDataType dataType, std::string dataLocation,
+        int receivedSegmentCount, int segmentCount) const;
+
+    /**
+     * @brief fetchCancelled is a signal that is emitted when (a part of) a
+     * fetch was cancelled or failed before its data arrived. The data of the
+     * cancelled time period won't be emitted with dataFetched, so the time
+     * period is still unfetched.
+     * @param fetchDetails: Details about the cancelled data, without a unit
+     * or values
+     */
+    void fetchCancelled(DataFetchDetails fetchDetails) const;
+
+    /**
+     * @brief segmentDownloaded is a signal that is emitted when a segment of
+     * data has been downloaded from a REST API, unlike dataFetched, which is
+     * also emitted for data read from elsewhere. Empty segments aren't
+     * emitted.
+     * @param fetchDetails: Details about the downloaded segment
+     * @param data: The data of the segment
+     */
+    void segmentDownloaded(DataFetchDetails fetchDetails,
+        std::shared_ptr<TimeSeries> data) const;
 
 protected:
     // Stores how many ApiDataTypes are defined (remember to update this if
@@ -0,0 +1,387 @@
+/**
+  * @file datajournal.cpp implements the DataJournal class.
+  * @date 16.10.2026
+  */
+
+#include "datajournal.hh"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+#include <limits>
+
+namespace DataImporting
+{
+
+/**
+ * @brief encodeHeader creates the header that starts a journal file.
+ * @param magic: The value identifying journal files
+ * @param version: The version of the journal file format
+ * @param entry: The entry whose source, data type, location and unit to use
+ * @return The encoded header
+ */
+static QByteArray encodeHeader(quint32 magic, quint16 version,
+                               const JournalEntry& entry)
+{
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+
+    stream << magic << version << QString::fromStdString(entry.sourceName)
+           << (qint32)entry.dataType
+           << QString::fromStdString(entry.dataLocation)
+           << QString::fromStdString(entry.unitOfMeasurement);
+
+    return header;
+}
+
+/**
+ * @brief encodeRecord creates a journal record, prefixed by the size and
+ * checksum of its payload so that torn records can be detected.
+ * @param record: The record to encode
+ * @return The encoded record
+ */
+static QByteArray encodeRecord(const JournalRecord& record)
+{
+    QByteArray payload;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+    payloadStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    payloadStream << record.settledUntilSecs << record.startSecs
+                  << record.endSecs << record.maxValue << record.minValue
+                  << (quint32)record.data.size();
+
+    record.data.forEachPoint(0, record.data.size(),
+        [&payloadStream](qint64 secsSinceEpoch, float value)
+    {
+        payloadStream << secsSinceEpoch << value;
+    });
+
+    QByteArray encoded;
+    QDataStream stream(&encoded, QIODevice::WriteOnly);
+
+    stream << (quint32)payload.size()
+           << qChecksum(payload.constData(), payload.size());
+    encoded.append(payload);
+
+    return encoded;
+}
+
+/**
+ * @brief decodeRecord reads the payload of a journal record.
+ * @param payload: The payload, without its size and checksum
+ * @param record: The record to read the payload into
+ * @return True if the payload was valid, otherwise false
+ */
+static bool decodeRecord(const QByteArray& payload, JournalRecord& record)
+{
+    QDataStream stream(payload);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 dataPointCount = 0;
+    stream >> record.settledUntilSecs >> record.startSecs >> record.endSecs
+           >> record.maxValue >> record.minValue >> dataPointCount;
+
+    // Don't trust the count of a damaged payload
+    if (stream.status() != QDataStream::Ok
+        || dataPointCount > payload.size() / (sizeof(qint64) + sizeof(float)))
+    {
+        return false;
+    }
+
+    for (quint32 i = 0; i < dataPointCount; i++)
+    {
+        qint64 secsSinceEpoch = 0;
+        float value = 0;
+        stream >> secsSinceEpoch >> value;
+
+        // The series must stay in chronological order
+        if (!record.data.empty()
+            && secsSinceEpoch < record.data.timeAt(record.data.size() - 1))
+        {
+            return false;
+        }
+
+        record.data.append(secsSinceEpoch, value);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+DataJournal::DataJournal() : DataJournal(
+    QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+    + "/journal")
+{
+
+}
+
+DataJournal::DataJournal(const QString& directory) :
+    journalDirectory_(directory), recordCounts_()
+{
+    QDir().mkpath(journalDirectory_);
+}
+
+void DataJournal::append(const std::string& sourceName, ApiDataType dataType,
+                         const std::string& dataLocation,
+                         const std::string& unitOfMeasurement,
+                         qint64 startSecs, qint64 endSecs,
+                         const TimeSeries& data)
+{
+    // An empty segment may be a failed fetch, journaling it would make its
+    // time range look fetched after a restart
+    if (data.empty())
+    {
+        return;
+    }
+
+    QString filePath = journalFilePath(sourceName, dataType, dataLocation);
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::Append))
+    {
+        return;
+    }
+
+    // Each record is written at once so that a crash can only tear the last
+    // one
+    QByteArray encoded;
+
+    if (file.size() == 0)
+    {
+        JournalEntry entry = JournalEntry();
+        entry.sourceName = sourceName;
+        entry.dataType = dataType;
+        entry.dataLocation = dataLocation;
+        entry.unitOfMeasurement = unitOfMeasurement;
+
+        encoded = encodeHeader(FILE_MAGIC, FILE_VERSION, entry);
+    }
+
+    std::pair<float, float> minMax = data.minMaxValues();
+    JournalRecord record = { QDateTime::currentSecsSinceEpoch()
+                             - SETTLE_DELAY_SECONDS,
+                             startSecs, endSecs, minMax.second, minMax.first,
+                             data };
+
+    encoded.append(encodeRecord(record));
+
+    bool written = file.write(encoded) == encoded.size();
+    file.close();
+
+    if (!written)
+    {
+        return;
+    }
+
+    int& recordCount = recordCounts_[filePath];
+    recordCount++;
+
+    if (recordCount >= COMPACTION_RECORD_COUNT)
+    {
+        compact(filePath);
+    }
+}
+
+std::vector<JournalEntry> DataJournal::replay(qint64 startSecs,
+                                              qint64 endSecs)
+{
+    std::vector<JournalEntry> entries;
+
+    QStringList filePaths;
+    for (const QFileInfo& fileInfo : QDir(journalDirectory_).entryInfoList(
+             { "*.journal" }, QDir::Files))
+    {
+        filePaths.append(fileInfo.absoluteFilePath());
+    }
+
+    for (const QString& filePath : filePaths)
+    {
+        JournalEntry entry = JournalEntry();
+        int recordCount = 0;
+
+        if (!replayFile(filePath, startSecs, endSecs, entry, recordCount))
+        {
+            QFile::remove(filePath);
+            continue;
+        }
+
+        recordCounts_[filePath] = recordCount;
+
+        if (recordCount >= COMPACTION_RECORD_COUNT)
+        {
+            compact(filePath);
+        }
+
+        if (!entry.data.empty())
+        {
+            entries.push_back(entry);
+        }
+    }
+
+    return entries;
+}
+
+QString DataJournal::journalFilePath(const std::string& sourceName,
+                                     ApiDataType dataType,
+                                     const std::string& dataLocation) const
+{
+    // Percent-encode names so they can't contain path separators
+    QString fileName = QString::fromUtf8(
+        QUrl::toPercentEncoding(QString::fromStdString(sourceName + "_"
+            + getDataTypeName(dataType) + "_" + dataLocation)));
+
+    return journalDirectory_ + "/" + fileName + ".journal";
+}
+
+void DataJournal::compact(const QString& filePath)
+{
+    JournalEntry entry = JournalEntry();
+    int recordCount = 0;
+
+    if (!replayFile(filePath, std::numeric_limits<qint64>::min(),
+                    std::numeric_limits<qint64>::max(), entry, recordCount))
+    {
+        return;
+    }
+
+    // Write to a temporary file first so a crash can't lose the old journal
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+
+    file.write(encodeHeader(FILE_MAGIC, FILE_VERSION, entry));
+
+    int compactedCount = 0;
+
+    for (const TimeInterval& interval : entry.coverage.intervals())
+    {
+        TimeSeries data = entry.data.slice(interval.first, interval.second);
+
+        if (data.empty())
+        {
+            continue;
+        }
+
+        // Each range settled by the end of it at the latest, so it stays
+        // settled after compacting without pretending to be fetched now
+        std::pair<float, float> minMax = data.minMaxValues();
+        JournalRecord record = { interval.second, interval.first,
+                                 interval.second, minMax.second,
+                                 minMax.first, data };
+
+        file.write(encodeRecord(record));
+        compactedCount++;
+    }
+
+    if (file.commit())
+    {
+        recordCounts_[filePath] = compactedCount;
+    }
+}
+
+bool DataJournal::replayFile(const QString& filePath, qint64 startSecs,
+                             qint64 endSecs, JournalEntry& entry,
+                             int& recordCount) const
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString sourceName;
+    qint32 dataType = 0;
+    QString dataLocation;
+    QString unitOfMeasurement;
+    stream >> magic >> version >> sourceName >> dataType >> dataLocation
+           >> unitOfMeasurement;
+
+    if (stream.status() != QDataStream::Ok || magic != FILE_MAGIC
+        || version != FILE_VERSION)
+    {
+        return false;
+    }
+
+    entry.sourceName = sourceName.toStdString();
+    entry.dataType = static_cast<ApiDataType>(dataType);
+    entry.dataLocation = dataLocation.toStdString();
+    entry.unitOfMeasurement = unitOfMeasurement.toStdString();
+
+    recordCount = 0;
+    qint64 validSize = file.pos();
+
+    while (!stream.atEnd())
+    {
+        quint32 payloadSize = 0;
+        quint16 checksum = 0;
+        stream >> payloadSize >> checksum;
+
+        if (stream.status() != QDataStream::Ok
+            || payloadSize > file.size() - file.pos())
+        {
+            break;
+        }
+
+        QByteArray payload = file.read(payloadSize);
+        JournalRecord record = JournalRecord();
+
+        if (payload.size() != (int)payloadSize
+            || qChecksum(payload.constData(), payload.size()) != checksum
+            || !decodeRecord(payload, record))
+        {
+            break;
+        }
+
+        recordCount++;
+        validSize = file.pos();
+
+        // Only the part inside the time range is kept, and records without
+        // data don't cover anything
+        qint64 keptStartSecs = std::max(record.startSecs, startSecs);
+        qint64 keptEndSecs = std::min(record.endSecs, endSecs);
+
+        if (record.data.empty() || keptStartSecs > keptEndSecs)
+        {
+            continue;
+        }
+
+        // Later records replace the data points of earlier ones
+        bool hadData = !entry.data.empty();
+        entry.data.replaceRange(keptStartSecs, keptEndSecs, record.data);
+
+        // Recently fetched data may still change, so it's fetched again
+        if (keptStartSecs <= record.settledUntilSecs)
+        {
+            entry.coverage.add(keptStartSecs,
+                               std::min(keptEndSecs, record.settledUntilSecs));
+        }
+
+        entry.maxValue = hadData ? std::max(entry.maxValue, record.maxValue)
+                                 : record.maxValue;
+        entry.minValue = hadData ? std::min(entry.minValue, record.minValue)
+                                 : record.minValue;
+    }
+
+    // Remove a record torn by a crash so that new records can follow the
+    // valid ones
+    if (validSize < file.size())
+    {
+        file.resize(validSize);
+    }
+
+    return true;
+}
+
+}
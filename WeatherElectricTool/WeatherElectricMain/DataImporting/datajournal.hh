@@ -0,0 +1,167 @@
+/**
+  * @file datajournal.hh declares the DataJournal class, which is used to keep
+  * fetched data over restarts without rewriting everything on each fetch.
+  * @date 16.10.2026
+  */
+
+#ifndef DATAJOURNAL_HH
+#define DATAJOURNAL_HH
+
+#include "dataimporter.hh"
+#include "intervalset.hh"
+
+#include <QString>
+
+#include <map>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The JournalRecord struct stores a single fetched segment of data.
+ */
+struct JournalRecord
+{
+    // The time until which the segment's data won't change anymore, in
+    // seconds since the epoch. Data fetched recently may still be corrected
+    // by the source, so this lags behind the time of fetching.
+    qint64 settledUntilSecs;
+
+    // The time range the segment was fetched for, inclusive
+    qint64 startSecs;
+    qint64 endSecs;
+
+    float maxValue;
+    float minValue;
+    TimeSeries data;
+};
+
+/**
+ * @brief The JournalEntry struct stores everything journaled of a single
+ * source, data type and location, merged in the order it was fetched.
+ */
+struct JournalEntry
+{
+    std::string sourceName;
+    ApiDataType dataType;
+    std::string dataLocation;
+    std::string unitOfMeasurement;
+
+    // The time ranges the data can be trusted to be complete and settled in
+    IntervalSet coverage;
+
+    float maxValue;
+    float minValue;
+    TimeSeries data;
+};
+
+/**
+ * @brief The DataJournal class appends every downloaded segment of data to
+ * an append-only journal file, one file per source, data type and location.
+ * Each record has a checksum, so a record torn by a crash is detected and
+ * dropped when the journals are replayed. Journals are compacted into one
+ * record per settled time range once they have many records, keeping the
+ * time each range settled at so that recent data is still fetched again.
+ */
+class DataJournal
+{
+public:
+    /**
+     * @brief The default constructor. Uses the application's data directory.
+     */
+    DataJournal();
+
+    /**
+     * @brief A constructor that keeps the journals in the given directory.
+     * @param directory: The directory to keep the journal files in
+     */
+    explicit DataJournal(const QString& directory);
+
+    /**
+     * @brief append adds a segment fetched just now to the end of the journal
+     * of the given data, and compacts the journal if it has many records.
+     * Empty segments aren't added, since they may be failed fetches.
+     * @param sourceName: The name of the source the data is from
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @param unitOfMeasurement: The unit of the data
+     * @param startSecs: The start of the time range the segment was fetched
+     * for, inclusive
+     * @param endSecs: The end of the time range the segment was fetched for,
+     * inclusive
+     * @param data: The data of the segment
+     */
+    void append(const std::string& sourceName, ApiDataType dataType,
+                const std::string& dataLocation,
+                const std::string& unitOfMeasurement, qint64 startSecs,
+                qint64 endSecs, const TimeSeries& data);
+
+    /**
+     * @brief replay reads the part of every journal inside the given time
+     * range, so that only data close to what's shown is kept in memory. Data
+     * fetched so recently that it may still change isn't counted as covered.
+     * Torn records at the ends of the journals are removed and long journals
+     * are compacted.
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @return The merged data of each journal inside the time range
+     */
+    std::vector<JournalEntry> replay(qint64 startSecs, qint64 endSecs);
+
+private:
+    // Identifies journal files, "WEJL" in ASCII
+    static const quint32 FILE_MAGIC = 0x57454A4C;
+
+    // Stores the version of the journal file format
+    static const quint16 FILE_VERSION = 2;
+
+    // Stores how many records a journal can have before it's compacted
+    static const int COMPACTION_RECORD_COUNT = 256;
+
+    // Stores how long after fetching data it may still change
+    static const qint64 SETTLE_DELAY_SECONDS = 24 * 60 * 60;
+
+    // Stores the directory the journal files are kept in
+    QString journalDirectory_;
+
+    // Stores the number of records in each journal file that has been
+    // replayed or appended to
+    std::map<QString, int> recordCounts_;
+
+    /**
+     * @brief journalFilePath creates the path of the journal file of the
+     * given data.
+     * @param sourceName: The name of the source the data is from
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @return The path of the journal file
+     */
+    QString journalFilePath(const std::string& sourceName,
+                            ApiDataType dataType,
+                            const std::string& dataLocation) const;
+
+    /**
+     * @brief compact replaces a journal file with one record for each of its
+     * settled time ranges. Data that hasn't settled yet is left out, since it
+     * would be fetched again after a restart anyway.
+     * @param filePath: The path of the journal file
+     */
+    void compact(const QString& filePath);
+
+    /**
+     * @brief replayFile reads the records of a journal file and merges the
+     * parts of them inside the given time range.
+     * @param filePath: The path of the journal file
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @param entry: The entry to merge the records into
+     * @param recordCount: Set to the number of valid records
+     * @return True if the file is a valid journal, otherwise false
+     */
+    bool replayFile(const QString& filePath, qint64 startSecs, qint64 endSecs,
+                    JournalEntry& entry, int& recordCount) const;
+};
+
+}
+
+#endif // DATAJOURNAL_HH
@@ -1,26 +1,31 @@
 #include "datasegmenter.hh"
 
+#include <algorithm>
+
 namespace DataImporting
 {
 
-DataSegmenter::DataSegmenter()
+DataSegmenter::DataSegmenter() : receptables_(), dataSegmentReceptablesPerUrl_()
 {
 
 }
 
 void DataSegmenter::openNewReceptable(const ApiDataType& dataType,
                                       const std::string& dataLocation,
-                                      const QDateTime& startDateTime,
-                                      const QDateTime& endDateTime,
-                                      const std::vector<std::string>& segmentUrls)
+                                      const std::vector<std::string>& segmentUrls,
+                                      const std::vector<std::pair<QDateTime, QDateTime>>&
+                                          segmentTimeFrames)
 {
-    DataSegmentReceptable* thisReceptable = new DataSegmentReceptable();
-
-    thisReceptable->dataDetails = { nullptr, dataType, dataLocation,
-                                    startDateTime, endDateTime, 0, 0 };
+    ReceptableIterator thisReceptable =
+        receptables_.insert(receptables_.end(), DataSegmentReceptable());
 
+    thisReceptable->dataType = dataType;
+    thisReceptable->dataLocation = dataLocation;
     thisReceptable->dataSegments =
-        std::vector<std::vector<DataPoint>*>(segmentUrls.size(), nullptr);
+        std::vector<TimeSeries>(segmentUrls.size());
+    thisReceptable->segmentTimeFrames = segmentTimeFrames;
+    thisReceptable->segmentsReceived =
+        std::vector<bool>(segmentUrls.size(), false);
 
     int segmentIndex = 0;
 
@@ -37,6 +42,20 @@ void DataSegmenter::openNewReceptable(const ApiDataType& dataType,
                 dataSegmentReceptablesPerUrl_.insert({ thisUrl, {} }).first;
         }
 
+        // Another receptable may already be receiving this URL's data, the
+        // request isn't sent again so start from what it has received.
+        // Copying a segment shares its chunks.
+        auto sameTypeIt = urlReceptables->second.find(dataType);
+
+        if (sameTypeIt != urlReceptables->second.end())
+        {
+            DataSegmentReceptable& otherReceptable = *sameTypeIt->second;
+
+            thisReceptable->dataSegments.at(segmentIndex) =
+                otherReceptable.dataSegments.at(
+                    otherReceptable.segmentIndicesPerUrl.at(thisUrl));
+        }
+
         urlReceptables->second.insert({ dataType, thisReceptable });
         thisReceptable->segmentIndicesPerUrl.insert({ thisUrl, segmentIndex });
 
@@ -44,128 +63,161 @@ void DataSegmenter::openNewReceptable(const ApiDataType& dataType,
     }
 }
 
-std::vector<SegmentedDataDetails> DataSegmenter::getFilledReceptables(
+std::vector<SegmentedDataDetails> DataSegmenter::getReceivedSegments(
     const std::string& url)
 {
-    std::vector<SegmentedDataDetails> filledReceptables;
+    return closeSegment(url, true);
+}
+
+std::vector<SegmentedDataDetails> DataSegmenter::cancelSegment(
+    const std::string& url)
+{
+    return closeSegment(url, false);
+}
+
+std::vector<SegmentedDataDetails> DataSegmenter::closeSegment(
+    const std::string& url, bool passData)
+{
+    std::vector<SegmentedDataDetails> receivedSegments;
 
     auto thisUrlReceptablesIt = dataSegmentReceptablesPerUrl_.find(url);
 
-    std::map<ApiDataType, DataSegmentReceptable*>& thisUrlReceptables =
-        thisUrlReceptablesIt->second;
+    if (thisUrlReceptablesIt == dataSegmentReceptablesPerUrl_.end())
+    {
+        return receivedSegments;
+    }
 
-    // Check for filled receptables
-    for (auto it = thisUrlReceptables.begin();
-         it != thisUrlReceptables.end();)
+    for (auto& receptablePair : thisUrlReceptablesIt->second)
     {
-        DataSegmentReceptable& receptable = *it->second;
+        DataSegmentReceptable& receptable = *receptablePair.second;
 
+        // The segment of this URL has been received, even if nothing in it
+        // could be parsed or its request was cancelled
         int segmentIndex = receptable.segmentIndicesPerUrl.at(url);
-        std::vector<DataPoint>*& dataVector =
-            receptable.dataSegments.at(segmentIndex);
+        receptable.segmentsReceived.at(segmentIndex) = true;
+
+        TimeSeries& segment = receptable.dataSegments.at(segmentIndex);
+        const std::pair<QDateTime, QDateTime>& timeFrame =
+            receptable.segmentTimeFrames.at(segmentIndex);
 
-        // If a segment that was meant to be in this request URL could not be
-        // parsed
-        if (dataVector == nullptr)
+        if (passData)
         {
-            // Return empty segment
-            dataVector = new std::vector<DataPoint>();
+            // Pass the segment on right away instead of waiting for the rest.
+            // The segment's chunks are shared, not copied.
+            std::pair<float, float> minMax = segment.minMaxValues();
+
+            receivedSegments.push_back({ std::make_shared<TimeSeries>(segment),
+                                         receptable.dataType,
+                                         receptable.dataLocation,
+                                         timeFrame.first, timeFrame.second,
+                                         minMax.second, minMax.first });
         }
+        else
+        {
+            // Whatever arrived before cancelling is incomplete
+            segment.clear();
 
-        // Count how many segments are still null (haven't been received yet)
-        int nullSegmentCount =
-            std::count(receptable.dataSegments.begin(),
-                       receptable.dataSegments.end(), nullptr);
+            receivedSegments.push_back({ nullptr, receptable.dataType,
+                                         receptable.dataLocation,
+                                         timeFrame.first, timeFrame.second,
+                                         0, 0 });
+        }
 
-        // If all segments have been received
-        if (nullSegmentCount == 0)
+        // Delete the receptable once all of its segments have been received,
+        // every other URL it was waiting for has been closed already
+        if (std::find(receptable.segmentsReceived.begin(),
+                      receptable.segmentsReceived.end(), false)
+            == receptable.segmentsReceived.end())
         {
-            // Calculate total data point count
-            unsigned int totalDataLength = 0;
+            receptables_.erase(receptablePair.second);
+        }
+    }
 
-            for (auto it2 = receptable.dataSegments.begin();
-                 it2 != receptable.dataSegments.end(); it2++)
-            {
-                totalDataLength += (*it2)->size();
-            }
+    dataSegmentReceptablesPerUrl_.erase(thisUrlReceptablesIt);
 
-            // Create vector to store all the data from this receptable in
-            receptable.dataDetails.data =
-                std::make_shared<std::vector<DataPoint>>();
+    return receivedSegments;
+}
 
-            std::shared_ptr<std::vector<DataPoint>>& allData =
-                receptable.dataDetails.data;
+std::vector<ReceptableProgress> DataSegmenter::getReceptableProgress(
+    const std::string& url) const
+{
+    std::vector<ReceptableProgress> progress;
 
-            allData->reserve(totalDataLength);
+    auto thisUrlReceptablesIt = dataSegmentReceptablesPerUrl_.find(url);
 
-            unsigned int addedDataLength = 0;
+    if (thisUrlReceptablesIt == dataSegmentReceptablesPerUrl_.end())
+    {
+        return progress;
+    }
 
-            // Combine segment data into one vector
-            for (std::vector<DataPoint>*& segment : receptable.dataSegments)
-            {
-                allData->insert(allData->begin() + addedDataLength,
-                                segment->begin(), segment->end());
+    for (auto& receptablePair : thisUrlReceptablesIt->second)
+    {
+        const DataSegmentReceptable& receptable = *receptablePair.second;
 
-                addedDataLength += segment->size();
-            }
+        int segmentIndex = receptable.segmentIndicesPerUrl.at(url);
 
-            // Add the filled receptable to total filled receptables
-            filledReceptables.push_back(receptable.dataDetails);
+        // Count received segments, this URL's segment included
+        int receivedSegmentCount = 0;
 
-            // Delete filled receptable as it's served its purpose
-            delete it->second;
-            it = thisUrlReceptables.erase(it);
-        }
-        else
+        for (unsigned int i = 0; i < receptable.segmentsReceived.size(); i++)
         {
-            it++;
+            if (receptable.segmentsReceived[i] || (int)i == segmentIndex)
+            {
+                receivedSegmentCount++;
+            }
         }
+
+        progress.push_back({ receptable.dataType,
+                             receptable.dataLocation,
+                             receivedSegmentCount,
+                             (int)receptable.dataSegments.size() });
     }
 
-    dataSegmentReceptablesPerUrl_.erase(thisUrlReceptablesIt);
+    return progress;
+}
 
-    return filledReceptables;
+void DataSegmenter::discardSegment(const std::string& url)
+{
+    auto thisUrlReceptablesIt = dataSegmentReceptablesPerUrl_.find(url);
+
+    if (thisUrlReceptablesIt == dataSegmentReceptablesPerUrl_.end())
+    {
+        return;
+    }
+
+    for (auto& receptablePair : thisUrlReceptablesIt->second)
+    {
+        DataSegmentReceptable& receptable = *receptablePair.second;
+
+        int segmentIndex = receptable.segmentIndicesPerUrl.at(url);
+        receptable.dataSegments.at(segmentIndex).clear();
+    }
 }
 
 void DataSegmenter::pushParsedDataPoint(const DataPoint& dataPoint,
                                         const std::string& url,
                                         const ApiDataType& dataType)
 {
-    // Get receptable for this data type and URL
-    DataSegmentReceptable& dataReceptable =
-        *dataSegmentReceptablesPerUrl_.at(url).find(dataType)->second;
+    auto thisUrlReceptablesIt = dataSegmentReceptablesPerUrl_.find(url);
 
-    int segmentIndex = dataReceptable.segmentIndicesPerUrl.at(url);
+    if (thisUrlReceptablesIt == dataSegmentReceptablesPerUrl_.end())
+    {
+        return;
+    }
 
-    std::vector<DataPoint>*& dataVector =
-        dataReceptable.dataSegments.at(segmentIndex);
+    // Get every receptable for this data type and URL
+    auto receptables = thisUrlReceptablesIt->second.equal_range(dataType);
 
-    if (dataVector == nullptr)
+    for (auto it = receptables.first; it != receptables.second; it++)
     {
-        // Haven't parsed data of this type yet, create new vector for it
-        dataVector = new std::vector<DataPoint>();
+        DataSegmentReceptable& dataReceptable = *it->second;
 
-        // If this is the first data point received by this receptable, set
-        // max and min value to the data value to make sure they're correct
-        if (!dataReceptable.hasReceivedSegments)
-        {
-            dataReceptable.dataDetails.minValue = dataPoint.value;
-            dataReceptable.dataDetails.maxValue = dataPoint.value;
+        int segmentIndex = dataReceptable.segmentIndicesPerUrl.at(url);
 
-            dataReceptable.hasReceivedSegments = true;
-        }
+        // Add data point to total parsed data
+        dataReceptable.dataSegments.at(segmentIndex).append(
+            dataPoint.secsSinceEpoch, dataPoint.value);
     }
-    else
-    {
-        // Update min/max values
-        dataReceptable.dataDetails.minValue =
-            std::min(dataReceptable.dataDetails.minValue, dataPoint.value);
-        dataReceptable.dataDetails.maxValue =
-            std::max(dataReceptable.dataDetails.maxValue, dataPoint.value);
-    }
-
-    // Add data point to total parsed data
-    dataVector->push_back(dataPoint);
 }
 
 }
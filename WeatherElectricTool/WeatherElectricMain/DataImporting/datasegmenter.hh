@@ -10,6 +10,8 @@
 
 #include "dataimporter.hh"
 
+#include <list>
+
 namespace DataImporting
 {
 
@@ -19,7 +21,7 @@ namespace DataImporting
  */
 struct SegmentedDataDetails
 {
-    std::shared_ptr<std::vector<DataPoint>> data;
+    std::shared_ptr<TimeSeries> data;
     ApiDataType dataType;
     std::string dataLocation;
     QDateTime startDateTime;
@@ -28,10 +30,29 @@ struct SegmentedDataDetails
     float minValue;
 };
 
+/**
+ * @brief The ReceptableProgress struct is used to report how many of the data
+ * segments of a receptable have been received.
+ */
+struct ReceptableProgress
+{
+    ApiDataType dataType;
+    std::string dataLocation;
+    int receivedSegmentCount;
+    int segmentCount;
+};
+
 /**
  * @brief The DataSegmenter class handles segmented data using data receptables
- * that receive the data segments and combine them into a single data
- * structure.
+ * that receive the data segments of a single fetch operation. Each segment is
+ * passed on as soon as it has been received, in whatever order the segments
+ * arrive, so that long time periods can be shown before all of their data has
+ * arrived. Several receptables of the same data type can wait for the data of
+ * the same request URL, each of them receives all of it.
+ *
+ * The DataSegmenter owns its receptables and their segments. A receptable is
+ * released with all of its segments as soon as its last segment has been
+ * returned by getReceivedSegments or cancelled with cancelSegment.
  */
 class DataSegmenter
 {
@@ -44,36 +65,63 @@ public:
     /**
      * @brief openNewReceptable opens a new receptable for segmented data in
      * this DataSegmenter. The receptable can then be filled with
-     * pushParsedDataPoint and its contents retrieved with
-     * getFilledReceptables.
+     * pushParsedDataPoint and its segments retrieved with
+     * getReceivedSegments.
      * @param dataType: The type of data to store in this receptable
      * @param dataLocation: The location from which the data in this receptable
      * will be from
-     * @param startDateTime: The start of the time period from which this
-     * receptable is going to receive data from
-     * @param endDateTime: The end of the time period from which this
-     * receptable is going to receive data from
      * @param segmentUrls: The API request URLs of the data segments that this
-     * receptable is expected to receive, in chronological order
+     * receptable is expected to receive, in chronological order. Data already
+     * received from a URL by another receptable is copied to this one.
+     * @param segmentTimeFrames: The time period of each segment, in the same
+     * order as segmentUrls
      */
     void openNewReceptable(const ApiDataType& dataType,
                            const std::string& dataLocation,
-                           const QDateTime& startDateTime,
-                           const QDateTime& endDateTime,
-                           const std::vector<std::string>& segmentUrls);
+                           const std::vector<std::string>& segmentUrls,
+                           const std::vector<std::pair<QDateTime, QDateTime>>&
+                               segmentTimeFrames);
 
     /**
-     * @brief getFilledReceptables checks for filled data receptables with the
-     * given request URL and returns their contents if found.
-     * @param url: One of the URLs the receptable was expected to receive data
-     * from
-     * @return The data collected by each filled receptable
+     * @brief getReceivedSegments marks the segment of the given request URL
+     * as received in every receptable waiting for it and returns the
+     * segments. Closes the URL.
+     * @param url: The URL whose data has been received
+     * @return The data and time period of the segment of each receptable
      */
-    std::vector<SegmentedDataDetails> getFilledReceptables(
+    std::vector<SegmentedDataDetails> getReceivedSegments(
         const std::string& url);
 
     /**
-     * @brief pushParsedDataPoint pushes a new data point to the receptable
+     * @brief getReceptableProgress counts the received segments of every
+     * receptable expecting data from the given request URL. The segment of
+     * the given URL is counted as received. Should be called before
+     * getReceivedSegments, which closes the URL.
+     * @param url: One of the URLs the receptables are expecting data from
+     * @return The progress of each receptable expecting data from the URL
+     */
+    std::vector<ReceptableProgress> getReceptableProgress(
+        const std::string& url) const;
+
+    /**
+     * @brief discardSegment throws away every data point pushed under the
+     * given request URL so that the segment can be received again.
+     * @param url: The request URL whose data points to throw away
+     */
+    void discardSegment(const std::string& url);
+
+    /**
+     * @brief cancelSegment closes the segment of the given request URL in
+     * every receptable waiting for it without passing on its data, which
+     * won't be received anymore. Closes the URL.
+     * @param url: The URL whose request was cancelled
+     * @return The time period of the segment of each receptable, without
+     * data
+     */
+    std::vector<SegmentedDataDetails> cancelSegment(const std::string& url);
+
+    /**
+     * @brief pushParsedDataPoint pushes a new data point to every receptable
      * corresponding to the given request URL and data type.
      * @param dataPoint: The data point to push
      * @param url: The request URL to label this data point under
@@ -91,16 +139,40 @@ protected:
      */
     struct DataSegmentReceptable
     {
-        SegmentedDataDetails dataDetails;
-        std::vector<std::vector<DataPoint>*> dataSegments;
+        ApiDataType dataType;
+        std::string dataLocation;
+        std::vector<TimeSeries> dataSegments;
+        std::vector<std::pair<QDateTime, QDateTime>> segmentTimeFrames;
+        std::vector<bool> segmentsReceived;
         std::map<std::string, int> segmentIndicesPerUrl;
-        bool hasReceivedSegments;
     };
 
+    /**
+     * @brief The ReceptableIterator type points to a receptable in
+     * receptables_.
+     */
+    typedef std::list<DataSegmentReceptable>::iterator ReceptableIterator;
+
+    /**
+     * @brief closeSegment marks the segment of the given request URL as
+     * received in every receptable waiting for it, releases the receptables
+     * that have received all of their segments and closes the URL.
+     * @param url: The URL whose segment to close
+     * @param passData: Whether to return the data of the segments
+     * @return The time period, and data if requested, of the segment of each
+     * receptable
+     */
+    std::vector<SegmentedDataDetails> closeSegment(const std::string& url,
+                                                   bool passData);
+
+    // Stores every open receptable. Receptables are kept in a list so that
+    // they stay in place while others are opened and released.
+    std::list<DataSegmentReceptable> receptables_;
+
     // Maps API request URLs to the data segment receptables that the data
     // returned by the requests should be placed in
     std::map<std::string,
-             std::map<ApiDataType, DataSegmentReceptable*>>
+             std::multimap<ApiDataType, ReceptableIterator>>
         dataSegmentReceptablesPerUrl_;
 };
 
@@ -7,6 +7,7 @@
 #include "fingriddataimporter.hh"
 #include "datasegmenter.hh"
 
+#include <cmath>
 #include <fstream>
 #include <iostream>
 
@@ -55,6 +56,7 @@ void FingridDataImporter::fetchData(const ApiDataType& dataType,
         + (remainingTimeFrameLength % MAX_REQUEST_LENGTH_SECONDS != 0);
 
     std::vector<std::string> timeFrameStrings;
+    std::vector<std::pair<QDateTime, QDateTime>> timeFrames;
 
     // The Fingrid API can only return data from a limited time frame in one
     // request, so we have to send multiple requests like this
@@ -69,6 +71,7 @@ void FingridDataImporter::fetchData(const ApiDataType& dataType,
         timeFrameStrings.push_back("start_time="
             + dateTimeToApiString(remainingTimeFrameStart)
             + "&end_time=" + dateTimeToApiString(thisRequestEndTime));
+        timeFrames.push_back({ remainingTimeFrameStart, thisRequestEndTime });
 
         remainingTimeFrameStart = thisRequestEndTime;
         remainingTimeFrameLength -= thisRequestLength;
@@ -90,10 +93,9 @@ void FingridDataImporter::fetchData(const ApiDataType& dataType,
 
         std::vector<std::string> thisDataTypeRequestUrls;
 
-        for (auto it2 = timeFrameStrings.begin();
-             it2 != timeFrameStrings.end(); it2++)
+        for (unsigned int i = 0; i < timeFrameStrings.size(); i++)
         {
-            std::string& timeFrameString = *it2;
+            std::string& timeFrameString = timeFrameStrings[i];
 
             std::string requestUrl = DATA_REQUEST_PREFIX + variableIdIter->second +
                 "/events/xml?" + timeFrameString;
@@ -101,12 +103,12 @@ void FingridDataImporter::fetchData(const ApiDataType& dataType,
             thisDataTypeRequestUrls.push_back(requestUrl);
 
             // Send fetch request for this variable ID
-            xmlFetcher_.fetchXml(requestUrl, API_KEY_HEADER_NAME, apiKey_);
+            xmlFetcher_.fetchXml(requestUrl, API_KEY_HEADER_NAME, apiKey_,
+                                 timeFrames[i].first, timeFrames[i].second);
         }
 
         segmenter_->openNewReceptable(thisDataType, location,
-                                      startTime, endTime,
-                                      thisDataTypeRequestUrls);
+                                      thisDataTypeRequestUrls, timeFrames);
     }
 }
 
@@ -130,97 +132,111 @@ std::string FingridDataImporter::getSourceName()
     return FINGRID_FULL_NAME;
 }
 
-void FingridDataImporter::parseXml(const QDomDocument& xmlData,
-                                   const std::string& url)
+int FingridDataImporter::getRecordDepth() const
 {
-    // Identify received data type based on variable ID
-    auto dataTypeIter = VARIABLE_IDS_TO_DATA_TYPE_ENUMS.find(
-                            variableIdFromApiUrl(url));
+    return RECORD_DEPTH;
+}
 
-    // Unknown data type, do nothing
-    if (dataTypeIter == VARIABLE_IDS_TO_DATA_TYPE_ENUMS.end())
+XmlRecordParser FingridDataImporter::createRecordParser() const
+{
+    // The parser runs in another thread, so it gets a copy of its own
+    std::map<std::string, ApiDataType> dataTypesPerVariableId =
+        VARIABLE_IDS_TO_DATA_TYPE_ENUMS;
+
+    return [dataTypesPerVariableId](const XmlRecord& record,
+                                    const std::string& url,
+                                    ParsedDataPoint& parsedDataPoint)
+    {
+        return parseXmlRecord(record, url, dataTypesPerVariableId,
+                              parsedDataPoint);
+    };
+}
+
+bool FingridDataImporter::parseXmlRecord(const XmlRecord& record,
+    const std::string& url,
+    const std::map<std::string, ApiDataType>& dataTypesPerVariableId,
+    ParsedDataPoint& parsedDataPoint)
+{
+    auto dataValueStringIt = record.find("value");
+    auto dataEndTimeStringIt = record.find("end_time");
+
+    // If this record doesn't seem to be what was expected, skip it
+    if (dataValueStringIt == record.end()
+        || dataEndTimeStringIt == record.end())
     {
-        return;
+        return false;
     }
 
-    const ApiDataType& dataType = dataTypeIter->second;
+    std::string variableId;
+    float dataValue;
+    qint64 dataEndTime;
+
+    try
+    {
+        variableId = variableIdFromApiUrl(url);
+        dataValue = std::stof(dataValueStringIt->second.toStdString());
+        dataEndTime = secsSinceEpochFromApiString(dataEndTimeStringIt->second);
+    }
+    catch (const std::invalid_argument& exception)
+    {
+        // Data failed to parse, can't handle this data point correctly,
+        // don't use it
+        return false;
+    }
 
-    // Parse the XML data
-    QDomElement xmlRoot = xmlData.documentElement();
+    // Identify received data type based on variable ID
+    auto dataTypeIter = dataTypesPerVariableId.find(variableId);
 
-    for (QDomNode currentDataElement = xmlRoot.firstChildElement();
-         !currentDataElement.isNull();
-         currentDataElement = currentDataElement.nextSibling())
+    // Unknown data type, do nothing
+    if (dataTypeIter == dataTypesPerVariableId.end())
     {
-        std::string dataValueString = "null";
-        std::string dataStartTimeString = "unknown";
-        std::string dataEndTimeString = "unknown";
-
-        // Find the data value, start time and end time from the child elements
-        for (QDomElement currentChildElement =
-                currentDataElement.firstChildElement();
-             !currentChildElement.isNull();
-             currentChildElement = currentChildElement.nextSiblingElement())
-        {
-            QString tagName = currentChildElement.tagName();
+        return false;
+    }
 
-            if (tagName == "value")
-            {
-                dataValueString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-            else if (tagName == "start_time")
-            {
-                dataStartTimeString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-            else if (tagName == "end_time")
-            {
-                dataEndTimeString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-        }
+    // Ignore invalid values
+    if (std::isnan(dataValue))
+    {
+        return false;
+    }
 
-        float dataValue;
-        QDateTime dataStartTime;
-        QDateTime dataEndTime;
+    // Add data point for just end time to reduce memory needed
+    parsedDataPoint = { dataTypeIter->second, { dataEndTime, dataValue } };
 
-        try
-        {
-            dataValue = std::stof(dataValueString);
-            dataStartTime = dateTimeFromApiString(dataStartTimeString);
-            dataEndTime = dateTimeFromApiString(dataStartTimeString);
-        }
-        catch (const std::invalid_argument& exception)
-        {
-            // Data failed to parse, can't handle this data point correctly,
-            // don't use it
-            continue;
-        }
+    return true;
+}
 
-        // Ignore invalid values
-        if (std::isnan(dataValue)
-            || !dataStartTime.isValid()
-            || !dataEndTime.isValid())
-        {
-            continue;
-        }
+void FingridDataImporter::xmlDataPointsParsed(
+    const std::vector<ParsedDataPoint>& dataPoints, const std::string& url)
+{
+    for (const ParsedDataPoint& parsedDataPoint : dataPoints)
+    {
+        segmenter_->pushParsedDataPoint(parsedDataPoint.dataPoint, url,
+                                        parsedDataPoint.dataType);
+    }
+}
 
-        // Add data point for just end time to reduce memory needed
-        segmenter_->pushParsedDataPoint({ dataEndTime, dataValue },
-                                        url, dataType);
+void FingridDataImporter::xmlParsed(const std::string& url)
+{
+    // Report how far along each fetch operation waiting for this URL is
+    for (ReceptableProgress& progress :
+         segmenter_->getReceptableProgress(url))
+    {
+        emit fetchProgressed(progress.dataType, progress.dataLocation,
+                             progress.receivedSegmentCount,
+                             progress.segmentCount);
     }
 
-    // Get filled receptable data from segmenter. Each receptable contains all
-    // the segments for a single fetchData call
-    std::vector<SegmentedDataDetails> filledSegments =
-        segmenter_->getFilledReceptables(url);
+    // Get the segment of each fetch operation waiting for this URL from the
+    // segmenter. Segments are passed on as they arrive so that the data of
+    // long time periods can be shown before all of it has arrived.
+    std::vector<SegmentedDataDetails> receivedSegments =
+        segmenter_->getReceivedSegments(url);
 
-    for (auto it = filledSegments.begin(); it != filledSegments.end(); it++)
+    for (auto it = receivedSegments.begin(); it != receivedSegments.end(); it++)
     {
         SegmentedDataDetails& thisDataDetails = *it;
 
-        // Pass the data from a completed fetch operation forward
+        // Pass the data of this segment forward
         emit dataFetched(
             {
                 thisDataDetails.dataType, thisDataDetails.dataLocation,
@@ -232,6 +248,23 @@ void FingridDataImporter::parseXml(const QDomDocument& xmlData,
     }
 }
 
+void FingridDataImporter::xmlDiscarded(const std::string& url)
+{
+    segmenter_->discardSegment(url);
+}
+
+void FingridDataImporter::xmlCancelled(const std::string& url)
+{
+    for (SegmentedDataDetails& thisDataDetails :
+         segmenter_->cancelSegment(url))
+    {
+        emit fetchCancelled(
+            { thisDataDetails.dataType, thisDataDetails.dataLocation, "",
+              this, thisDataDetails.startDateTime,
+              thisDataDetails.endDateTime, 0, 0 });
+    }
+}
+
 std::string FingridDataImporter::variableIdFromApiUrl(const std::string& url)
 {
     std::string variableId = "";
@@ -78,16 +78,51 @@ public:
      */
     virtual std::string getSourceName() override;
 
-protected slots:
+protected:
     /**
-     * @brief parseXml parses XML data for electricity data and relays the
-     * parsed data through the dataFetched signal.
-     * @param xmlData: The XML data that is to be parsed
+     * @brief getRecordDepth returns the depth of the data point elements in
+     * Fingrid's XML data.
+     * @return 2
      */
-    void parseXml(const QDomDocument& xmlData,
-                  const std::string& url) override;
+    int getRecordDepth() const override;
+
+    /**
+     * @brief createRecordParser creates the function that parses a single
+     * data point element for electricity data with parseXmlRecord.
+     * @return The record parsing function
+     */
+    XmlRecordParser createRecordParser() const override;
+
+    /**
+     * @brief xmlDataPointsParsed pushes the parsed data points to segmenter_.
+     * @param dataPoints: The parsed data points
+     * @param url: The URL the data points were fetched from
+     */
+    void xmlDataPointsParsed(const std::vector<ParsedDataPoint>& dataPoints,
+                             const std::string& url) override;
+
+    /**
+     * @brief xmlParsed relays the data of every receptable filled by the
+     * parsed URL through the dataFetched signal.
+     * @param url: The URL whose data has been parsed
+     */
+    void xmlParsed(const std::string& url) override;
+
+    /**
+     * @brief xmlDiscarded throws away the data points parsed from the given
+     * URL so far.
+     * @param url: The URL whose parsed data points to throw away
+     */
+    void xmlDiscarded(const std::string& url) override;
+
+    /**
+     * @brief xmlCancelled closes the segment of the given URL in every
+     * receptable waiting for it and relays the cancelled time periods
+     * through the fetchCancelled signal.
+     * @param url: The URL whose fetch was cancelled
+     */
+    void xmlCancelled(const std::string& url) override;
 
-protected:
     const ApiDataType AVAILABLE_DATA_TYPES =
           ApiDataType::ElectricityConsumption
         | ApiDataType::ElectricityProduction
@@ -149,6 +184,9 @@ protected:
     // Stores the full name of the company Fingrid.
     const std::string FINGRID_FULL_NAME = "Fingrid Oyj";
 
+    // Stores how deep the data point elements are in the returned XML data
+    static const int RECORD_DEPTH = 2;
+
     // Stores how long the time frame in a single data fetch request can be in
     // seconds (currently 3 months)
     const int MAX_REQUEST_LENGTH_SECONDS = 3 * 30 * 24 * 60 * 60;
@@ -173,6 +211,21 @@ protected:
      * variable ID
      */
     static std::string variableIdFromApiUrl(const std::string& url);
+
+    /**
+     * @brief parseXmlRecord parses a single data point element for
+     * electricity data.
+     * @param record: The text contents of the record's child elements
+     * @param url: The URL the record was fetched from
+     * @param dataTypesPerVariableId: The data types of Fingrid's variable IDs
+     * @param parsedDataPoint: Set to the parsed data point
+     * @return True if a valid data point was parsed, otherwise false
+     */
+    static bool parseXmlRecord(const XmlRecord& record,
+                               const std::string& url,
+                               const std::map<std::string, ApiDataType>&
+                                   dataTypesPerVariableId,
+                               ParsedDataPoint& parsedDataPoint);
 };
 
 }
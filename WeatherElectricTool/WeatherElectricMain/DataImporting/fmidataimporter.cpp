@@ -7,6 +7,8 @@
 #include "fmidataimporter.hh"
 #include "datasegmenter.hh"
 
+#include <cmath>
+
 namespace DataImporting
 {
 
@@ -23,7 +25,19 @@ struct DataTypeGroup
     std::vector<std::string> requestUrls;
 };
 
-FmiDataImporter::FmiDataImporter(QObject* parent) : XmlDataImporter(parent),
+const char* const FmiDataImporter::DEFAULT_API_ADDRESS =
+    "https://opendata.fmi.fi";
+
+FmiDataImporter::FmiDataImporter(QObject* parent) :
+    FmiDataImporter(DEFAULT_API_ADDRESS, parent)
+{
+
+}
+
+FmiDataImporter::FmiDataImporter(const std::string& apiAddress,
+                                 QObject* parent) :
+    XmlDataImporter(parent),
+    DATA_REQUEST_PREFIX(apiAddress + "/wfs?request=getFeature&version=2.0.0"),
     segmenter_(new DataSegmenter())
 {
 
@@ -97,6 +111,9 @@ void FmiDataImporter::fetchData(const ApiDataType& dataType,
     int segmentCount = remainingTimeFrameLength / MAX_REQUEST_LENGTH_SECONDS
         + (remainingTimeFrameLength % MAX_REQUEST_LENGTH_SECONDS != 0);
 
+    // The time period of each request, the same for every data group
+    std::vector<std::pair<QDateTime, QDateTime>> timeFrames;
+
     // The FMI API can only return one week of data at a time, so if the time
     // frame is larger than that, we have to send multiple requests like this
     for (int i = 0; i < segmentCount; i++)
@@ -107,6 +124,8 @@ void FmiDataImporter::fetchData(const ApiDataType& dataType,
         QDateTime thisRequestEndTime =
             remainingTimeFrameStart.addSecs(thisRequestLength);
 
+        timeFrames.push_back({ remainingTimeFrameStart, thisRequestEndTime });
+
         // Create the middle part of the request URL
         std::string requestMiddleString = "&place=" + location + "&starttime="
             + dateTimeToApiString(remainingTimeFrameStart) + "&endtime="
@@ -125,7 +144,8 @@ void FmiDataImporter::fetchData(const ApiDataType& dataType,
 
                 dataTypeGroup.requestUrls.push_back(requestUrl);
 
-                xmlFetcher_.fetchXml(requestUrl);
+                xmlFetcher_.fetchXml(requestUrl, remainingTimeFrameStart,
+                                     thisRequestEndTime);
             }
         }
 
@@ -144,8 +164,8 @@ void FmiDataImporter::fetchData(const ApiDataType& dataType,
                 // Create new receptable for this data type, time period and
                 // the API request URLs used to fetch the data from this period
                 segmenter_->openNewReceptable(thisDataType, location,
-                                              startTime, endTime,
-                                              dataTypeGroup.requestUrls);
+                                              dataTypeGroup.requestUrls,
+                                              timeFrames);
 
                 break;
             }
@@ -173,102 +193,113 @@ std::string FmiDataImporter::getSourceName()
     return FMI_FULL_NAME;
 }
 
-void FmiDataImporter::parseXml(const QDomDocument& xmlData,
-                               const std::string& url)
+int FmiDataImporter::getRecordDepth() const
 {
-    QDomElement xmlRoot = xmlData.documentElement();
+    return RECORD_DEPTH;
+}
+
+XmlRecordParser FmiDataImporter::createRecordParser() const
+{
+    // The parser runs in another thread, so it gets a copy of its own
+    std::map<std::string, ApiDataType> dataTypesPerParameterCode =
+        PARAMETER_CODES_TO_DATA_TYPE_ENUMS;
 
-    // Iterate through XML nodes
-    for (QDomNode currentDataNode = xmlRoot.firstChild();
-         !currentDataNode.isNull();
-         currentDataNode = currentDataNode.nextSibling())
+    return [dataTypesPerParameterCode](const XmlRecord& record,
+                                       const std::string& url,
+                                       ParsedDataPoint& parsedDataPoint)
     {
-        QDomElement wfsElement = currentDataNode.firstChildElement();
+        Q_UNUSED(url);
 
-        // If this element doesn't seem to be what was expected, skip it
-        if (wfsElement.tagName() != "BsWfs:BsWfsElement")
-        {
-            continue;
-        }
+        return parseXmlRecord(record, dataTypesPerParameterCode,
+                              parsedDataPoint);
+    };
+}
 
-        std::string dataTypeString = "unknown";
-        std::string dataValueString = "null";
-        std::string dataTimeString = "unknown";
+bool FmiDataImporter::parseXmlRecord(const XmlRecord& record,
+    const std::map<std::string, ApiDataType>& dataTypesPerParameterCode,
+    ParsedDataPoint& parsedDataPoint)
+{
+    auto dataTypeStringIt = record.find("BsWfs:ParameterName");
+    auto dataValueStringIt = record.find("BsWfs:ParameterValue");
+    auto dataTimeStringIt = record.find("BsWfs:Time");
+
+    // If this record doesn't seem to be what was expected, skip it
+    if (dataTypeStringIt == record.end()
+        || dataValueStringIt == record.end()
+        || dataTimeStringIt == record.end())
+    {
+        return false;
+    }
 
-        // Find the data type, value and time from the child elements
-        for (QDomElement currentChildElement = wfsElement.firstChildElement();
-             !currentChildElement.isNull();
-             currentChildElement = currentChildElement.nextSiblingElement())
-        {
-            QString tagName = currentChildElement.tagName();
+    // Find data type
+    auto dataTypeIter = dataTypesPerParameterCode.find(
+        dataTypeStringIt->second.toStdString());
 
-            if (tagName == "BsWfs:ParameterName")
-            {
-                dataTypeString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-            else if (tagName == "BsWfs:ParameterValue")
-            {
-                dataValueString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-            else if (tagName == "BsWfs:Time")
-            {
-                dataTimeString = currentChildElement.firstChild()
-                    .toText().data().toStdString();
-            }
-        }
+    if (dataTypeIter == dataTypesPerParameterCode.end())
+    {
+        // Unknown data type, don't use this data point
+        return false;
+    }
 
-        // Find data type
-        ApiDataType dataType = ApiDataType::None;
+    ApiDataType dataType = dataTypeIter->second;
 
-        auto dataTypeIter =
-            PARAMETER_CODES_TO_DATA_TYPE_ENUMS.find(dataTypeString);
+    // Parse data value and time
+    float dataValue = 0;
+    qint64 dataTime = 0;
 
-        if (dataTypeIter != PARAMETER_CODES_TO_DATA_TYPE_ENUMS.end())
-        {
-            dataType = dataTypeIter->second;
-        }
-        else
-        {
-            // Unknown data type, don't use this data point
-            continue;
-        }
+    try
+    {
+        dataValue = std::stof(dataValueStringIt->second.toStdString());
+        dataTime = secsSinceEpochFromApiString(dataTimeStringIt->second);
+    }
+    catch (const std::invalid_argument& exception)
+    {
+        // Data value string or time string failed to parse, can't handle
+        // this data point correctly, don't use it
+        return false;
+    }
 
-        // Parse data value and time
-        float dataValue = 0;
-        QDateTime dataTime;
+    // Ignore invalid values
+    if (std::isnan(dataValue))
+    {
+        return false;
+    }
 
-        try
-        {
-            dataValue = std::stof(dataValueString);
-            dataTime = dateTimeFromApiString(dataTimeString);
-        }
-        catch (const std::invalid_argument& exception)
-        {
-            // Data value string or time string failed to parse, can't handle
-            // this data point correctly, don't use it
-            continue;
-        }
+    parsedDataPoint = { dataType, { dataTime, dataValue } };
 
-        // Ignore invalid values
-        if (std::isnan(dataValue) || !dataTime.isValid())
-        {
-            continue;
-        }
+    return true;
+}
 
-        segmenter_->pushParsedDataPoint({ dataTime, dataValue },
-                                        url, dataType);
+void FmiDataImporter::xmlDataPointsParsed(
+    const std::vector<ParsedDataPoint>& dataPoints, const std::string& url)
+{
+    for (const ParsedDataPoint& parsedDataPoint : dataPoints)
+    {
+        segmenter_->pushParsedDataPoint(parsedDataPoint.dataPoint, url,
+                                        parsedDataPoint.dataType);
+    }
+}
+
+void FmiDataImporter::xmlParsed(const std::string& url)
+{
+    // Report how far along each fetch operation waiting for this URL is
+    for (ReceptableProgress& progress :
+         segmenter_->getReceptableProgress(url))
+    {
+        emit fetchProgressed(progress.dataType, progress.dataLocation,
+                             progress.receivedSegmentCount,
+                             progress.segmentCount);
     }
 
-    // Get filled receptable data from segmenter. Each receptable contains all
-    // the segments for a single fetchData call
-    std::vector<SegmentedDataDetails> filledSegments =
-        segmenter_->getFilledReceptables(url);
+    // Get the segment of each fetch operation waiting for this URL from the
+    // segmenter. Segments are passed on as they arrive so that the data of
+    // long time periods can be shown before all of it has arrived.
+    std::vector<SegmentedDataDetails> receivedSegments =
+        segmenter_->getReceivedSegments(url);
 
-    for (SegmentedDataDetails& thisDataDetails : filledSegments)
+    for (SegmentedDataDetails& thisDataDetails : receivedSegments)
     {
-        // Pass the data from a completed fetch operation forward
+        // Pass the data of this segment forward
         emit dataFetched(
             { thisDataDetails.dataType, thisDataDetails.dataLocation,
               DATA_TYPE_ENUMS_TO_UNITS.at(thisDataDetails.dataType), this,
@@ -278,4 +309,21 @@ void FmiDataImporter::parseXml(const QDomDocument& xmlData,
     }
 }
 
+void FmiDataImporter::xmlDiscarded(const std::string& url)
+{
+    segmenter_->discardSegment(url);
+}
+
+void FmiDataImporter::xmlCancelled(const std::string& url)
+{
+    for (SegmentedDataDetails& thisDataDetails :
+         segmenter_->cancelSegment(url))
+    {
+        emit fetchCancelled(
+            { thisDataDetails.dataType, thisDataDetails.dataLocation, "",
+              this, thisDataDetails.startDateTime,
+              thisDataDetails.endDateTime, 0, 0 });
+    }
+}
+
 }
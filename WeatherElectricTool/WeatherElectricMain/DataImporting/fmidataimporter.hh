@@ -30,6 +30,15 @@ public:
      */
     explicit FmiDataImporter(QObject* parent = nullptr);
 
+    /**
+     * @brief A constructor for sending the requests to another server that
+     * serves the same API, such as a local stub server in tests.
+     * @param apiAddress: The scheme and host to send requests to, for
+     * example "http://127.0.0.1:8080"
+     * @param parent: The QObject to parent this FmiDataImporter to
+     */
+    FmiDataImporter(const std::string& apiAddress, QObject* parent = nullptr);
+
     /**
      * @brief The default destructor.
      */
@@ -78,17 +87,51 @@ public:
      */
     virtual std::string getSourceName() override;
 
-protected slots:
+protected:
     /**
-     * @brief parseXml parses XML data for weather data and relays the
-     * parsed data through the dataFetched signal.
-     * @param xmlData: The XML data that is to be parsed
-     * @param url: The URL the XML data was fetched from
+     * @brief getRecordDepth returns the depth of the BsWfs:BsWfsElement
+     * elements in FMI's XML data.
+     * @return 3
      */
-    void parseXml(const QDomDocument& xmlData,
-                  const std::string& url) override;
+    int getRecordDepth() const override;
+
+    /**
+     * @brief createRecordParser creates the function that parses a single
+     * BsWfs:BsWfsElement for weather data with parseXmlRecord.
+     * @return The record parsing function
+     */
+    XmlRecordParser createRecordParser() const override;
+
+    /**
+     * @brief xmlDataPointsParsed pushes the parsed data points to segmenter_.
+     * @param dataPoints: The parsed data points
+     * @param url: The URL the data points were fetched from
+     */
+    void xmlDataPointsParsed(const std::vector<ParsedDataPoint>& dataPoints,
+                             const std::string& url) override;
+
+    /**
+     * @brief xmlParsed relays the data of every receptable filled by the
+     * parsed URL through the dataFetched signal.
+     * @param url: The URL whose data has been parsed
+     */
+    void xmlParsed(const std::string& url) override;
+
+    /**
+     * @brief xmlDiscarded throws away the data points parsed from the given
+     * URL so far.
+     * @param url: The URL whose parsed data points to throw away
+     */
+    void xmlDiscarded(const std::string& url) override;
+
+    /**
+     * @brief xmlCancelled closes the segment of the given URL in every
+     * receptable waiting for it and relays the cancelled time periods
+     * through the fetchCancelled signal.
+     * @param url: The URL whose fetch was cancelled
+     */
+    void xmlCancelled(const std::string& url) override;
 
-protected:
     // Stores every available data type that can be fetched with
     // FmiDataImporter
     const ApiDataType AVAILABLE_DATA_TYPES =
@@ -182,9 +225,11 @@ protected:
             "Lappeenranta"
         };
 
+    // The address of the FMI API unless another one is given
+    static const char* const DEFAULT_API_ADDRESS;
+
     // The prefix used in every FMI API request
-    const std::string DATA_REQUEST_PREFIX =
-        "https://opendata.fmi.fi/wfs?request=getFeature&version=2.0.0";
+    const std::string DATA_REQUEST_PREFIX;
 
     // The API request parameter for fetching observation data
     const std::string OBSERVATION_REQUEST_PARAMETER =
@@ -202,6 +247,9 @@ protected:
     // Stores the full name of the FMI
     const std::string FMI_FULL_NAME = "Finnish Meteorological Institute";
 
+    // Stores how deep the data point elements are in the returned XML data
+    static const int RECORD_DEPTH = 3;
+
     // Stores how long the time frame in a single data fetch request can be in
     // seconds (currently 6 days)
     const int MAX_REQUEST_LENGTH_SECONDS = 6 * 24 * 60 * 60;
@@ -211,6 +259,20 @@ protected:
      * returned by API requests.
      */
     DataSegmenter* segmenter_;
+
+    /**
+     * @brief parseXmlRecord parses a single BsWfs:BsWfsElement for weather
+     * data.
+     * @param record: The text contents of the record's child elements
+     * @param dataTypesPerParameterCode: The data types of FMI's parameter
+     * codes
+     * @param parsedDataPoint: Set to the parsed data point
+     * @return True if a valid data point was parsed, otherwise false
+     */
+    static bool parseXmlRecord(const XmlRecord& record,
+                               const std::map<std::string, ApiDataType>&
+                                   dataTypesPerParameterCode,
+                               ParsedDataPoint& parsedDataPoint);
 };
 
 }
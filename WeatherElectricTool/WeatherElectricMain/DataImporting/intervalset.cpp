@@ -0,0 +1,205 @@
+/**
+  * @file intervalset.cpp implements the IntervalSet class.
+  * @date 16.10.2026
+  */
+
+#include "intervalset.hh"
+
+#include <algorithm>
+#include <iterator>
+
+namespace DataImporting
+{
+
+IntervalSet::IntervalSet() : intervals_()
+{
+
+}
+
+void IntervalSet::add(qint64 startSecs, qint64 endSecs)
+{
+    if (startSecs > endSecs)
+    {
+        return;
+    }
+
+    auto it = intervals_.upper_bound(startSecs);
+
+    // Merge with the interval starting before this one if they touch
+    if (it != intervals_.begin())
+    {
+        auto previousIt = std::prev(it);
+
+        if (previousIt->second >= startSecs)
+        {
+            startSecs = previousIt->first;
+            endSecs = std::max(endSecs, previousIt->second);
+            intervals_.erase(previousIt);
+        }
+    }
+
+    // Merge with every interval starting inside this one
+    while (it != intervals_.end() && it->first <= endSecs)
+    {
+        endSecs = std::max(endSecs, it->second);
+        it = intervals_.erase(it);
+    }
+
+    intervals_.insert({ startSecs, endSecs });
+}
+
+void IntervalSet::add(const IntervalSet& other)
+{
+    for (auto& interval : other.intervals_)
+    {
+        add(interval.first, interval.second);
+    }
+}
+
+void IntervalSet::remove(qint64 startSecs, qint64 endSecs)
+{
+    if (startSecs > endSecs)
+    {
+        return;
+    }
+
+    auto it = intervals_.upper_bound(startSecs);
+
+    if (it != intervals_.begin())
+    {
+        it--;
+    }
+
+    std::vector<TimeInterval> remainders;
+
+    while (it != intervals_.end() && it->first <= endSecs)
+    {
+        // This interval is entirely before the removed one
+        if (it->second < startSecs)
+        {
+            it++;
+            continue;
+        }
+
+        // Keep the parts sticking out of the removed interval
+        if (it->first < startSecs)
+        {
+            remainders.push_back({ it->first, startSecs });
+        }
+
+        if (it->second > endSecs)
+        {
+            remainders.push_back({ endSecs, it->second });
+        }
+
+        it = intervals_.erase(it);
+    }
+
+    for (TimeInterval& remainder : remainders)
+    {
+        intervals_.insert(remainder);
+    }
+}
+
+void IntervalSet::clear()
+{
+    intervals_.clear();
+}
+
+bool IntervalSet::empty() const
+{
+    return intervals_.empty();
+}
+
+bool IntervalSet::covers(qint64 startSecs, qint64 endSecs) const
+{
+    auto it = intervals_.upper_bound(startSecs);
+
+    if (it == intervals_.begin())
+    {
+        return false;
+    }
+
+    it--;
+
+    return it->second >= endSecs;
+}
+
+std::vector<TimeInterval> IntervalSet::gaps(qint64 startSecs,
+                                            qint64 endSecs) const
+{
+    std::vector<TimeInterval> foundGaps;
+
+    if (startSecs >= endSecs)
+    {
+        return foundGaps;
+    }
+
+    auto it = intervals_.upper_bound(startSecs);
+
+    // The interval starting before the requested one might cover its start
+    if (it != intervals_.begin())
+    {
+        it--;
+    }
+
+    qint64 coveredUntil = startSecs;
+
+    for (; it != intervals_.end() && it->first <= endSecs; it++)
+    {
+        if (it->first > coveredUntil)
+        {
+            foundGaps.push_back({ coveredUntil, it->first });
+        }
+
+        coveredUntil = std::max(coveredUntil, it->second);
+
+        if (coveredUntil >= endSecs)
+        {
+            return foundGaps;
+        }
+    }
+
+    foundGaps.push_back({ coveredUntil, endSecs });
+
+    return foundGaps;
+}
+
+std::vector<TimeInterval> IntervalSet::covered(qint64 startSecs,
+                                               qint64 endSecs) const
+{
+    std::vector<TimeInterval> foundParts;
+
+    if (startSecs >= endSecs)
+    {
+        return foundParts;
+    }
+
+    auto it = intervals_.upper_bound(startSecs);
+
+    // The interval starting before the requested one might cover its start
+    if (it != intervals_.begin())
+    {
+        it--;
+    }
+
+    for (; it != intervals_.end() && it->first < endSecs; it++)
+    {
+        qint64 partStart = std::max(startSecs, it->first);
+        qint64 partEnd = std::min(endSecs, it->second);
+
+        if (partStart < partEnd)
+        {
+            foundParts.push_back({ partStart, partEnd });
+        }
+    }
+
+    return foundParts;
+}
+
+std::vector<TimeInterval> IntervalSet::intervals() const
+{
+    return std::vector<TimeInterval>(intervals_.begin(), intervals_.end());
+}
+
+}
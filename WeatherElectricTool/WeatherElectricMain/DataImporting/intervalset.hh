@@ -0,0 +1,108 @@
+/**
+  * @file intervalset.hh declares the IntervalSet class, which is used to keep
+  * track of which time ranges have been covered.
+  * @date 16.10.2026
+  */
+
+#ifndef INTERVALSET_HH
+#define INTERVALSET_HH
+
+#include <QtGlobal>
+
+#include <map>
+#include <vector>
+
+namespace DataImporting
+{
+
+// A closed time interval in seconds since the epoch, first is the start
+typedef std::pair<qint64, qint64> TimeInterval;
+
+/**
+ * @brief The IntervalSet class stores a set of closed time intervals.
+ * Overlapping and adjacent intervals are merged as they are added, so the
+ * set always consists of disjoint intervals in chronological order.
+ */
+class IntervalSet
+{
+public:
+    /**
+     * @brief The default constructor.
+     */
+    IntervalSet();
+
+    /**
+     * @brief add adds an interval to this IntervalSet, merging it with every
+     * interval it overlaps or touches.
+     * @param startSecs: The start of the interval
+     * @param endSecs: The end of the interval
+     */
+    void add(qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief add adds every interval of another IntervalSet to this one.
+     * @param other: The IntervalSet whose intervals to add
+     */
+    void add(const IntervalSet& other);
+
+    /**
+     * @brief remove removes an interval from this IntervalSet, cutting the
+     * intervals it overlaps. The ends of the removed interval stay covered.
+     * @param startSecs: The start of the interval to remove
+     * @param endSecs: The end of the interval to remove
+     */
+    void remove(qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief clear removes every interval from this IntervalSet.
+     */
+    void clear();
+
+    /**
+     * @brief empty checks whether this IntervalSet has no intervals.
+     * @return True if there are no intervals, otherwise false
+     */
+    bool empty() const;
+
+    /**
+     * @brief covers checks whether the given interval is entirely covered by
+     * this IntervalSet.
+     * @param startSecs: The start of the interval
+     * @param endSecs: The end of the interval
+     * @return True if the interval is covered, otherwise false
+     */
+    bool covers(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief gaps computes the parts of the given interval that aren't
+     * covered by this IntervalSet. The gaps share their ends with the covered
+     * intervals next to them.
+     * @param startSecs: The start of the interval
+     * @param endSecs: The end of the interval
+     * @return The uncovered parts in chronological order
+     */
+    std::vector<TimeInterval> gaps(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief covered computes the parts of the given interval that are
+     * covered by this IntervalSet.
+     * @param startSecs: The start of the interval
+     * @param endSecs: The end of the interval
+     * @return The covered parts in chronological order
+     */
+    std::vector<TimeInterval> covered(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief intervals returns every interval of this IntervalSet.
+     * @return The intervals in chronological order
+     */
+    std::vector<TimeInterval> intervals() const;
+
+private:
+    // Maps the start of each interval to its end
+    std::map<qint64, qint64> intervals_;
+};
+
+}
+
+#endif // INTERVALSET_HH
@@ -0,0 +1,156 @@
+/**
+  * @file minmaxtree.cpp implements the MinMaxTree class.
+  * @date 16.10.2026
+  */
+
+#include "minmaxtree.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace DataImporting
+{
+
+// Values that don't affect the minimum or the maximum
+static const float NO_MIN = std::numeric_limits<float>::infinity();
+static const float NO_MAX = -std::numeric_limits<float>::infinity();
+
+MinMaxTree::MinMaxTree() : minValues_(2, NO_MIN), maxValues_(2, NO_MAX),
+    capacity_(1), begin_(0), end_(0)
+{
+
+}
+
+void MinMaxTree::assign(const std::vector<float>& values)
+{
+    int valueCount = values.size();
+
+    // Leave as much room at both ends as the values take together, so that
+    // the sequence can grow a lot before the tree has to be rebuilt
+    capacity_ = 1;
+
+    while (capacity_ < 2 * valueCount)
+    {
+        capacity_ *= 2;
+    }
+
+    minValues_.assign(2 * capacity_, NO_MIN);
+    maxValues_.assign(2 * capacity_, NO_MAX);
+
+    begin_ = (capacity_ - valueCount) / 2;
+    end_ = begin_ + valueCount;
+
+    std::copy(values.begin(), values.end(),
+              minValues_.begin() + capacity_ + begin_);
+    std::copy(values.begin(), values.end(),
+              maxValues_.begin() + capacity_ + begin_);
+
+    for (int i = capacity_ - 1; i > 0; i--)
+    {
+        minValues_[i] = std::min(minValues_[2 * i], minValues_[2 * i + 1]);
+        maxValues_[i] = std::max(maxValues_[2 * i], maxValues_[2 * i + 1]);
+    }
+}
+
+void MinMaxTree::append(const std::vector<float>& values)
+{
+    reserve(0, values.size());
+
+    for (float value : values)
+    {
+        setLeaf(end_, value);
+        end_++;
+    }
+}
+
+void MinMaxTree::prepend(const std::vector<float>& values)
+{
+    reserve(values.size(), 0);
+
+    for (auto it = values.rbegin(); it != values.rend(); it++)
+    {
+        begin_--;
+        setLeaf(begin_, *it);
+    }
+}
+
+void MinMaxTree::removeFirst(int count)
+{
+    // The removed leaves are left as they are, queries only cover the
+    // sequence
+    begin_ += std::min(std::max(count, 0), size());
+}
+
+void MinMaxTree::removeLast(int count)
+{
+    end_ -= std::min(std::max(count, 0), size());
+}
+
+int MinMaxTree::size() const
+{
+    return end_ - begin_;
+}
+
+std::pair<float, float> MinMaxTree::minMaxValues() const
+{
+    float minValue = NO_MIN;
+    float maxValue = NO_MAX;
+
+    // Climb from both ends of the sequence towards the root, taking in the
+    // nodes that are entirely inside it
+    for (int left = begin_ + capacity_, right = end_ + capacity_;
+         left < right; left /= 2, right /= 2)
+    {
+        if (left % 2 == 1)
+        {
+            minValue = std::min(minValue, minValues_[left]);
+            maxValue = std::max(maxValue, maxValues_[left]);
+            left++;
+        }
+
+        if (right % 2 == 1)
+        {
+            right--;
+            minValue = std::min(minValue, minValues_[right]);
+            maxValue = std::max(maxValue, maxValues_[right]);
+        }
+    }
+
+    return { minValue, maxValue };
+}
+
+void MinMaxTree::reserve(int frontCount, int backCount)
+{
+    if (begin_ >= frontCount && capacity_ - end_ >= backCount)
+    {
+        return;
+    }
+
+    std::vector<float> values(minValues_.begin() + capacity_ + begin_,
+                              minValues_.begin() + capacity_ + end_);
+
+    // Pad the sequence so that the rebuilt tree has room for the new values
+    // at either end, the padding itself is left outside the sequence
+    int valueCount = values.size();
+    values.resize(valueCount + 2 * std::max(frontCount, backCount));
+    assign(values);
+
+    end_ = begin_ + valueCount;
+}
+
+void MinMaxTree::setLeaf(int index, float value)
+{
+    int node = index + capacity_;
+    minValues_[node] = value;
+    maxValues_[node] = value;
+
+    for (node /= 2; node > 0; node /= 2)
+    {
+        minValues_[node] = std::min(minValues_[2 * node],
+                                    minValues_[2 * node + 1]);
+        maxValues_[node] = std::max(maxValues_[2 * node],
+                                    maxValues_[2 * node + 1]);
+    }
+}
+
+}
@@ -0,0 +1,111 @@
+/**
+  * @file minmaxtree.hh declares the MinMaxTree class, which is used to keep
+  * track of the smallest and largest value of a changing sequence.
+  * @date 16.10.2026
+  */
+
+#ifndef MINMAXTREE_HH
+#define MINMAXTREE_HH
+
+#include <utility>
+#include <vector>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The MinMaxTree class stores a sequence of values in a segment tree
+ * of their minimums and maximums, so that the smallest and largest value of
+ * the sequence can be found in O(log n) time however long it is. Values can
+ * be added to and removed from both ends of the sequence: removing is O(1)
+ * and adding k values is O(k log n), with an occasional O(n) rebuild when
+ * the tree runs out of room at either end.
+ */
+class MinMaxTree
+{
+public:
+    /**
+     * @brief The default constructor. The sequence starts empty.
+     */
+    MinMaxTree();
+
+    /**
+     * @brief assign replaces the sequence with the given values.
+     * @param values: The new values
+     */
+    void assign(const std::vector<float>& values);
+
+    /**
+     * @brief append adds values to the end of the sequence.
+     * @param values: The values to add, in order
+     */
+    void append(const std::vector<float>& values);
+
+    /**
+     * @brief prepend adds values to the start of the sequence.
+     * @param values: The values to add, in order
+     */
+    void prepend(const std::vector<float>& values);
+
+    /**
+     * @brief removeFirst removes values from the start of the sequence.
+     * @param count: How many values to remove, at most the whole sequence is
+     * removed
+     */
+    void removeFirst(int count);
+
+    /**
+     * @brief removeLast removes values from the end of the sequence.
+     * @param count: How many values to remove, at most the whole sequence is
+     * removed
+     */
+    void removeLast(int count);
+
+    /**
+     * @brief size returns how many values are in the sequence.
+     * @return The number of values
+     */
+    int size() const;
+
+    /**
+     * @brief minMaxValues finds the smallest and largest value of the
+     * sequence.
+     * @return The smallest and largest value, infinity and negative infinity
+     * if the sequence is empty
+     */
+    std::pair<float, float> minMaxValues() const;
+
+private:
+    // Stores the minimums and maximums of the tree's nodes. The root is at
+    // index 1 and the children of node i are at 2i and 2i + 1, so the leaves
+    // holding the values are at capacity_ and after.
+    std::vector<float> minValues_;
+    std::vector<float> maxValues_;
+
+    // Stores how many leaves the tree has, always a power of two
+    int capacity_;
+
+    // Stores the range of leaves holding the sequence, leaves outside it are
+    // ignored
+    int begin_;
+    int end_;
+
+    /**
+     * @brief reserve makes sure there are free leaves at both ends of the
+     * sequence, rebuilding the tree with more room if needed.
+     * @param frontCount: How many free leaves are needed before the sequence
+     * @param backCount: How many free leaves are needed after the sequence
+     */
+    void reserve(int frontCount, int backCount);
+
+    /**
+     * @brief setLeaf stores a value in a leaf and updates the nodes above it.
+     * @param index: The index of the leaf among the leaves
+     * @param value: The value to store
+     */
+    void setLeaf(int index, float value);
+};
+
+}
+
+#endif // MINMAXTREE_HH
@@ -0,0 +1,296 @@
+/**
+  * @file requestscheduler.cpp implements the RequestScheduler class.
+  * @date 16.10.2026
+  */
+
+#include "requestscheduler.hh"
+
+#include <QTimer>
+
+#include <vector>
+
+namespace DataImporting
+{
+
+RequestScheduler::RequestScheduler(QObject* parent) : QObject(parent),
+    networkManager_(), queuedRequests_(), requestsInFlight_(),
+    retryingRequests_(), requestCountsInFlight_(), visibleStartSecs_(0), visibleEndSecs_(0)
+{
+    // Call replyReceived whenever a network reply is finished
+    connect(&networkManager_, &QNetworkAccessManager::finished,
+            this, &RequestScheduler::replyReceived);
+}
+
+RequestScheduler::~RequestScheduler()
+{
+
+}
+
+void RequestScheduler::scheduleRequest(const std::string& url,
+                                       const std::string& customHeaderName,
+                                       const std::string& customHeaderValue,
+                                       qint64 startSecs, qint64 endSecs)
+{
+    std::string host =
+        QUrl(QString::fromStdString(url)).host().toStdString();
+
+    queuedRequests_.push_back({ url, host, customHeaderName,
+                                customHeaderValue, startSecs, endSecs,
+                                0, false });
+
+    sendQueuedRequests();
+}
+
+void RequestScheduler::setVisibleTimeRange(qint64 startSecs, qint64 endSecs)
+{
+    visibleStartSecs_ = startSecs;
+    visibleEndSecs_ = endSecs;
+}
+
+void RequestScheduler::cancelRequestsOutside(qint64 startSecs,
+                                             qint64 endSecs)
+{
+    std::vector<std::string> cancelledUrls;
+
+    for (auto it = queuedRequests_.begin(); it != queuedRequests_.end();)
+    {
+        if (overlaps(*it, startSecs, endSecs))
+        {
+            it++;
+            continue;
+        }
+
+        cancelledUrls.push_back(it->url);
+        it = queuedRequests_.erase(it);
+    }
+
+    for (auto it = retryingRequests_.begin(); it != retryingRequests_.end();)
+    {
+        if (overlaps(it->second, startSecs, endSecs))
+        {
+            it++;
+            continue;
+        }
+
+        cancelledUrls.push_back(it->first);
+        it = retryingRequests_.erase(it);
+    }
+
+    for (auto it = requestsInFlight_.begin(); it != requestsInFlight_.end();)
+    {
+        if (overlaps(it->second, startSecs, endSecs))
+        {
+            it++;
+            continue;
+        }
+
+        QNetworkReply* reply = it->first;
+        cancelledUrls.push_back(it->second.url);
+        requestCountsInFlight_[it->second.host]--;
+        it = requestsInFlight_.erase(it);
+
+        // Nothing more is read from the aborted reply, replyReceived only
+        // deletes it since it's no longer in flight
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+    }
+
+    for (const std::string& url : cancelledUrls)
+    {
+        emit requestCancelled(url);
+    }
+
+    // Aborting made room for other requests
+    sendQueuedRequests();
+}
+
+void RequestScheduler::replyReceived(QNetworkReply* reply)
+{
+    auto requestIt = requestsInFlight_.find(reply);
+
+    if (requestIt == requestsInFlight_.end())
+    {
+        reply->deleteLater();
+        return;
+    }
+
+    ScheduledRequest request = requestIt->second;
+    requestsInFlight_.erase(requestIt);
+    requestCountsInFlight_[request.host]--;
+
+    bool failed = reply->error() != QNetworkReply::NoError
+                  || isErrorStatus(reply);
+
+    if (failed && isTransientFailure(reply)
+        && request.attemptCount <= MAX_RETRY_COUNT)
+    {
+        // Anything already passed on from this reply is incomplete
+        if (request.hasPassedData)
+        {
+            emit requestRestarted(request.url);
+            request.hasPassedData = false;
+        }
+
+        // Wait longer after every failed attempt
+        int retryDelay =
+            FIRST_RETRY_DELAY_MILLISECONDS << (request.attemptCount - 1);
+
+        std::string url = request.url;
+        retryingRequests_[url] = request;
+
+        QTimer::singleShot(retryDelay, this, [this, url]()
+        {
+            auto retryIt = retryingRequests_.find(url);
+
+            // The request was cancelled while waiting
+            if (retryIt == retryingRequests_.end())
+            {
+                return;
+            }
+
+            queuedRequests_.push_front(retryIt->second);
+            retryingRequests_.erase(retryIt);
+            sendQueuedRequests();
+        });
+    }
+    else if (failed)
+    {
+        // A failed request isn't an empty reply, its data is still missing
+        emit requestFailed(request.url);
+    }
+    else
+    {
+        // Pass on whatever data is still left in the reply
+        replyDataAvailable(reply);
+
+        emit requestFinished(request.url);
+    }
+
+    // The reply needs to be deleted using this special method
+    reply->deleteLater();
+
+    sendQueuedRequests();
+}
+
+void RequestScheduler::sendQueuedRequests()
+{
+    // Send requests for visible data first, then the rest
+    for (bool sendVisible : { true, false })
+    {
+        for (auto it = queuedRequests_.begin(); it != queuedRequests_.end();)
+        {
+            if (isVisible(*it) == sendVisible
+                && requestCountsInFlight_[it->host]
+                   < MAX_REQUESTS_IN_FLIGHT_PER_HOST)
+            {
+                sendRequest(*it);
+                it = queuedRequests_.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+}
+
+void RequestScheduler::sendRequest(const ScheduledRequest& request)
+{
+    QNetworkRequest networkRequest(QUrl(QString::fromStdString(request.url)));
+
+    if (request.customHeaderName != "")
+    {
+        networkRequest.setRawHeader(
+            QByteArray::fromStdString(request.customHeaderName),
+            QByteArray::fromStdString(request.customHeaderValue));
+    }
+
+    QNetworkReply* reply = networkManager_.get(networkRequest);
+
+    ScheduledRequest& sentRequest = requestsInFlight_[reply];
+    sentRequest = request;
+    sentRequest.attemptCount++;
+
+    requestCountsInFlight_[request.host]++;
+
+    // Pass data forward as soon as it arrives instead of waiting for the
+    // whole reply
+    connect(reply, &QNetworkReply::readyRead,
+            this, [this, reply]() { replyDataAvailable(reply); });
+}
+
+void RequestScheduler::replyDataAvailable(QNetworkReply* reply)
+{
+    auto requestIt = requestsInFlight_.find(reply);
+
+    // Error pages aren't data, don't pass them on
+    if (isErrorStatus(reply))
+    {
+        return;
+    }
+
+    QByteArray data = reply->readAll();
+
+    if (data.isEmpty())
+    {
+        return;
+    }
+
+    std::string url;
+
+    if (requestIt != requestsInFlight_.end())
+    {
+        requestIt->second.hasPassedData = true;
+        url = requestIt->second.url;
+    }
+    else
+    {
+        url = reply->url().toString().toStdString();
+    }
+
+    emit dataReceived(data, url);
+}
+
+bool RequestScheduler::isVisible(const ScheduledRequest& request) const
+{
+    return overlaps(request, visibleStartSecs_, visibleEndSecs_);
+}
+
+bool RequestScheduler::overlaps(const ScheduledRequest& request,
+                                qint64 startSecs, qint64 endSecs)
+{
+    return request.startSecs < endSecs && request.endSecs > startSecs;
+}
+
+bool RequestScheduler::isTransientFailure(QNetworkReply* reply)
+{
+    int statusCode =
+        reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // Too many requests or a server side problem
+    if (statusCode == 429 || statusCode >= 500)
+    {
+        return true;
+    }
+
+    switch (reply->error())
+    {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool RequestScheduler::isErrorStatus(QNetworkReply* reply)
+{
+    return reply->attribute(
+        QNetworkRequest::HttpStatusCodeAttribute).toInt() >= 400;
+}
+
+}
@@ -0,0 +1,233 @@
+/**
+  * @file requestscheduler.hh declares the RequestScheduler class, which is
+  * used to queue and send API requests with limited concurrency.
+  * @date 16.10.2026
+  */
+
+#ifndef REQUESTSCHEDULER_HH
+#define REQUESTSCHEDULER_HH
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+#include <list>
+#include <map>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The RequestScheduler class queues network requests and sends them
+ * so that only a limited number of requests are in flight per host at a time.
+ * Requests for data inside the visible time range are sent first and
+ * requests that fail for transient reasons are retried with an increasing
+ * delay.
+ */
+class RequestScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief The default constructor.
+     * @param parent: The QObject to parent this RequestScheduler to
+     */
+    explicit RequestScheduler(QObject* parent = nullptr);
+
+    /**
+     * @brief The default destructor.
+     */
+    virtual ~RequestScheduler();
+
+    /**
+     * @brief scheduleRequest queues a GET request to the given URL.
+     * @param url: The URL to request
+     * @param customHeaderName: The name of the custom HTML header to include,
+     * empty if no custom header is needed
+     * @param customHeaderValue: The value of the custom HTML header to include
+     * @param startSecs: The start of the time period the requested data is
+     * from in seconds since the epoch
+     * @param endSecs: The end of the time period the requested data is from
+     * in seconds since the epoch
+     */
+    void scheduleRequest(const std::string& url,
+                         const std::string& customHeaderName,
+                         const std::string& customHeaderValue,
+                         qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief setVisibleTimeRange sets the time range that is currently shown
+     * to the user. Queued requests for data inside this range are sent before
+     * other requests.
+     * @param startSecs: The start of the visible range in seconds since the
+     * epoch
+     * @param endSecs: The end of the visible range in seconds since the epoch
+     */
+    void setVisibleTimeRange(qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief cancelRequestsOutside drops every queued request and aborts
+     * every request in flight or waiting to be retried whose data is
+     * entirely outside the given time range. requestCancelled is sent for
+     * each of them.
+     * @param startSecs: The start of the time range in seconds since the
+     * epoch
+     * @param endSecs: The end of the time range in seconds since the epoch
+     */
+    void cancelRequestsOutside(qint64 startSecs, qint64 endSecs);
+
+signals:
+    /**
+     * @brief The dataReceived signal is sent whenever a successful reply has
+     * received a new chunk of data.
+     * @param data: The received chunk of data
+     * @param url: The URL the data is being fetched from
+     */
+    void dataReceived(const QByteArray& data, const std::string& url);
+
+    /**
+     * @brief The requestRestarted signal is sent when a request that already
+     * passed on data failed and is going to be sent again. Any data received
+     * from the URL so far should be discarded.
+     * @param url: The URL of the restarted request
+     */
+    void requestRestarted(const std::string& url);
+
+    /**
+     * @brief The requestFinished signal is sent when a request has finished
+     * successfully.
+     * @param url: The URL of the finished request
+     */
+    void requestFinished(const std::string& url);
+
+    /**
+     * @brief The requestFailed signal is sent when a request has failed and
+     * won't be retried anymore. Any data received from the URL so far is
+     * incomplete and no more of it will arrive.
+     * @param url: The URL of the failed request
+     */
+    void requestFailed(const std::string& url);
+
+    /**
+     * @brief The requestCancelled signal is sent when a request has been
+     * cancelled before it finished. Any data received from the URL so far is
+     * incomplete and no more of it will arrive.
+     * @param url: The URL of the cancelled request
+     */
+    void requestCancelled(const std::string& url);
+
+protected slots:
+    /**
+     * @brief replyReceived is called whenever networkManager_ finishes
+     * receiving a network reply.
+     * @param reply: A pointer to the QNetworkReply received
+     */
+    void replyReceived(QNetworkReply* reply);
+
+protected:
+    /**
+     * @brief The ScheduledRequest struct stores a queued or in-flight
+     * request.
+     */
+    struct ScheduledRequest
+    {
+        std::string url;
+        std::string host;
+        std::string customHeaderName;
+        std::string customHeaderValue;
+        qint64 startSecs;
+        qint64 endSecs;
+        int attemptCount;
+        bool hasPassedData;
+    };
+
+    // Stores how many requests can be in flight to a single host at a time
+    static const int MAX_REQUESTS_IN_FLIGHT_PER_HOST = 4;
+
+    // Stores how many times a failed request is sent again
+    static const int MAX_RETRY_COUNT = 3;
+
+    // Stores the delay before the first retry, doubled for every retry after
+    static const int FIRST_RETRY_DELAY_MILLISECONDS = 1000;
+
+    /**
+     * @brief networkManager_ stores the QNetworkAccessManager that makes
+     * fetch requests.
+     */
+    QNetworkAccessManager networkManager_;
+
+    /**
+     * @brief sendQueuedRequests sends queued requests until the in-flight
+     * limit of every host with queued requests is reached.
+     */
+    void sendQueuedRequests();
+
+    /**
+     * @brief sendRequest sends the given request immediately.
+     * @param request: The request to send
+     */
+    void sendRequest(const ScheduledRequest& request);
+
+    /**
+     * @brief replyDataAvailable is called whenever a network reply has
+     * received new data that can be read.
+     * @param reply: A pointer to the QNetworkReply that has new data
+     */
+    void replyDataAvailable(QNetworkReply* reply);
+
+    /**
+     * @brief isVisible checks whether the data of the given request is inside
+     * the visible time range.
+     * @param request: The request to check
+     * @return True if the request's time period overlaps the visible range
+     */
+    bool isVisible(const ScheduledRequest& request) const;
+
+    /**
+     * @brief overlaps checks whether the data of the given request is inside
+     * the given time range.
+     * @param request: The request to check
+     * @param startSecs: The start of the time range
+     * @param endSecs: The end of the time range
+     * @return True if the request's time period overlaps the range
+     */
+    static bool overlaps(const ScheduledRequest& request, qint64 startSecs,
+                         qint64 endSecs);
+
+    /**
+     * @brief isTransientFailure checks whether a failed reply failed for a
+     * reason that might go away by trying again.
+     * @param reply: The failed reply
+     * @return True if the request is worth retrying, otherwise false
+     */
+    static bool isTransientFailure(QNetworkReply* reply);
+
+    /**
+     * @brief isErrorStatus checks whether a reply has an HTTP error status.
+     * @param reply: The reply to check
+     * @return True if the reply's HTTP status code is an error code
+     */
+    static bool isErrorStatus(QNetworkReply* reply);
+
+private:
+    // Stores the requests waiting to be sent, in the order they were queued
+    std::list<ScheduledRequest> queuedRequests_;
+
+    // Stores the requests that have been sent but not finished yet
+    std::map<QNetworkReply*, ScheduledRequest> requestsInFlight_;
+
+    // Stores the failed requests waiting for their retry delay to pass by URL
+    std::map<std::string, ScheduledRequest> retryingRequests_;
+
+    // Stores how many requests are currently in flight per host
+    std::map<std::string, int> requestCountsInFlight_;
+
+    // Stores the time range currently visible to the user
+    qint64 visibleStartSecs_;
+    qint64 visibleEndSecs_;
+};
+
+}
+
+#endif // REQUESTSCHEDULER_HH
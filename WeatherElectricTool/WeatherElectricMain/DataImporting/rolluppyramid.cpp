@@ -0,0 +1,191 @@
+/**
+  * @file rolluppyramid.cpp implements the RollupPyramid class.
+  * @date 16.10.2026
+  */
+
+#include "rolluppyramid.hh"
+
+namespace DataImporting
+{
+
+// Hourly, daily and weekly
+const qint64 RollupPyramid::LEVEL_SECONDS[LEVEL_COUNT] =
+    { 60 * 60, 24 * 60 * 60, 7 * 24 * 60 * 60 };
+
+RollupPyramid::RollupPyramid() : levels_()
+{
+
+}
+
+qint64 RollupPyramid::bucketLength(qint64 minimumSecs)
+{
+    qint64 bucketSecs = 1;
+
+    for (int level = 0; level < LEVEL_COUNT; level++)
+    {
+        if (LEVEL_SECONDS[level] <= minimumSecs)
+        {
+            bucketSecs = LEVEL_SECONDS[level];
+        }
+    }
+
+    while (bucketSecs < minimumSecs)
+    {
+        bucketSecs *= 2;
+    }
+
+    return bucketSecs;
+}
+
+void RollupPyramid::update(const TimeSeries& series, qint64 startSecs,
+                           qint64 endSecs)
+{
+    if (startSecs > endSecs)
+    {
+        return;
+    }
+
+    for (int level = 0; level < LEVEL_COUNT; level++)
+    {
+        qint64 levelSecs = LEVEL_SECONDS[level];
+        qint64 firstBucket = bucketIndex(startSecs, levelSecs);
+        qint64 lastBucket = bucketIndex(endSecs, levelSecs);
+
+        std::map<qint64, Rollup>& rollups = levels_[level];
+
+        rollups.erase(rollups.lower_bound(firstBucket),
+                      rollups.upper_bound(lastBucket));
+
+        // The lowest level is made of data points
+        if (level == 0)
+        {
+            series.view(firstBucket * levelSecs,
+                        lastBucket * levelSecs + levelSecs - 1)
+                .forEachPoint([&rollups, levelSecs](qint64 time, float value)
+            {
+                combine(rollups[bucketIndex(time, levelSecs)],
+                        { time, value, time, value, value, 1 });
+            });
+        }
+        // The others are made of whole buckets of the level below
+        else
+        {
+            qint64 lowerSecs = LEVEL_SECONDS[level - 1];
+            const std::map<qint64, Rollup>& lowerRollups = levels_[level - 1];
+
+            auto it = lowerRollups.lower_bound(
+                firstBucket * levelSecs / lowerSecs);
+            auto endIt = lowerRollups.lower_bound(
+                (lastBucket + 1) * levelSecs / lowerSecs);
+
+            for (; it != endIt; it++)
+            {
+                combine(rollups[bucketIndex(it->first * lowerSecs, levelSecs)],
+                        it->second);
+            }
+        }
+    }
+}
+
+void RollupPyramid::clear()
+{
+    for (std::map<qint64, Rollup>& rollups : levels_)
+    {
+        rollups.clear();
+    }
+}
+
+Rollup RollupPyramid::summarize(const TimeSeries& series, qint64 startSecs,
+                                qint64 endSecs) const
+{
+    return summarizeLevel(LEVEL_COUNT - 1, series, startSecs, endSecs);
+}
+
+void RollupPyramid::combine(Rollup& rollup, const Rollup& next)
+{
+    if (next.count == 0)
+    {
+        return;
+    }
+
+    if (rollup.count == 0)
+    {
+        rollup = next;
+        return;
+    }
+
+    // Ties keep the earlier data point
+    if (next.minValue < rollup.minValue)
+    {
+        rollup.minTime = next.minTime;
+        rollup.minValue = next.minValue;
+    }
+
+    if (next.maxValue > rollup.maxValue)
+    {
+        rollup.maxTime = next.maxTime;
+        rollup.maxValue = next.maxValue;
+    }
+
+    rollup.sum += next.sum;
+    rollup.count += next.count;
+}
+
+Rollup RollupPyramid::summarizeLevel(int level, const TimeSeries& series,
+                                     qint64 startSecs, qint64 endSecs) const
+{
+    Rollup summary = Rollup();
+
+    if (startSecs > endSecs)
+    {
+        return summary;
+    }
+
+    // Below the lowest level, go through the data points
+    if (level < 0)
+    {
+        series.view(startSecs, endSecs).forEachPoint(
+            [&summary](qint64 time, float value)
+        {
+            combine(summary, { time, value, time, value, value, 1 });
+        });
+
+        return summary;
+    }
+
+    qint64 levelSecs = LEVEL_SECONDS[level];
+
+    // The buckets of this level that are entirely inside the time range
+    qint64 firstBucket = bucketIndex(startSecs + levelSecs - 1, levelSecs);
+    qint64 endBucket = bucketIndex(endSecs + 1, levelSecs);
+
+    if (firstBucket >= endBucket)
+    {
+        return summarizeLevel(level - 1, series, startSecs, endSecs);
+    }
+
+    // Summarize the partial buckets at the edges with lower levels
+    summary = summarizeLevel(level - 1, series, startSecs,
+                             firstBucket * levelSecs - 1);
+
+    const std::map<qint64, Rollup>& rollups = levels_[level];
+
+    for (auto it = rollups.lower_bound(firstBucket);
+         it != rollups.end() && it->first < endBucket; it++)
+    {
+        combine(summary, it->second);
+    }
+
+    combine(summary, summarizeLevel(level - 1, series,
+                                    endBucket * levelSecs, endSecs));
+
+    return summary;
+}
+
+qint64 RollupPyramid::bucketIndex(qint64 secsSinceEpoch, qint64 bucketSecs)
+{
+    return secsSinceEpoch / bucketSecs
+           - (secsSinceEpoch % bucketSecs < 0 ? 1 : 0);
+}
+
+}
@@ -0,0 +1,200 @@
+/**
+  * @file rolluppyramid.hh declares the RollupPyramid class, which is used to
+  * summarize long time series quickly.
+  * @date 16.10.2026
+  */
+
+#ifndef ROLLUPPYRAMID_HH
+#define ROLLUPPYRAMID_HH
+
+#include "timeseries.hh"
+
+#include <map>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The Rollup struct summarizes the data points of a time range.
+ */
+struct Rollup
+{
+    // The time and value of the first smallest data point
+    qint64 minTime;
+    float minValue;
+
+    // The time and value of the first largest data point
+    qint64 maxTime;
+    float maxValue;
+
+    // The sum of the values of the data points
+    double sum;
+
+    // The number of data points, the other members are unset if it's 0
+    qint64 count;
+
+    /**
+     * @brief mean returns the mean value of the summarized data points.
+     * @return The mean value, or 0 if there are no data points
+     */
+    double mean() const { return count > 0 ? sum / count : 0; }
+};
+
+/**
+ * @brief The RollupPyramid class stores hourly, daily and weekly rollups of a
+ * TimeSeries so that long time ranges of it can be summarized and decimated
+ * without going through every data point. Buckets of every level are aligned
+ * to multiples of their length since the epoch, so each bucket consists of
+ * whole buckets of the level below it.
+ *
+ * The rollups have to be updated whenever the TimeSeries changes.
+ */
+class RollupPyramid
+{
+public:
+    /**
+     * @brief The default constructor.
+     */
+    RollupPyramid();
+
+    /**
+     * @brief bucketLength finds the shortest time bucket length, at least
+     * as long as the given one, whose buckets can be made of whole rollups.
+     * The length is a power of two multiple of the longest rollup level that
+     * isn't longer than the given length.
+     * @param minimumSecs: The minimum bucket length in seconds
+     * @return The bucket length in seconds
+     */
+    static qint64 bucketLength(qint64 minimumSecs);
+
+    /**
+     * @brief update recalculates every rollup overlapping the given time
+     * range from a TimeSeries. Has to be called whenever data points in the
+     * time range have changed.
+     * @param series: The TimeSeries the rollups are made of
+     * @param startSecs: The start of the changed time range, inclusive
+     * @param endSecs: The end of the changed time range, inclusive
+     */
+    void update(const TimeSeries& series, qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief clear removes every rollup.
+     */
+    void clear();
+
+    /**
+     * @brief summarize summarizes the data points of a TimeSeries taken in the
+     * given time range using the longest rollups that fit in the range.
+     * @param series: The TimeSeries the rollups are made of
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @return The summary of the data points in the time range
+     */
+    Rollup summarize(const TimeSeries& series, qint64 startSecs,
+                     qint64 endSecs) const;
+
+    /**
+     * @brief forEachDecimatedPoint calls the given function with the time and
+     * value of the smallest and largest data point in every time bucket of
+     * the given time range, in chronological order. Gives the same data
+     * points as TimeSeriesView::forEachDecimatedPoint.
+     * @param series: The TimeSeries the rollups are made of
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @param bucketSecs: The length of a bucket in seconds, should be given
+     * by bucketLength
+     * @param function: The function to call, taking a qint64 time and a float
+     * value
+     */
+    template <typename Function>
+    void forEachDecimatedPoint(const TimeSeries& series, qint64 startSecs,
+                               qint64 endSecs, qint64 bucketSecs,
+                               Function function) const;
+
+private:
+    // Stores how many rollup levels there are
+    static const int LEVEL_COUNT = 3;
+
+    // Stores the bucket length of each level in seconds, shortest first
+    static const qint64 LEVEL_SECONDS[LEVEL_COUNT];
+
+    // Maps the index of each non-empty bucket to its rollup, for each level
+    std::map<qint64, Rollup> levels_[LEVEL_COUNT];
+
+    /**
+     * @brief combine adds the data points summarized by one Rollup to another.
+     * @param rollup: The Rollup to add to
+     * @param next: The Rollup to add, summarizing later data points
+     */
+    static void combine(Rollup& rollup, const Rollup& next);
+
+    /**
+     * @brief summarizeLevel summarizes a time range using rollups of the
+     * given level and below for the parts of the range they fit in.
+     * @param level: The highest level to use, -1 uses only data points
+     * @param series: The TimeSeries the rollups are made of
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @return The summary of the data points in the time range
+     */
+    Rollup summarizeLevel(int level, const TimeSeries& series,
+                          qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief bucketIndex finds the bucket a time is in, rounding down also
+     * for times before the epoch.
+     * @param secsSinceEpoch: The time
+     * @param bucketSecs: The length of a bucket in seconds
+     * @return The index of the bucket
+     */
+    static qint64 bucketIndex(qint64 secsSinceEpoch, qint64 bucketSecs);
+};
+
+template <typename Function>
+void RollupPyramid::forEachDecimatedPoint(const TimeSeries& series,
+                                          qint64 startSecs, qint64 endSecs,
+                                          qint64 bucketSecs,
+                                          Function function) const
+{
+    if (startSecs > endSecs)
+    {
+        return;
+    }
+
+    bucketSecs = std::max(bucketSecs, (qint64)1);
+
+    qint64 lastBucket = bucketIndex(endSecs, bucketSecs);
+
+    for (qint64 bucket = bucketIndex(startSecs, bucketSecs);
+         bucket <= lastBucket; bucket++)
+    {
+        Rollup rollup = summarize(
+            series, std::max(startSecs, bucket * bucketSecs),
+            std::min(endSecs, bucket * bucketSecs + bucketSecs - 1));
+
+        if (rollup.count == 0)
+        {
+            continue;
+        }
+
+        // Pass the smallest and largest data point of the bucket in order
+        if (rollup.minTime == rollup.maxTime)
+        {
+            function(rollup.minTime, rollup.minValue);
+        }
+        else if (rollup.minTime < rollup.maxTime)
+        {
+            function(rollup.minTime, rollup.minValue);
+            function(rollup.maxTime, rollup.maxValue);
+        }
+        else
+        {
+            function(rollup.maxTime, rollup.maxValue);
+            function(rollup.minTime, rollup.minValue);
+        }
+    }
+}
+
+}
+
+#endif // ROLLUPPYRAMID_HH
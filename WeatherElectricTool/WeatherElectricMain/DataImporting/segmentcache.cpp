@@ -0,0 +1,196 @@
+/**
+  * @file segmentcache.cpp implements the SegmentCache class.
+  * @date 16.10.2026
+  */
+
+#include "segmentcache.hh"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+namespace DataImporting
+{
+
+/**
+ * @brief writeIntervalSet writes the intervals of an IntervalSet to a stream.
+ * @param stream: The stream to write to
+ * @param intervalSet: The IntervalSet to write
+ */
+static void writeIntervalSet(QDataStream& stream,
+                             const IntervalSet& intervalSet)
+{
+    std::vector<TimeInterval> intervals = intervalSet.intervals();
+
+    stream << (quint32)intervals.size();
+
+    for (TimeInterval& interval : intervals)
+    {
+        stream << interval.first << interval.second;
+    }
+}
+
+/**
+ * @brief readIntervalSet reads intervals written by writeIntervalSet.
+ * @param stream: The stream to read from
+ * @param intervalSet: The IntervalSet to add the intervals to
+ */
+static void readIntervalSet(QDataStream& stream, IntervalSet& intervalSet)
+{
+    quint32 intervalCount = 0;
+    stream >> intervalCount;
+
+    for (quint32 i = 0; i < intervalCount && stream.status() == QDataStream::Ok;
+         i++)
+    {
+        qint64 startSecs = 0;
+        qint64 endSecs = 0;
+        stream >> startSecs >> endSecs;
+
+        intervalSet.add(startSecs, endSecs);
+    }
+}
+
+SegmentCache::SegmentCache() : cacheDirectory_(
+    QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+    + "/segments")
+{
+    QDir().mkpath(cacheDirectory_);
+}
+
+bool SegmentCache::readEntry(const std::string& sourceName,
+                             ApiDataType dataType,
+                             const std::string& dataLocation,
+                             SegmentCacheEntry& entry) const
+{
+    QString filePath = entryFilePath(sourceName, dataType, dataLocation);
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+
+    if (magic != FILE_MAGIC || version != FILE_VERSION)
+    {
+        return false;
+    }
+
+    QString unitOfMeasurement;
+    stream >> unitOfMeasurement >> entry.recentFetchedAtSecs;
+    entry.unitOfMeasurement = unitOfMeasurement.toStdString();
+
+    readIntervalSet(stream, entry.settledCoverage);
+    readIntervalSet(stream, entry.recentCoverage);
+
+    quint32 dataPointCount = 0;
+    stream >> dataPointCount;
+
+    // Don't trust the count of a truncated file
+    if (stream.status() != QDataStream::Ok
+        || dataPointCount > file.size() / (sizeof(qint64) + sizeof(float)))
+    {
+        return false;
+    }
+
+    for (quint32 i = 0; i < dataPointCount; i++)
+    {
+        qint64 secsSinceEpoch = 0;
+        float value = 0;
+        stream >> secsSinceEpoch >> value;
+
+        entry.data.append(secsSinceEpoch, value);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        return false;
+    }
+
+    file.close();
+
+    // Mark this file as recently used so it's evicted last
+    file.open(QIODevice::Append);
+    file.setFileTime(QDateTime::currentDateTimeUtc(),
+                     QFileDevice::FileModificationTime);
+
+    return true;
+}
+
+void SegmentCache::writeEntry(const std::string& sourceName,
+                              ApiDataType dataType,
+                              const std::string& dataLocation,
+                              const SegmentCacheEntry& entry) const
+{
+    // Write to a temporary file first so a crash can't leave a broken file
+    QSaveFile file(entryFilePath(sourceName, dataType, dataLocation));
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << FILE_MAGIC << FILE_VERSION
+           << QString::fromStdString(entry.unitOfMeasurement)
+           << entry.recentFetchedAtSecs;
+
+    writeIntervalSet(stream, entry.settledCoverage);
+    writeIntervalSet(stream, entry.recentCoverage);
+
+    stream << (quint32)entry.data.size();
+
+    entry.data.forEachPoint(0, entry.data.size(),
+        [&stream](qint64 secsSinceEpoch, float value)
+    {
+        stream << secsSinceEpoch << value;
+    });
+
+    file.commit();
+}
+
+QString SegmentCache::entryFilePath(const std::string& sourceName,
+                                    ApiDataType dataType,
+                                    const std::string& dataLocation) const
+{
+    // Percent-encode names so they can't contain path separators
+    QString fileName = QString::fromUtf8(
+        QUrl::toPercentEncoding(QString::fromStdString(sourceName + "_"
+            + getDataTypeName(dataType) + "_" + dataLocation)));
+
+    return cacheDirectory_ + "/" + fileName + ".bin";
+}
+
+void SegmentCache::evictOldEntries() const
+{
+    // Most recently used files first
+    QFileInfoList cacheFiles = QDir(cacheDirectory_).entryInfoList(
+        QDir::Files, QDir::Time);
+
+    qint64 totalSize = 0;
+
+    for (const QFileInfo& cacheFile : cacheFiles)
+    {
+        totalSize += cacheFile.size();
+
+        if (totalSize > MAX_CACHE_SIZE_BYTES)
+        {
+            QFile::remove(cacheFile.absoluteFilePath());
+        }
+    }
+}
+
+}
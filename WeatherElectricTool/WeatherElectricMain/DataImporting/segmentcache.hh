@@ -0,0 +1,107 @@
+/**
+  * @file segmentcache.hh declares the SegmentCache class, which is used to
+  * store fetched data on disk between runs.
+  * @date 16.10.2026
+  */
+
+#ifndef SEGMENTCACHE_HH
+#define SEGMENTCACHE_HH
+
+#include "dataimporter.hh"
+#include "intervalset.hh"
+
+#include <QString>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The SegmentCacheEntry struct stores the cached data of a single
+ * source, data type and location, along with the time ranges it covers.
+ * Data old enough to never change again is covered by settledCoverage. More
+ * recent data is covered by recentCoverage, which is only trusted for a
+ * while after recentFetchedAtSecs.
+ */
+struct SegmentCacheEntry
+{
+    std::string unitOfMeasurement;
+    IntervalSet settledCoverage;
+    IntervalSet recentCoverage;
+    qint64 recentFetchedAtSecs;
+    TimeSeries data;
+};
+
+/**
+ * @brief The SegmentCache class reads and writes SegmentCacheEntries as
+ * compact binary files in a cache directory, one file per source, data type
+ * and location. The least recently used files are deleted when the
+ * directory grows too large.
+ */
+class SegmentCache
+{
+public:
+    /**
+     * @brief The default constructor. Uses the application's cache directory.
+     */
+    SegmentCache();
+
+    /**
+     * @brief readEntry reads the cached entry of the given data.
+     * @param sourceName: The name of the source the data is from
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @param entry: The entry to read the cached data into
+     * @return True if a valid entry was found, otherwise false
+     */
+    bool readEntry(const std::string& sourceName, ApiDataType dataType,
+                   const std::string& dataLocation,
+                   SegmentCacheEntry& entry) const;
+
+    /**
+     * @brief writeEntry writes the given entry to disk, replacing any earlier
+     * entry of the same data.
+     * @param sourceName: The name of the source the data is from
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @param entry: The entry to write
+     */
+    void writeEntry(const std::string& sourceName, ApiDataType dataType,
+                    const std::string& dataLocation,
+                    const SegmentCacheEntry& entry) const;
+
+    /**
+     * @brief evictOldEntries deletes the least recently used cache files
+     * until the cache directory fits in MAX_CACHE_SIZE_BYTES. Meant to be
+     * called once after writing instead of after every single entry.
+     */
+    void evictOldEntries() const;
+
+private:
+    // Identifies segment cache files, "WESC" in ASCII
+    static const quint32 FILE_MAGIC = 0x57455343;
+
+    // Stores the version of the cache file format
+    static const quint16 FILE_VERSION = 1;
+
+    // Stores how large the cache directory is allowed to grow
+    static const qint64 MAX_CACHE_SIZE_BYTES = 64 * 1024 * 1024;
+
+    // Stores the directory the cache files are kept in
+    QString cacheDirectory_;
+
+    /**
+     * @brief entryFilePath creates the path of the cache file of the given
+     * data.
+     * @param sourceName: The name of the source the data is from
+     * @param dataType: The type of the data
+     * @param dataLocation: The location of the data
+     * @return The path of the cache file
+     */
+    QString entryFilePath(const std::string& sourceName,
+                          ApiDataType dataType,
+                          const std::string& dataLocation) const;
+};
+
+}
+
+#endif // SEGMENTCACHE_HH
@@ -0,0 +1,342 @@
+/**
+  * @file timeseries.cpp implements the TimeSeries class.
+  * @date 16.10.2026
+  */
+
+#include "timeseries.hh"
+
+namespace DataImporting
+{
+
+TimeSeries::TimeSeries() : chunks_(), chunkPositions_(), size_(0)
+{
+
+}
+
+qint64 TimeSeries::timeAt(std::size_t index) const
+{
+    std::pair<std::size_t, std::size_t> position = findChunk(index);
+
+    return chunks_[position.first]->times[position.second];
+}
+
+float TimeSeries::valueAt(std::size_t index) const
+{
+    std::pair<std::size_t, std::size_t> position = findChunk(index);
+
+    return chunks_[position.first]->values[position.second];
+}
+
+std::pair<float, float> TimeSeries::minMaxValues() const
+{
+    if (empty())
+    {
+        return { 0, 0 };
+    }
+
+    float minValue = chunks_.front()->values.front();
+    float maxValue = minValue;
+
+    for (const std::shared_ptr<Chunk>& chunk : chunks_)
+    {
+        auto minMax = std::minmax_element(chunk->values.begin(),
+                                          chunk->values.end());
+
+        minValue = std::min(minValue, *minMax.first);
+        maxValue = std::max(maxValue, *minMax.second);
+    }
+
+    return { minValue, maxValue };
+}
+
+std::size_t TimeSeries::lowerBound(qint64 secsSinceEpoch) const
+{
+    // Find the first chunk that ends at or after the time
+    auto chunkIt = std::partition_point(chunks_.begin(), chunks_.end(),
+        [secsSinceEpoch](const std::shared_ptr<Chunk>& chunk)
+    {
+        return chunk->times.back() < secsSinceEpoch;
+    });
+
+    if (chunkIt == chunks_.end())
+    {
+        return size_;
+    }
+
+    const std::vector<qint64>& times = (*chunkIt)->times;
+
+    return chunkStart(chunkIt - chunks_.begin())
+           + (std::lower_bound(times.begin(), times.end(), secsSinceEpoch)
+              - times.begin());
+}
+
+std::size_t TimeSeries::upperBound(qint64 secsSinceEpoch) const
+{
+    // Find the first chunk that ends after the time
+    auto chunkIt = std::partition_point(chunks_.begin(), chunks_.end(),
+        [secsSinceEpoch](const std::shared_ptr<Chunk>& chunk)
+    {
+        return chunk->times.back() <= secsSinceEpoch;
+    });
+
+    if (chunkIt == chunks_.end())
+    {
+        return size_;
+    }
+
+    const std::vector<qint64>& times = (*chunkIt)->times;
+
+    return chunkStart(chunkIt - chunks_.begin())
+           + (std::upper_bound(times.begin(), times.end(), secsSinceEpoch)
+              - times.begin());
+}
+
+TimeSeries TimeSeries::slice(qint64 startSecs, qint64 endSecs) const
+{
+    TimeSeries sliced;
+
+    std::size_t first = lowerBound(startSecs);
+    std::size_t last = std::max(first, upperBound(endSecs));
+
+    sliced.appendRange(*this, first, last);
+
+    return sliced;
+}
+
+TimeSeriesView TimeSeries::view(qint64 startSecs, qint64 endSecs) const
+{
+    std::size_t first = lowerBound(startSecs);
+    std::size_t last = std::max(first, upperBound(endSecs));
+
+    return TimeSeriesView(*this, first, last);
+}
+
+void TimeSeries::clear()
+{
+    chunks_.clear();
+    chunkPositions_.clear();
+    size_ = 0;
+}
+
+void TimeSeries::append(qint64 secsSinceEpoch, float value)
+{
+    // Binary searches rely on data points being in chronological order
+    Q_ASSERT_X(empty() || chunks_.back()->times.back() <= secsSinceEpoch,
+               "TimeSeries::append", "data point out of chronological order");
+
+    if (chunks_.empty() || chunks_.back()->times.size() >= MAX_CHUNK_SIZE)
+    {
+        pushChunkBack(std::make_shared<Chunk>());
+    }
+
+    Chunk& chunk = writableChunk(chunks_.size() - 1);
+
+    chunk.times.push_back(secsSinceEpoch);
+    chunk.values.push_back(value);
+    size_++;
+}
+
+void TimeSeries::append(const TimeSeries& other)
+{
+    appendRange(other, 0, other.size_);
+}
+
+void TimeSeries::prepend(const TimeSeries& other)
+{
+    // Prepending to itself would change other while it's being read
+    if (&other == this)
+    {
+        TimeSeries copy = other;
+        prepend(copy);
+        return;
+    }
+
+    Q_ASSERT_X(empty() || other.empty()
+               || other.chunks_.back()->times.back()
+                  <= chunks_.front()->times.front(),
+               "TimeSeries::prepend", "data points out of chronological order");
+
+    for (auto it = other.chunks_.rbegin(); it != other.chunks_.rend(); it++)
+    {
+        const Chunk& otherChunk = **it;
+        std::size_t otherChunkSize = otherChunk.times.size();
+
+        // Copy small chunks into the first chunk to avoid fragmenting
+        if (!chunks_.empty()
+            && canMerge(otherChunkSize, chunks_.front()->times.size()))
+        {
+            Chunk& chunk = writableChunk(0);
+
+            chunk.times.insert(chunk.times.begin(), otherChunk.times.begin(),
+                               otherChunk.times.end());
+            chunk.values.insert(chunk.values.begin(),
+                                otherChunk.values.begin(),
+                                otherChunk.values.end());
+
+            chunkPositions_.front() -= otherChunkSize;
+        }
+        else
+        {
+            pushChunkFront(*it);
+        }
+    }
+
+    size_ += other.size_;
+}
+
+void TimeSeries::replaceRange(qint64 startSecs, qint64 endSecs,
+                              const TimeSeries& other)
+{
+    std::size_t first = lowerBound(startSecs);
+    std::size_t last = std::max(first, upperBound(endSecs));
+
+    std::size_t otherFirst = other.lowerBound(startSecs);
+    std::size_t otherLast = std::max(otherFirst, other.upperBound(endSecs));
+
+    // Only the chunks at the edges of the range get copied, the rest are
+    // shared
+    TimeSeries replaced;
+
+    replaced.appendRange(*this, 0, first);
+    replaced.appendRange(other, otherFirst, otherLast);
+    replaced.appendRange(*this, last, size_);
+
+    *this = std::move(replaced);
+}
+
+std::pair<std::size_t, std::size_t> TimeSeries::findChunk(
+    std::size_t index) const
+{
+    qint64 position = chunkPositions_.front() + (qint64)index;
+
+    std::size_t chunkIndex = std::upper_bound(chunkPositions_.begin(),
+                                              chunkPositions_.end(),
+                                              position)
+                             - chunkPositions_.begin() - 1;
+
+    return { chunkIndex, position - chunkPositions_[chunkIndex] };
+}
+
+std::size_t TimeSeries::chunkStart(std::size_t chunkIndex) const
+{
+    return chunkPositions_[chunkIndex] - chunkPositions_.front();
+}
+
+TimeSeries::Chunk& TimeSeries::writableChunk(std::size_t chunkIndex)
+{
+    std::shared_ptr<Chunk>& chunk = chunks_[chunkIndex];
+
+    if (chunk.use_count() > 1)
+    {
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+
+    return *chunk;
+}
+
+void TimeSeries::pushChunkBack(const std::shared_ptr<Chunk>& chunk)
+{
+    if (chunks_.empty())
+    {
+        chunkPositions_.push_back(0);
+    }
+    else
+    {
+        chunkPositions_.push_back(chunkPositions_.back()
+                                  + chunks_.back()->times.size());
+    }
+
+    chunks_.push_back(chunk);
+}
+
+void TimeSeries::pushChunkFront(const std::shared_ptr<Chunk>& chunk)
+{
+    if (chunks_.empty())
+    {
+        chunkPositions_.push_front(0);
+    }
+    else
+    {
+        chunkPositions_.push_front(chunkPositions_.front()
+                                   - chunk->times.size());
+    }
+
+    chunks_.push_front(chunk);
+}
+
+bool TimeSeries::canMerge(std::size_t firstSize, std::size_t secondSize)
+{
+    return firstSize + secondSize <= MAX_CHUNK_SIZE
+           && std::min(firstSize, secondSize) < MAX_CHUNK_SIZE / 2;
+}
+
+void TimeSeries::appendRange(const TimeSeries& other, std::size_t first,
+                             std::size_t last)
+{
+    if (first >= last)
+    {
+        return;
+    }
+
+    // Appending from itself would change other while it's being read
+    if (&other == this)
+    {
+        TimeSeries copy = other;
+        appendRange(copy, first, last);
+        return;
+    }
+
+    Q_ASSERT_X(empty() || chunks_.back()->times.back() <= other.timeAt(first),
+               "TimeSeries::appendRange",
+               "data points out of chronological order");
+
+    std::pair<std::size_t, std::size_t> position = other.findChunk(first);
+    std::size_t remaining = last - first;
+
+    for (std::size_t k = position.first; remaining > 0; k++)
+    {
+        const std::shared_ptr<Chunk>& otherChunk = other.chunks_[k];
+
+        std::size_t begin = position.second;
+        std::size_t end = std::min(otherChunk->times.size(),
+                                   begin + remaining);
+        std::size_t count = end - begin;
+
+        // Copy small parts into the last chunk to avoid fragmenting
+        if (!chunks_.empty()
+            && canMerge(chunks_.back()->times.size(), count))
+        {
+            Chunk& chunk = writableChunk(chunks_.size() - 1);
+
+            chunk.times.insert(chunk.times.end(),
+                               otherChunk->times.begin() + begin,
+                               otherChunk->times.begin() + end);
+            chunk.values.insert(chunk.values.end(),
+                                otherChunk->values.begin() + begin,
+                                otherChunk->values.begin() + end);
+        }
+        // Share whole chunks
+        else if (count == otherChunk->times.size())
+        {
+            pushChunkBack(otherChunk);
+        }
+        // Copy the used part of chunks at the edges of the range
+        else
+        {
+            std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+
+            chunk->times.assign(otherChunk->times.begin() + begin,
+                                otherChunk->times.begin() + end);
+            chunk->values.assign(otherChunk->values.begin() + begin,
+                                 otherChunk->values.begin() + end);
+
+            pushChunkBack(chunk);
+        }
+
+        size_ += count;
+        remaining -= count;
+        position.second = 0;
+    }
+}
+
+}
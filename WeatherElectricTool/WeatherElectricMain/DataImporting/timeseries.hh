@@ -0,0 +1,429 @@
+/**
+  * @file timeseries.hh declares the TimeSeries class, which is used to store
+  * time series data compactly.
+  * @date 16.10.2026
+  */
+
+#ifndef TIMESERIES_HH
+#define TIMESERIES_HH
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace DataImporting
+{
+
+class TimeSeriesView;
+
+/**
+ * @brief The TimeSeries class stores a chronologically ordered series of data
+ * values and the times they were taken at. Times and values are stored in
+ * separate contiguous arrays (times as seconds since the epoch) so that every
+ * data point takes only 12 bytes and can be iterated without chasing
+ * pointers.
+ *
+ * The arrays are split into chunks of at most MAX_CHUNK_SIZE data points.
+ * Chunks are shared between TimeSeries and only copied when a shared chunk
+ * is modified, so copying, slicing, appending and prepending a TimeSeries
+ * never copies more than a chunk's worth of existing data points.
+ *
+ * Data points must be added in chronological order, which is checked in
+ * debug builds, so that data points can be searched by time with binary
+ * search.
+ */
+class TimeSeries
+{
+public:
+    /**
+     * @brief The default constructor.
+     */
+    TimeSeries();
+
+    /**
+     * @brief size returns the number of data points in this TimeSeries.
+     * @return The number of data points
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief empty checks whether this TimeSeries has no data points.
+     * @return True if there are no data points, otherwise false
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief timeAt returns the time of the data point at the given index.
+     * @param index: The index of the data point
+     * @return The time of the data point in seconds since the epoch
+     */
+    qint64 timeAt(std::size_t index) const;
+
+    /**
+     * @brief valueAt returns the value of the data point at the given index.
+     * @param index: The index of the data point
+     * @return The value of the data point
+     */
+    float valueAt(std::size_t index) const;
+
+    /**
+     * @brief forEachPoint calls the given function with the time and value of
+     * every data point in the given index range, in chronological order.
+     * @param first: The index of the first data point
+     * @param last: The index after the last data point
+     * @param function: The function to call, taking a qint64 time and a float
+     * value
+     */
+    template <typename Function>
+    void forEachPoint(std::size_t first, std::size_t last,
+                      Function function) const;
+
+    /**
+     * @brief minMaxValues finds the smallest and largest value of this
+     * TimeSeries.
+     * @return The smallest value as first and the largest as second, or
+     * zeroes if this TimeSeries is empty
+     */
+    std::pair<float, float> minMaxValues() const;
+
+    /**
+     * @brief lowerBound finds the first data point taken at or after the
+     * given time.
+     * @param secsSinceEpoch: The time to search for
+     * @return The index of the data point, or size() if there is none
+     */
+    std::size_t lowerBound(qint64 secsSinceEpoch) const;
+
+    /**
+     * @brief upperBound finds the first data point taken after the given
+     * time.
+     * @param secsSinceEpoch: The time to search for
+     * @return The index of the data point, or size() if there is none
+     */
+    std::size_t upperBound(qint64 secsSinceEpoch) const;
+
+    /**
+     * @brief slice copies the data points taken between the given times.
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @return A TimeSeries with the data points inside the time range
+     */
+    TimeSeries slice(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief view creates a non-owning view of the data points taken between
+     * the given times without copying them.
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @return A view of the data points inside the time range
+     */
+    TimeSeriesView view(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief clear removes every data point from this TimeSeries.
+     */
+    void clear();
+
+    /**
+     * @brief append adds a data point to the end of this TimeSeries.
+     * @param secsSinceEpoch: The time of the data point
+     * @param value: The value of the data point
+     */
+    void append(qint64 secsSinceEpoch, float value);
+
+    /**
+     * @brief append adds every data point of another TimeSeries to the end of
+     * this one.
+     * @param other: The TimeSeries whose data points to add
+     */
+    void append(const TimeSeries& other);
+
+    /**
+     * @brief prepend adds every data point of another TimeSeries to the start
+     * of this one.
+     * @param other: The TimeSeries whose data points to add
+     */
+    void prepend(const TimeSeries& other);
+
+    /**
+     * @brief replaceRange replaces the data points taken between the given
+     * times with the data points of another TimeSeries taken between them.
+     * @param startSecs: The start of the time range, inclusive
+     * @param endSecs: The end of the time range, inclusive
+     * @param other: The TimeSeries whose data points to put in the range
+     */
+    void replaceRange(qint64 startSecs, qint64 endSecs,
+                      const TimeSeries& other);
+
+private:
+    /**
+     * @brief The Chunk struct stores a contiguous part of a TimeSeries.
+     */
+    struct Chunk
+    {
+        std::vector<qint64> times;
+        std::vector<float> values;
+    };
+
+    // Stores how many data points a chunk can hold
+    static const std::size_t MAX_CHUNK_SIZE = 4096;
+
+    // Stores the chunks in chronological order. None of them are empty.
+    std::deque<std::shared_ptr<Chunk>> chunks_;
+
+    // Stores the position of the first data point of each chunk. Positions
+    // are relative to an arbitrary origin so that prepending a chunk doesn't
+    // change the positions of the chunks after it.
+    std::deque<qint64> chunkPositions_;
+
+    // Stores the total number of data points
+    std::size_t size_;
+
+    /**
+     * @brief findChunk finds the chunk containing the data point at the given
+     * index.
+     * @param index: The index of the data point
+     * @return The index of the chunk as first and the index of the data point
+     * inside the chunk as second
+     */
+    std::pair<std::size_t, std::size_t> findChunk(std::size_t index) const;
+
+    /**
+     * @brief chunkStart returns the index of the first data point of a chunk.
+     * @param chunkIndex: The index of the chunk
+     * @return The index of the chunk's first data point in this TimeSeries
+     */
+    std::size_t chunkStart(std::size_t chunkIndex) const;
+
+    /**
+     * @brief writableChunk returns a chunk for modifying, copying it first if
+     * it's shared with another TimeSeries.
+     * @param chunkIndex: The index of the chunk
+     * @return The chunk
+     */
+    Chunk& writableChunk(std::size_t chunkIndex);
+
+    /**
+     * @brief pushChunkBack adds a chunk to the end of this TimeSeries.
+     * @param chunk: The chunk to add
+     */
+    void pushChunkBack(const std::shared_ptr<Chunk>& chunk);
+
+    /**
+     * @brief pushChunkFront adds a chunk to the start of this TimeSeries.
+     * @param chunk: The chunk to add
+     */
+    void pushChunkFront(const std::shared_ptr<Chunk>& chunk);
+
+    /**
+     * @brief canMerge checks whether two chunks should be merged into one
+     * instead of being stored separately.
+     * @param firstSize: The size of the first chunk
+     * @param secondSize: The size of the second chunk
+     * @return True if the chunks should be merged, otherwise false
+     */
+    static bool canMerge(std::size_t firstSize, std::size_t secondSize);
+
+    /**
+     * @brief appendRange adds the data points of another TimeSeries in the
+     * given index range to the end of this one. Whole chunks are shared
+     * instead of copied.
+     * @param other: The TimeSeries whose data points to add
+     * @param first: The index of the first data point to add
+     * @param last: The index after the last data point to add
+     */
+    void appendRange(const TimeSeries& other, std::size_t first,
+                     std::size_t last);
+};
+
+/**
+ * @brief The TimeSeriesView class is a non-owning view of a contiguous range
+ * of the data points of a TimeSeries. The TimeSeries must not be modified or
+ * destroyed while it's viewed.
+ */
+class TimeSeriesView
+{
+public:
+    /**
+     * @brief The default constructor.
+     * @param series: The TimeSeries to view
+     * @param first: The index of the first data point to view
+     * @param last: The index after the last data point to view
+     */
+    TimeSeriesView(const TimeSeries& series, std::size_t first,
+                   std::size_t last) :
+        series_(&series), first_(first), last_(last) {}
+
+    /**
+     * @brief size returns the number of data points in this view.
+     * @return The number of data points
+     */
+    std::size_t size() const { return last_ - first_; }
+
+    /**
+     * @brief empty checks whether this view has no data points.
+     * @return True if there are no data points, otherwise false
+     */
+    bool empty() const { return first_ == last_; }
+
+    /**
+     * @brief timeAt returns the time of the data point at the given index.
+     * @param index: The index of the data point in this view
+     * @return The time of the data point in seconds since the epoch
+     */
+    qint64 timeAt(std::size_t index) const
+    {
+        return series_->timeAt(first_ + index);
+    }
+
+    /**
+     * @brief valueAt returns the value of the data point at the given index.
+     * @param index: The index of the data point in this view
+     * @return The value of the data point
+     */
+    float valueAt(std::size_t index) const
+    {
+        return series_->valueAt(first_ + index);
+    }
+
+    /**
+     * @brief forEachPoint calls the given function with the time and value of
+     * every data point in this view, in chronological order.
+     * @param function: The function to call, taking a qint64 time and a float
+     * value
+     */
+    template <typename Function>
+    void forEachPoint(Function function) const
+    {
+        series_->forEachPoint(first_, last_, function);
+    }
+
+    /**
+     * @brief forEachDecimatedPoint calls the given function with the time and
+     * value of the smallest and largest data point in every time bucket of
+     * this view, in chronological order. Buckets are aligned to multiples of
+     * their length so that decimating adjacent views gives the same points as
+     * decimating them together.
+     * @param bucketSecs: The length of a bucket in seconds, every data point
+     * is passed if it's 1 or less
+     * @param function: The function to call, taking a qint64 time and a float
+     * value
+     */
+    template <typename Function>
+    void forEachDecimatedPoint(qint64 bucketSecs, Function function) const;
+
+private:
+    // Stores the viewed TimeSeries
+    const TimeSeries* series_;
+
+    // Stores the index range of the viewed data points
+    std::size_t first_;
+    std::size_t last_;
+};
+
+template <typename Function>
+void TimeSeries::forEachPoint(std::size_t first, std::size_t last,
+                              Function function) const
+{
+    if (first >= last)
+    {
+        return;
+    }
+
+    std::pair<std::size_t, std::size_t> position = findChunk(first);
+    std::size_t remaining = last - first;
+
+    for (std::size_t k = position.first; remaining > 0; k++)
+    {
+        const Chunk& chunk = *chunks_[k];
+        std::size_t chunkLast = std::min(chunk.times.size(),
+                                         position.second + remaining);
+
+        for (std::size_t i = position.second; i < chunkLast; i++)
+        {
+            function(chunk.times[i], chunk.values[i]);
+        }
+
+        remaining -= chunkLast - position.second;
+        position.second = 0;
+    }
+}
+
+template <typename Function>
+void TimeSeriesView::forEachDecimatedPoint(qint64 bucketSecs,
+                                           Function function) const
+{
+    if (bucketSecs <= 1)
+    {
+        forEachPoint(function);
+        return;
+    }
+
+    bool bucketEmpty = true;
+    qint64 bucket = 0;
+    qint64 minTime = 0;
+    qint64 maxTime = 0;
+    float minValue = 0;
+    float maxValue = 0;
+
+    // Passes the smallest and largest data point of the bucket in order
+    auto passBucket = [&]()
+    {
+        if (minTime == maxTime)
+        {
+            function(minTime, minValue);
+        }
+        else if (minTime < maxTime)
+        {
+            function(minTime, minValue);
+            function(maxTime, maxValue);
+        }
+        else
+        {
+            function(maxTime, maxValue);
+            function(minTime, minValue);
+        }
+    };
+
+    forEachPoint([&](qint64 time, float value)
+    {
+        // Round down, also for times before the epoch
+        qint64 pointBucket = time / bucketSecs
+                             - (time % bucketSecs < 0 ? 1 : 0);
+
+        if (bucketEmpty || pointBucket != bucket)
+        {
+            if (!bucketEmpty)
+            {
+                passBucket();
+            }
+
+            bucketEmpty = false;
+            bucket = pointBucket;
+            minTime = maxTime = time;
+            minValue = maxValue = value;
+        }
+        else if (value < minValue)
+        {
+            minTime = time;
+            minValue = value;
+        }
+        else if (value > maxValue)
+        {
+            maxTime = time;
+            maxValue = value;
+        }
+    });
+
+    if (!bucketEmpty)
+    {
+        passBucket();
+    }
+}
+
+}
+
+#endif // TIMESERIES_HH
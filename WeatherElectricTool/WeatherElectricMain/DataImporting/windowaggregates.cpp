@@ -0,0 +1,229 @@
+/**
+  * @file windowaggregates.cpp implements the WindowAggregates class.
+  * @date 16.10.2026
+  */
+
+#include "windowaggregates.hh"
+
+namespace DataImporting
+{
+
+// Energies are given in value times hours
+static const double SECONDS_PER_HOUR = 60 * 60;
+
+WindowAggregates::WindowAggregates() :
+    valueSums_(1, CompensatedSum{ 0, 0 }), energySums_(), minBlocks_(),
+    maxBlocks_()
+{
+
+}
+
+void WindowAggregates::update(const TimeSeries& series, qint64 changedSecs)
+{
+    // Aggregates before the first changed data point stay the same
+    std::size_t first = std::min(series.lowerBound(changedSecs),
+                                 energySums_.size());
+
+    valueSums_.resize(first + 1);
+    energySums_.resize(first);
+
+    CompensatedSum valueSum = valueSums_.back();
+    CompensatedSum energySum = first > 0 ? energySums_.back()
+                                         : CompensatedSum{ 0, 0 };
+
+    // Start from the data point before the first changed one, since the
+    // energy between them has changed too
+    std::size_t index = first > 0 ? first - 1 : 0;
+    qint64 previousTime = 0;
+    float previousValue = 0;
+
+    series.forEachPoint(index, series.size(),
+                        [&](qint64 time, float value)
+    {
+        if (index >= first)
+        {
+            add(valueSum, value);
+            valueSums_.push_back(valueSum);
+
+            if (index > 0)
+            {
+                add(energySum, (double(previousValue) + value) / 2
+                               * (time - previousTime) / SECONDS_PER_HOUR);
+            }
+
+            energySums_.push_back(energySum);
+        }
+
+        previousTime = time;
+        previousValue = value;
+        index++;
+    });
+
+    updateBlocks(series, first / BLOCK_SIZE);
+}
+
+void WindowAggregates::clear()
+{
+    valueSums_.assign(1, CompensatedSum{ 0, 0 });
+    energySums_.clear();
+    minBlocks_.clear();
+    maxBlocks_.clear();
+}
+
+WindowSummary WindowAggregates::summarize(const TimeSeries& series,
+                                          qint64 startSecs,
+                                          qint64 endSecs) const
+{
+    WindowSummary summary = WindowSummary();
+
+    if (startSecs > endSecs)
+    {
+        return summary;
+    }
+
+    std::size_t first = series.lowerBound(startSecs);
+    std::size_t last = series.upperBound(endSecs);
+
+    if (first >= last)
+    {
+        return summary;
+    }
+
+    Q_ASSERT_X(last <= energySums_.size(), "WindowAggregates::summarize",
+               "aggregates must be updated when the series changes");
+
+    summary.count = last - first;
+    summary.sum = valueSums_[last].value() - valueSums_[first].value();
+    summary.energy = energySums_[last - 1].value()
+                     - energySums_[first].value();
+    summary.minValue = series.valueAt(first);
+    summary.maxValue = summary.minValue;
+
+    // The blocks that are entirely inside the window
+    std::size_t firstBlock = (first + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::size_t endBlock = last / BLOCK_SIZE;
+
+    if (firstBlock >= endBlock)
+    {
+        scanMinMax(series, first, last, summary);
+        return summary;
+    }
+
+    // Two overlapping runs of 2^level blocks cover the whole blocks
+    std::size_t level = 0;
+
+    while ((std::size_t(2) << level) <= endBlock - firstBlock)
+    {
+        level++;
+    }
+
+    std::size_t secondRun = endBlock - (std::size_t(1) << level);
+
+    summary.minValue = std::min(summary.minValue,
+                                std::min(minBlocks_[level][firstBlock],
+                                         minBlocks_[level][secondRun]));
+    summary.maxValue = std::max(summary.maxValue,
+                                std::max(maxBlocks_[level][firstBlock],
+                                         maxBlocks_[level][secondRun]));
+
+    // Go through the data points of the partial blocks at the edges
+    scanMinMax(series, first, firstBlock * BLOCK_SIZE, summary);
+    scanMinMax(series, endBlock * BLOCK_SIZE, last, summary);
+
+    return summary;
+}
+
+void WindowAggregates::add(CompensatedSum& total, double value)
+{
+    double corrected = value - total.compensation;
+    double sum = total.sum + corrected;
+
+    total.compensation = (sum - total.sum) - corrected;
+    total.sum = sum;
+}
+
+void WindowAggregates::updateBlocks(const TimeSeries& series,
+                                    std::size_t firstBlock)
+{
+    std::size_t size = energySums_.size();
+    std::size_t blockCount = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::size_t levelCount = 0;
+
+    while ((std::size_t(1) << levelCount) <= blockCount)
+    {
+        levelCount++;
+    }
+
+    minBlocks_.resize(levelCount);
+    maxBlocks_.resize(levelCount);
+
+    if (levelCount == 0)
+    {
+        return;
+    }
+
+    // The lowest level is made of data points
+    firstBlock = std::min(firstBlock, minBlocks_[0].size());
+    minBlocks_[0].resize(firstBlock);
+    maxBlocks_[0].resize(firstBlock);
+
+    std::size_t index = firstBlock * BLOCK_SIZE;
+
+    series.forEachPoint(index, size, [&](qint64, float value)
+    {
+        if (index % BLOCK_SIZE == 0)
+        {
+            minBlocks_[0].push_back(value);
+            maxBlocks_[0].push_back(value);
+        }
+        else
+        {
+            minBlocks_[0].back() = std::min(minBlocks_[0].back(), value);
+            maxBlocks_[0].back() = std::max(maxBlocks_[0].back(), value);
+        }
+
+        index++;
+    });
+
+    // The others are made of two runs of the level below
+    for (std::size_t level = 1; level < levelCount; level++)
+    {
+        std::size_t runLength = std::size_t(1) << level;
+        std::size_t halfRun = runLength / 2;
+
+        // Runs that end before the first changed block stay the same
+        std::size_t kept = firstBlock >= runLength - 1
+                           ? firstBlock - (runLength - 1) : 0;
+        kept = std::min(kept, minBlocks_[level].size());
+
+        std::vector<float>& minRuns = minBlocks_[level];
+        std::vector<float>& maxRuns = maxBlocks_[level];
+        const std::vector<float>& lowerMinRuns = minBlocks_[level - 1];
+        const std::vector<float>& lowerMaxRuns = maxBlocks_[level - 1];
+
+        minRuns.resize(kept);
+        maxRuns.resize(kept);
+
+        for (std::size_t block = kept; block + runLength <= blockCount;
+             block++)
+        {
+            minRuns.push_back(std::min(lowerMinRuns[block],
+                                       lowerMinRuns[block + halfRun]));
+            maxRuns.push_back(std::max(lowerMaxRuns[block],
+                                       lowerMaxRuns[block + halfRun]));
+        }
+    }
+}
+
+void WindowAggregates::scanMinMax(const TimeSeries& series,
+                                  std::size_t first, std::size_t last,
+                                  WindowSummary& summary)
+{
+    series.forEachPoint(first, last, [&summary](qint64, float value)
+    {
+        summary.minValue = std::min(summary.minValue, value);
+        summary.maxValue = std::max(summary.maxValue, value);
+    });
+}
+
+}
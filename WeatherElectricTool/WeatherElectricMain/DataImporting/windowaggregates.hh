@@ -0,0 +1,154 @@
+/**
+  * @file windowaggregates.hh declares the WindowAggregates class, which is
+  * used to summarize any time window of a time series in constant time.
+  * @date 16.10.2026
+  */
+
+#ifndef WINDOWAGGREGATES_HH
+#define WINDOWAGGREGATES_HH
+
+#include "timeseries.hh"
+
+#include <vector>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The WindowSummary struct summarizes the data points of a time
+ * window.
+ */
+struct WindowSummary
+{
+    // The sum of the values of the data points
+    double sum;
+
+    // The smallest and largest value of the data points
+    float minValue;
+    float maxValue;
+
+    // The integral of the values over time between the data points, in value
+    // times hours (MWh for values in MW). Consecutive data points are joined
+    // with straight lines.
+    double energy;
+
+    // The number of data points, the other members are unset if it's 0
+    qint64 count;
+
+    /**
+     * @brief mean returns the mean value of the summarized data points.
+     * @return The mean value, or 0 if there are no data points
+     */
+    double mean() const { return count > 0 ? sum / count : 0; }
+};
+
+/**
+ * @brief The WindowAggregates class stores running aggregates of a
+ * TimeSeries so that any time window of it can be summarized without going
+ * through its data points. Sums and energies are kept as prefix sums over the
+ * data points, accumulated with Kahan summation so that long series don't
+ * lose precision. Minimums and maximums are kept in sparse tables over blocks
+ * of BLOCK_SIZE data points, so a query only looks at the at most
+ * 2 * BLOCK_SIZE data points at the window's ends and the tables take little
+ * memory even for long series.
+ *
+ * Finding the window takes O(log n) time and summarizing it O(1). Updating
+ * recalculates the aggregates from the first changed data point onwards, so
+ * data added to the end of the series is cheap to take in.
+ *
+ * The aggregates have to be updated whenever the TimeSeries changes.
+ */
+class WindowAggregates
+{
+public:
+    /**
+     * @brief The default constructor.
+     */
+    WindowAggregates();
+
+    /**
+     * @brief update recalculates the aggregates of every data point taken at
+     * or after the given time from a TimeSeries. Has to be called whenever
+     * data points have been changed, added or removed at or after the time.
+     * @param series: The TimeSeries the aggregates are made of
+     * @param changedSecs: The time of the earliest changed data point
+     */
+    void update(const TimeSeries& series, qint64 changedSecs);
+
+    /**
+     * @brief clear removes every aggregate.
+     */
+    void clear();
+
+    /**
+     * @brief summarize summarizes the data points of a TimeSeries taken in the
+     * given time window.
+     * @param series: The TimeSeries the aggregates are made of
+     * @param startSecs: The start of the time window, inclusive
+     * @param endSecs: The end of the time window, inclusive
+     * @return The summary of the data points in the time window
+     */
+    WindowSummary summarize(const TimeSeries& series, qint64 startSecs,
+                            qint64 endSecs) const;
+
+private:
+    /**
+     * @brief The CompensatedSum struct stores a Kahan sum: the running total
+     * and the negated low-order part lost from it.
+     */
+    struct CompensatedSum
+    {
+        double sum;
+        double compensation;
+
+        /**
+         * @brief value returns the compensated value of the sum.
+         * @return The value of the sum
+         */
+        double value() const { return sum - compensation; }
+    };
+
+    // Stores how many data points each block of the sparse tables covers
+    static const std::size_t BLOCK_SIZE = 64;
+
+    // Stores the sum of the values of the first i data points at index i
+    std::vector<CompensatedSum> valueSums_;
+
+    // Stores the energy between the first i + 1 data points at index i
+    std::vector<CompensatedSum> energySums_;
+
+    // Stores the minimums and maximums of the blocks. Level j stores the
+    // minimum or maximum of the 2^j blocks starting from each block.
+    std::vector<std::vector<float>> minBlocks_;
+    std::vector<std::vector<float>> maxBlocks_;
+
+    /**
+     * @brief add adds a value to a Kahan sum.
+     * @param total: The sum to add to
+     * @param value: The value to add
+     */
+    static void add(CompensatedSum& total, double value);
+
+    /**
+     * @brief updateBlocks recalculates the sparse tables of every block from
+     * the given one onwards.
+     * @param series: The TimeSeries the aggregates are made of
+     * @param firstBlock: The index of the first changed block
+     */
+    void updateBlocks(const TimeSeries& series, std::size_t firstBlock);
+
+    /**
+     * @brief scanMinMax updates a summary's minimum and maximum with the data
+     * points in the given index range.
+     * @param series: The TimeSeries the aggregates are made of
+     * @param first: The index of the first data point
+     * @param last: The index after the last data point
+     * @param summary: The summary to update
+     */
+    static void scanMinMax(const TimeSeries& series, std::size_t first,
+                           std::size_t last, WindowSummary& summary);
+};
+
+}
+
+#endif // WINDOWAGGREGATES_HH
@@ -10,79 +10,326 @@ namespace DataImporting
 {
 
 XmlDataImporter::XmlDataImporter(QObject* parent) : DataImporter(parent),
-    xmlFetcher_()
+    xmlFetcher_(), parserThread_(), parser_(nullptr), streamGenerations_(),
+    cancelledStreams_(), lastGeneration_(0)
 {
-    // Parse XML documents automatically when they're fetched
+    // The types passed between the threads need to be known to Qt
+    qRegisterMetaType<std::string>();
+    qRegisterMetaType<std::vector<ParsedDataPoint>>();
+
+    // Parse XML data automatically as it arrives
+    connect(&xmlFetcher_, &XmlFetcher::xmlDataReceived,
+            this, &XmlDataImporter::parseXmlData);
     connect(&xmlFetcher_, &XmlFetcher::xmlFetched,
-            this, &XmlDataImporter::parseXml);
+            this, &XmlDataImporter::finishXml);
+    connect(&xmlFetcher_, &XmlFetcher::xmlDiscarded,
+            this, &XmlDataImporter::discardXml);
+    connect(&xmlFetcher_, &XmlFetcher::xmlCancelled,
+            this, &XmlDataImporter::cancelXml);
+
+    // A failed fetch is dropped like a cancelled one so that its time period
+    // stays unfetched and can be requested again
+    connect(&xmlFetcher_, &XmlFetcher::xmlFailed,
+            this, &XmlDataImporter::cancelXml);
+}
+
+XmlDataImporter::~XmlDataImporter()
+{
+    // Unfinished parsing is thrown away, the parser doesn't use the importer
+    // so it can be deleted once its thread has stopped
+    parserThread_.quit();
+    parserThread_.wait();
+
+    delete parser_;
+}
+
+void XmlDataImporter::setVisibleTimeRange(const QDateTime& startTime,
+                                          const QDateTime& endTime)
+{
+    xmlFetcher_.setVisibleTimeRange(startTime, endTime);
+}
+
+void XmlDataImporter::cancelFetchesOutside(const QDateTime& startTime,
+                                           const QDateTime& endTime)
+{
+    xmlFetcher_.cancelFetchesOutside(startTime, endTime);
+}
+
+void XmlDataImporter::parseXmlData(const QByteArray& xmlData,
+                                   const std::string& url)
+{
+    // The URL is being fetched again, so its generation is needed
+    cancelledStreams_.erase(url);
+
+    startParser();
+
+    emit xmlDataHandedOff(xmlData, url, getGeneration(url));
+}
+
+void XmlDataImporter::finishXml(const std::string& url)
+{
+    cancelledStreams_.erase(url);
+
+    startParser();
+
+    emit xmlFinishHandedOff(url, getGeneration(url));
+}
+
+void XmlDataImporter::discardXml(const std::string& url)
+{
+    cancelledStreams_.erase(url);
+
+    abandonStream(url);
+
+    xmlDiscarded(url);
+}
+
+void XmlDataImporter::cancelXml(const std::string& url)
+{
+    abandonStream(url);
+
+    // Without a parser nothing of the stream can arrive, otherwise the
+    // generation is kept until the parser has thrown the stream away
+    if (parser_ == nullptr)
+    {
+        streamGenerations_.erase(url);
+    }
+    else
+    {
+        cancelledStreams_.insert(url);
+    }
+
+    xmlCancelled(url);
+}
+
+void XmlDataImporter::storeDataPoints(
+    const std::vector<ParsedDataPoint>& dataPoints, const std::string& url,
+    quint64 generation)
+{
+    // Data points of an abandoned stream were parsed before it was abandoned
+    if (generation != getGeneration(url))
+    {
+        return;
+    }
+
+    xmlDataPointsParsed(dataPoints, url);
+}
+
+void XmlDataImporter::completeXml(const std::string& url, quint64 generation)
+{
+    if (generation != getGeneration(url))
+    {
+        return;
+    }
+
+    // Nothing of the finished stream can arrive anymore
+    streamGenerations_.erase(url);
+
+    xmlParsed(url);
+}
+
+void XmlDataImporter::forgetDroppedXml(const std::string& url,
+                                       quint64 generation)
+{
+    // The URL may have been fetched again or cancelled again since
+    if (generation != getGeneration(url) || cancelledStreams_.erase(url) == 0)
+    {
+        return;
+    }
+
+    streamGenerations_.erase(url);
+}
+
+void XmlDataImporter::startParser()
+{
+    if (parser_ != nullptr)
+    {
+        return;
+    }
+
+    parser_ = new XmlParser(getRecordDepth(), createRecordParser());
+    parser_->moveToThread(&parserThread_);
+
+    // The parser lives in another thread, so these connections are queued
+    // and keep the order the signals were sent in
+    connect(this, &XmlDataImporter::xmlDataHandedOff,
+            parser_, &XmlParser::parseXmlData);
+    connect(this, &XmlDataImporter::xmlFinishHandedOff,
+            parser_, &XmlParser::finishXml);
+    connect(this, &XmlDataImporter::xmlDropHandedOff,
+            parser_, &XmlParser::dropXml);
+    connect(parser_, &XmlParser::dataPointsParsed,
+            this, &XmlDataImporter::storeDataPoints);
+    connect(parser_, &XmlParser::xmlFinished,
+            this, &XmlDataImporter::completeXml);
+    connect(parser_, &XmlParser::xmlDropped,
+            this, &XmlDataImporter::forgetDroppedXml);
+
+    parserThread_.start();
+}
+
+quint64 XmlDataImporter::getGeneration(const std::string& url) const
+{
+    auto generationIt = streamGenerations_.find(url);
+
+    return generationIt != streamGenerations_.end() ? generationIt->second : 0;
+}
+
+void XmlDataImporter::abandonStream(const std::string& url)
+{
+    lastGeneration_++;
+    streamGenerations_[url] = lastGeneration_;
+
+    if (parser_ != nullptr)
+    {
+        emit xmlDropHandedOff(url, lastGeneration_);
+    }
+}
+
+/**
+ * @brief parseDigits parses a fixed number of decimal digits from the given
+ * position of a string.
+ * @param string: The string to parse the digits from
+ * @param position: The index of the first digit
+ * @param digitCount: How many digits to parse
+ * @return The parsed number
+ * @exception std::invalid_argument: Thrown when a character is not a digit
+ */
+static int parseDigits(QStringView string, int position, int digitCount)
+{
+    int number = 0;
+
+    for (int i = position; i < position + digitCount; i++)
+    {
+        unsigned int digit = string[i].unicode() - '0';
+
+        if (digit > 9)
+        {
+            throw std::invalid_argument("Expected a digit in date/time string");
+        }
+
+        number = number * 10 + digit;
+    }
+
+    return number;
 }
 
-QDateTime XmlDataImporter::dateTimeFromApiString(
-    const std::string& dateTimeString)
+/**
+ * @brief daysFromCivil counts the days from 1970-01-01 to the given date in
+ * the proleptic Gregorian calendar.
+ * @param year: The year of the date
+ * @param month: The month of the date (1-12)
+ * @param day: The day of the date (1-31)
+ * @return The number of days since 1970-01-01
+ */
+static qint64 daysFromCivil(int year, int month, int day)
 {
-    unsigned int charIndex = 0;
-    unsigned int componentIndex = 0;
+    // Count years from March so that the leap day is the last day of a year
+    year -= month <= 2;
+
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5
+                          + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100
+                         + dayOfYear;
+
+    return era * 146097 + dayOfEra - 719468;
+}
 
-    char delimiter = '-';
-    char sectionEndChar = 'T';
+qint64 XmlDataImporter::secsSinceEpochFromApiString(
+    QStringView dateTimeString)
+{
+    // Dates and times are given by the API in a fixed width string:
+    // YYYY-MM-DDThh:mm:ss followed by optional fractional seconds and an
+    // optional timezone designator
+    if (dateTimeString.size() < DATE_TIME_STRING_LENGTH
+        || dateTimeString[4] != '-' || dateTimeString[7] != '-'
+        || dateTimeString[10] != 'T' || dateTimeString[13] != ':'
+        || dateTimeString[16] != ':')
+    {
+        throw std::invalid_argument("Invalid date/time string");
+    }
 
-    // Dates and times are given by the API in a string containing 6
-    // components: year, month, day, hours, minutes, seconds
-    // The string's format is {year}-{month}-{day}T{hours}:{minutes}:{seconds}Z
-    std::string dateTimeComponents[DATE_TIME_COMPONENT_COUNT];
+    const int year = parseDigits(dateTimeString, 0, 4);
+    const int month = parseDigits(dateTimeString, 5, 2);
+    const int day = parseDigits(dateTimeString, 8, 2);
+    const int hours = parseDigits(dateTimeString, 11, 2);
+    const int minutes = parseDigits(dateTimeString, 14, 2);
+    const int seconds = parseDigits(dateTimeString, 17, 2);
 
-    // Separate all the components of the date and time
-    while (charIndex < dateTimeString.length() &&
-           componentIndex < DATE_TIME_COMPONENT_COUNT)
+    if (month < 1 || month > 12 || day < 1 || day > 31
+        || hours > 23 || minutes > 59 || seconds > 60)
     {
-        char currentChar = dateTimeString[charIndex];
+        throw std::invalid_argument("Date/time component out of range");
+    }
+
+    int position = DATE_TIME_STRING_LENGTH;
+    const int length = dateTimeString.size();
 
-        if (currentChar == delimiter)
+    // Skip fractional seconds
+    if (position < length && dateTimeString[position] == '.')
+    {
+        position++;
+
+        while (position < length && dateTimeString[position].isDigit())
         {
-            // Delimiter reached: this component has been parsed, parse the
-            // next one
-            componentIndex++;
+            position++;
         }
-        else if (currentChar == sectionEndChar)
+    }
+
+    int offsetSeconds = 0;
+
+    // Parse timezone designator, no designator is treated as UTC
+    if (position < length && dateTimeString[position] == 'Z')
+    {
+        position++;
+    }
+    else if (position < length && (dateTimeString[position] == '+'
+                                   || dateTimeString[position] == '-'))
+    {
+        const int sign = dateTimeString[position] == '-' ? -1 : 1;
+        position++;
+
+        if (length - position < 2)
         {
-            // Section end character reached: stop parsing date, start parsing
-            // time
-            sectionEndChar = 'Z';
-            delimiter = ':';
+            throw std::invalid_argument("Invalid timezone offset");
+        }
+
+        int offsetHours = parseDigits(dateTimeString, position, 2);
+        int offsetMinutes = 0;
+        position += 2;
 
-            componentIndex++;
+        // Minutes can be given as +hh:mm, +hhmm or left out as +hh
+        if (position < length && dateTimeString[position] == ':')
+        {
+            position++;
         }
-        else
+
+        if (length - position >= 2)
         {
-            // Append parsed characters to the current component
-            dateTimeComponents[componentIndex] += dateTimeString[charIndex];
+            offsetMinutes = parseDigits(dateTimeString, position, 2);
+            position += 2;
         }
 
-        charIndex++;
+        offsetSeconds = sign * (offsetHours * 60 + offsetMinutes) * 60;
     }
 
-    int dateTimeComponentsInt[dateTimeComponents->length()];
-
-    // Convert component strings into integers (exception handling left to
-    // caller)
-    for (int i = 0; i < DATE_TIME_COMPONENT_COUNT; i++)
+    if (position != length)
     {
-        dateTimeComponentsInt[i] = std::stoi(dateTimeComponents[i]);
+        throw std::invalid_argument("Unexpected characters in date/time");
     }
 
-    return QDateTime(
-        QDate(dateTimeComponentsInt[0],
-              dateTimeComponentsInt[1],
-              dateTimeComponentsInt[2]),
-        QTime(dateTimeComponentsInt[3],
-              dateTimeComponentsInt[4],
-              dateTimeComponentsInt[5]));
+    return daysFromCivil(year, month, day) * 24 * 60 * 60
+           + hours * 60 * 60 + minutes * 60 + seconds - offsetSeconds;
 }
 
 std::string XmlDataImporter::dateTimeToApiString(const QDateTime& dateTime)
 {
-    const QDate& date = dateTime.date();
-    const QTime& time = dateTime.time();
+    // API date/time strings are in UTC
+    const QDateTime utcDateTime = dateTime.toUTC();
+    const QDate& date = utcDateTime.date();
+    const QTime& time = utcDateTime.time();
 
     std::string dateTimeComponents[DATE_TIME_COMPONENT_COUNT] =
     {
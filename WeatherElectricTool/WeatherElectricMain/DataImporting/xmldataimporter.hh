@@ -10,15 +10,29 @@
 
 #include "dataimporter.hh"
 #include "xmlfetcher.hh"
+#include "xmlparser.hh"
 
-#include <QtXml>
+#include <QThread>
+
+#include <map>
+#include <set>
 
 namespace DataImporting
 {
 
 /**
  * @brief The XmlDataImporter class is an abstract base class used by data
- * importers that import their data in XML format.
+ * importers that import their data in XML format. The XML data is parsed as a
+ * stream while it arrives and split into records: elements at a fixed depth
+ * whose child elements hold the values of a single data point.
+ *
+ * Parsing happens in a thread of its own, started when the first data
+ * arrives, so that large replies don't block the GUI thread. Everything
+ * received from xmlFetcher_ is handed to the parser thread in the order it
+ * was received and the parsed data points come back in the same order, so
+ * the data points of a URL are always passed on before it's finished.
+ * Results of a URL whose data was discarded or cancelled before they came
+ * back are ignored.
  */
 class XmlDataImporter : public DataImporter
 {
@@ -26,20 +40,121 @@ class XmlDataImporter : public DataImporter
 
 protected slots:
     /**
-     * @brief parseXml is called when XML data has been received from
-     * xmlFetcher_. Abstract method: implement in inheriting class.
-     * @param xmlData: The fetched XML data
+     * @brief parseXmlData is called when a chunk of XML data has been received
+     * from xmlFetcher_. Hands the data to the parser thread.
+     * @param xmlData: The received chunk of XML data
+     * @param url: The URL the data is being fetched from
+     */
+    void parseXmlData(const QByteArray& xmlData, const std::string& url);
+
+    /**
+     * @brief finishXml is called when all the XML data from a URL has been
+     * received from xmlFetcher_. Tells the parser thread to finish the URL
+     * once it has parsed everything received before.
+     * @param url: The URL the data was fetched from
+     */
+    void finishXml(const std::string& url);
+
+    /**
+     * @brief discardXml is called when the XML data received from a URL so
+     * far has to be thrown away because the request is sent again.
+     * @param url: The URL the data was being fetched from
+     */
+    void discardXml(const std::string& url);
+
+    /**
+     * @brief cancelXml is called when the fetch of a URL has been cancelled
+     * or has failed in xmlFetcher_.
+     * @param url: The URL the data was being fetched from
+     */
+    void cancelXml(const std::string& url);
+
+    /**
+     * @brief storeDataPoints is called when the parser thread has parsed the
+     * data points of a chunk of XML data.
+     * @param dataPoints: The parsed data points
+     * @param url: The URL the data is being fetched from
+     * @param generation: The generation of the URL's stream the data points
+     * were parsed from
+     */
+    void storeDataPoints(const std::vector<ParsedDataPoint>& dataPoints,
+                         const std::string& url, quint64 generation);
+
+    /**
+     * @brief completeXml is called when the parser thread has parsed all the
+     * data received from a URL.
+     * @param url: The URL the data was fetched from
+     * @param generation: The generation of the URL's stream that was finished
+     */
+    void completeXml(const std::string& url, quint64 generation);
+
+    /**
+     * @brief forgetDroppedXml is called when the parser thread has thrown
+     * away the stream of a URL. The generation of a cancelled stream isn't
+     * needed after that, since nothing parsed from it can arrive anymore.
+     * @param url: The URL the data was being fetched from
+     * @param generation: The generation the URL's stream was abandoned for
+     */
+    void forgetDroppedXml(const std::string& url, quint64 generation);
+
+signals:
+    /**
+     * @brief The xmlDataHandedOff signal hands a chunk of XML data over to
+     * the parser thread.
+     * @param xmlData: The received chunk of XML data
+     * @param url: The URL the data is being fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void xmlDataHandedOff(const QByteArray& xmlData, const std::string& url,
+                          quint64 generation);
+
+    /**
+     * @brief The xmlFinishHandedOff signal tells the parser thread that all
+     * the XML data of a URL has been received.
      * @param url: The URL the data was fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void xmlFinishHandedOff(const std::string& url, quint64 generation);
+
+    /**
+     * @brief The xmlDropHandedOff signal tells the parser thread to throw
+     * away the stream of a URL.
+     * @param url: The URL the data was being fetched from
+     * @param generation: The generation the URL's stream was abandoned for
+     */
+    void xmlDropHandedOff(const std::string& url, quint64 generation);
+
+public:
+    /**
+     * @brief The default destructor. Stops the parser thread.
+     */
+    virtual ~XmlDataImporter();
+
+    /**
+     * @brief setVisibleTimeRange passes the time range currently shown to the
+     * user on to xmlFetcher_ so that data inside it is fetched first.
+     * @param startTime: The start of the visible time range
+     * @param endTime: The end of the visible time range
      */
-    virtual void parseXml(const QDomDocument& xmlData,
-                          const std::string& url) = 0;
+    void setVisibleTimeRange(const QDateTime& startTime,
+                             const QDateTime& endTime) override;
+
+    /**
+     * @brief cancelFetchesOutside cancels the requests of xmlFetcher_ whose
+     * data is entirely outside the given time range.
+     * @param startTime: The start of the time range still needed
+     * @param endTime: The end of the time range still needed
+     */
+    void cancelFetchesOutside(const QDateTime& startTime,
+                              const QDateTime& endTime) override;
 
 protected:
     // Stores how many components an API date/time string consists of
     static const int DATE_TIME_COMPONENT_COUNT = 6;
 
-    // Stores how long API date/time strings are in characters
-    static const int DATE_TIME_STRING_LENGTH = 20;
+    // Stores how long API date/time strings are in characters without
+    // fractional seconds or timezone designator
+    static const int DATE_TIME_STRING_LENGTH = 19;
 
     /**
      * @brief xmlFetcher_ stores the XmlFetcher used to fetch XML data from the
@@ -53,6 +168,55 @@ protected:
      */
     explicit XmlDataImporter(QObject* parent = nullptr);
 
+    /**
+     * @brief getRecordDepth returns the depth in the XML document where the
+     * record elements are located, the root element being at depth 1.
+     * Abstract method: implement in inheriting class.
+     * @return The depth of the record elements
+     */
+    virtual int getRecordDepth() const = 0;
+
+    /**
+     * @brief createRecordParser creates the function that parses a single
+     * record of XML data for a data point. The function is called in the
+     * parser thread, so it must not use the importer. Abstract method:
+     * implement in inheriting class.
+     * @return The record parsing function
+     */
+    virtual XmlRecordParser createRecordParser() const = 0;
+
+    /**
+     * @brief xmlDataPointsParsed is called with the data points parsed from a
+     * chunk of XML data. Abstract method: implement in inheriting class.
+     * @param dataPoints: The parsed data points in the order they were parsed
+     * @param url: The URL the data points were fetched from
+     */
+    virtual void xmlDataPointsParsed(
+        const std::vector<ParsedDataPoint>& dataPoints,
+        const std::string& url) = 0;
+
+    /**
+     * @brief xmlParsed is called when all the records fetched from a URL have
+     * been parsed. Abstract method: implement in inheriting class.
+     * @param url: The URL the records were fetched from
+     */
+    virtual void xmlParsed(const std::string& url) = 0;
+
+    /**
+     * @brief xmlDiscarded is called when everything parsed from a URL has to
+     * be thrown away. Abstract method: implement in inheriting class.
+     * @param url: The URL whose parsed data should be thrown away
+     */
+    virtual void xmlDiscarded(const std::string& url) = 0;
+
+    /**
+     * @brief xmlCancelled is called when the fetch of a URL has been
+     * cancelled or has failed and nothing more will be parsed from it.
+     * Abstract method: implement in inheriting class.
+     * @param url: The URL whose fetch was cancelled
+     */
+    virtual void xmlCancelled(const std::string& url) = 0;
+
     /**
      * @brief padString adds padding characters to the start of the given
      * string until its length is minLength.
@@ -64,14 +228,17 @@ protected:
                           char paddingChar);
 
     /**
-     * @brief dateTimeFromApiString parses a date string given by the API and
-     * turns it into a QDateTime.
-     * @param dateTimeString: The API date/time string to parse
-     * @return QDateTime matching the given date/time string
+     * @brief secsSinceEpochFromApiString parses a date string given by the API
+     * and turns it into seconds since the Unix epoch. The string is parsed in
+     * place without allocating memory. Fractional seconds are truncated and
+     * timezone offsets (Z, +hh:mm, +hhmm, +hh or no designator for UTC) are
+     * taken into account.
+     * @param dateTimeString: The API date/time string to parse, in the format
+     * {year}-{month}-{day}T{hours}:{minutes}:{seconds}[.{fraction}][{offset}]
+     * @return Seconds since the epoch matching the given date/time string
      * @exception std::invalid_argument: Thrown when string could not be parsed
-     * into a QDateTime
      */
-    static QDateTime dateTimeFromApiString(const std::string& dateTimeString);
+    static qint64 secsSinceEpochFromApiString(QStringView dateTimeString);
 
     /**
      * @brief dateTimeToApiString creates an API compatible date string from a
@@ -91,6 +258,48 @@ protected:
      */
     static int findSubstring(const std::string& inspectedString,
                              const std::string& substring);
+
+private:
+    // Stores the thread the XML data is parsed in
+    QThread parserThread_;
+
+    // Stores the XmlParser living in parserThread_, nullptr until the first
+    // data arrives
+    XmlParser* parser_;
+
+    // Stores the current generation of each URL's stream that has been
+    // started over or cancelled, the rest are at generation 0
+    std::map<std::string, quint64> streamGenerations_;
+
+    // Stores the URLs whose streams have been cancelled and haven't received
+    // data since, their generations are forgotten once the parser thread has
+    // thrown the streams away
+    std::set<std::string> cancelledStreams_;
+
+    // Stores the last generation given to a stream
+    quint64 lastGeneration_;
+
+    /**
+     * @brief startParser creates parser_ and starts parserThread_ unless
+     * they're already running.
+     */
+    void startParser();
+
+    /**
+     * @brief getGeneration returns the current generation of the given URL's
+     * stream.
+     * @param url: The URL of the stream
+     * @return The generation of the stream
+     */
+    quint64 getGeneration(const std::string& url) const;
+
+    /**
+     * @brief abandonStream starts a new generation of the given URL's stream
+     * so that the results of the old one are ignored, and tells the parser
+     * thread to throw the old one away.
+     * @param url: The URL of the stream
+     */
+    void abandonStream(const std::string& url);
 };
 
 }
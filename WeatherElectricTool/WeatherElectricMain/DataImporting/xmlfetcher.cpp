@@ -9,11 +9,33 @@
 namespace DataImporting
 {
 
-XmlFetcher::XmlFetcher(QObject* parent) : QObject(parent), networkManager_()
+XmlFetcher::XmlFetcher(QObject* parent) : QObject(parent), scheduler_(),
+    urlsInFlight_()
 {
-    // Call replyReceived whenever a network reply is finished
-    connect(&networkManager_, &QNetworkAccessManager::finished,
-            this, &XmlFetcher::replyReceived);
+    // Relay received data and request state changes
+    connect(&scheduler_, &RequestScheduler::dataReceived,
+            this, &XmlFetcher::xmlDataReceived);
+    connect(&scheduler_, &RequestScheduler::requestRestarted,
+            this, &XmlFetcher::xmlDiscarded);
+    connect(&scheduler_, &RequestScheduler::requestFinished,
+            this, [this](const std::string& url)
+    {
+        // The URL can be requested again by whoever receives the signal
+        urlsInFlight_.erase(url);
+        emit xmlFetched(url);
+    });
+    connect(&scheduler_, &RequestScheduler::requestCancelled,
+            this, [this](const std::string& url)
+    {
+        urlsInFlight_.erase(url);
+        emit xmlCancelled(url);
+    });
+    connect(&scheduler_, &RequestScheduler::requestFailed,
+            this, [this](const std::string& url)
+    {
+        urlsInFlight_.erase(url);
+        emit xmlFailed(url);
+    });
 }
 
 XmlFetcher::~XmlFetcher()
@@ -23,35 +45,40 @@ XmlFetcher::~XmlFetcher()
 
 void XmlFetcher::fetchXml(const std::string& url,
                           const std::string& customHeaderName,
-                          const std::string& customHeaderValue)
+                          const std::string& customHeaderValue,
+                          const QDateTime& startTime,
+                          const QDateTime& endTime)
 {
-    QNetworkRequest request(QUrl(QString::fromStdString(url)));
-
-    if (customHeaderName != "")
+    // Whoever asked for the URL again receives the data of the request
+    // that is already in flight
+    if (!urlsInFlight_.insert(url).second)
     {
-        request.setRawHeader(QByteArray::fromStdString(customHeaderName),
-                             QByteArray::fromStdString(customHeaderValue));
+        return;
     }
 
-    networkManager_.get(request);
+    scheduler_.scheduleRequest(url, customHeaderName, customHeaderValue,
+                               startTime.toSecsSinceEpoch(),
+                               endTime.toSecsSinceEpoch());
 }
 
-void XmlFetcher::fetchXml(const std::string& url)
+void XmlFetcher::fetchXml(const std::string& url, const QDateTime& startTime,
+                          const QDateTime& endTime)
 {
-    fetchXml(url, "", "");
+    fetchXml(url, "", "", startTime, endTime);
 }
 
-void XmlFetcher::replyReceived(QNetworkReply* reply)
+void XmlFetcher::setVisibleTimeRange(const QDateTime& startTime,
+                                     const QDateTime& endTime)
 {
-    QDomDocument xmlDoc;
-
-    // Create XML document from reply and pass it forward with xmlFetched
-    xmlDoc.setContent(reply->readAll());
-
-    emit xmlFetched(xmlDoc, reply->url().toString().toStdString());
+    scheduler_.setVisibleTimeRange(startTime.toSecsSinceEpoch(),
+                                   endTime.toSecsSinceEpoch());
+}
 
-    // The reply needs to be deleted using this special method
-    reply->deleteLater();
+void XmlFetcher::cancelFetchesOutside(const QDateTime& startTime,
+                                      const QDateTime& endTime)
+{
+    scheduler_.cancelRequestsOutside(startTime.toSecsSinceEpoch(),
+                                     endTime.toSecsSinceEpoch());
 }
 
 }
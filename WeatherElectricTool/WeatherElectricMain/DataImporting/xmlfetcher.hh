@@ -8,17 +8,24 @@
 #ifndef XMLFETCHER_HH
 #define XMLFETCHER_HH
 
+#include "requestscheduler.hh"
+
+#include <QDateTime>
 #include <QObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QtXml>
+
+#include <set>
 
 namespace DataImporting
 {
 
 /**
  * @brief The XmlFetcher class fetches XML data from URLs and passes it on to
- * be parsed for data.
+ * be parsed for data. The data is passed on in chunks as it arrives from the
+ * network so that it can be parsed without buffering the whole reply.
+ *
+ * A URL is only requested once at a time. Fetching a URL whose request is
+ * still in flight doesn't send another request, the data of the first one is
+ * passed on to everyone waiting for the URL.
  */
 class XmlFetcher : public QObject
 {
@@ -37,43 +44,96 @@ public:
     virtual ~XmlFetcher();
 
     /**
-     * @brief fetchXml fetches XML data from the given URL.
+     * @brief fetchXml fetches XML data from the given URL unless it's already
+     * being fetched.
      * @param url: The URL to fetch the XML data from
      * @param customHeaderName: The name of the custom HTML header to include
      * @param customHeaderValue: The value of the custom HTML header to include
+     * @param startTime: The start of the time period the data is from
+     * @param endTime: The end of the time period the data is from
      */
     void fetchXml(const std::string& url, const std::string& customHeaderName,
-                  const std::string& customHeaderValue);
+                  const std::string& customHeaderValue,
+                  const QDateTime& startTime, const QDateTime& endTime);
 
     /**
-     * @brief fetchXml fetches XML data from the given URL.
+     * @brief fetchXml fetches XML data from the given URL unless it's already
+     * being fetched.
      * @param url: The URL to fetch the XML data from
+     * @param startTime: The start of the time period the data is from
+     * @param endTime: The end of the time period the data is from
+     */
+    void fetchXml(const std::string& url, const QDateTime& startTime,
+                  const QDateTime& endTime);
+
+    /**
+     * @brief setVisibleTimeRange sets the time range currently shown to the
+     * user so that data inside it can be fetched first.
+     * @param startTime: The start of the visible time range
+     * @param endTime: The end of the visible time range
      */
-    void fetchXml(const std::string& url);
+    void setVisibleTimeRange(const QDateTime& startTime,
+                             const QDateTime& endTime);
+
+    /**
+     * @brief cancelFetchesOutside cancels the fetches of every URL whose data
+     * is entirely outside the given time range. xmlCancelled is sent for
+     * each of them.
+     * @param startTime: The start of the time range still needed
+     * @param endTime: The end of the time range still needed
+     */
+    void cancelFetchesOutside(const QDateTime& startTime,
+                              const QDateTime& endTime);
 
 signals:
     /**
-     * @brief The xmlFetched signal is sent whenever XML data has been fetched
-     * successfully.
-     * @param xmlData: The fetched data
+     * @brief The xmlDataReceived signal is sent whenever a new chunk of XML
+     * data has arrived from the network.
+     * @param xmlData: The received chunk of XML data
+     * @param url: The URL the data is being fetched from
+     */
+    void xmlDataReceived(const QByteArray& xmlData, const std::string& url);
+
+    /**
+     * @brief The xmlDiscarded signal is sent when the XML data received from
+     * a URL so far has to be thrown away because the request is sent again.
+     * @param url: The URL the data was being fetched from
+     */
+    void xmlDiscarded(const std::string& url);
+
+    /**
+     * @brief The xmlFetched signal is sent after the last chunk of XML data
+     * from a URL has been passed on with xmlDataReceived.
      * @param url: The URL the data was fetched from
      */
-    void xmlFetched(const QDomDocument& xmlData, const std::string url);
+    void xmlFetched(const std::string& url);
 
-protected slots:
     /**
-     * @brief replyReceived is called whenever networkManager_ finishes
-     * receiving a network reply.
-     * @param reply: A pointer to the QNetworkReply received
+     * @brief The xmlCancelled signal is sent when the fetch of a URL has been
+     * cancelled. The XML data received from it so far is incomplete and no
+     * more of it will arrive.
+     * @param url: The URL the data was being fetched from
      */
-    void replyReceived(QNetworkReply* reply);
+    void xmlCancelled(const std::string& url);
+
+    /**
+     * @brief The xmlFailed signal is sent when the fetch of a URL has failed
+     * for good. The XML data received from it so far is incomplete and no
+     * more of it will arrive.
+     * @param url: The URL the data was being fetched from
+     */
+    void xmlFailed(const std::string& url);
 
 protected:
     /**
-     * @brief networkManager_ stores the QNetworkAccessManager that makes
-     * fetch requests.
+     * @brief scheduler_ stores the RequestScheduler that sends the fetch
+     * requests.
      */
-    QNetworkAccessManager networkManager_;
+    RequestScheduler scheduler_;
+
+private:
+    // Stores the URLs whose requests haven't finished yet
+    std::set<std::string> urlsInFlight_;
 };
 
 }
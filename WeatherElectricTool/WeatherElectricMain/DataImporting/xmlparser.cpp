@@ -0,0 +1,116 @@
+/**
+  * @file xmlparser.cpp implements the XmlParser class.
+  * @date 16.10.2026
+  */
+
+#include "xmlparser.hh"
+
+namespace DataImporting
+{
+
+XmlParser::XmlParser(int recordDepth, XmlRecordParser recordParser) :
+    QObject(nullptr), recordDepth_(recordDepth),
+    recordParser_(recordParser), streamStates_()
+{
+
+}
+
+XmlParser::~XmlParser()
+{
+
+}
+
+void XmlParser::parseXmlData(const QByteArray& xmlData,
+                             const std::string& url, quint64 generation)
+{
+    std::unique_ptr<XmlStreamState>& state = streamStates_[url];
+
+    // A new generation means that the stream was started over
+    if (state == nullptr || state->generation != generation)
+    {
+        state.reset(new XmlStreamState());
+        state->generation = generation;
+        state->depth = 0;
+    }
+
+    QXmlStreamReader& reader = state->reader;
+    reader.addData(xmlData);
+
+    std::vector<ParsedDataPoint> dataPoints;
+    ParsedDataPoint dataPoint = ParsedDataPoint();
+
+    // Read tokens until the received data runs out. The reader remembers
+    // where it stopped and continues from there when more data is added.
+    while (!reader.atEnd())
+    {
+        QXmlStreamReader::TokenType token = reader.readNext();
+
+        if (token == QXmlStreamReader::StartElement)
+        {
+            state->depth++;
+
+            if (state->depth == recordDepth_ + 1)
+            {
+                state->elementText.clear();
+            }
+        }
+        else if (token == QXmlStreamReader::Characters)
+        {
+            // Only the text of the record's direct children is needed
+            if (state->depth == recordDepth_ + 1)
+            {
+                state->elementText += reader.text();
+            }
+        }
+        else if (token == QXmlStreamReader::EndElement)
+        {
+            if (state->depth == recordDepth_ + 1)
+            {
+                state->record[reader.qualifiedName().toString()] =
+                    state->elementText;
+            }
+            else if (state->depth == recordDepth_)
+            {
+                // Record complete, parse it and start collecting the next one
+                if (recordParser_(state->record, url, dataPoint))
+                {
+                    dataPoints.push_back(dataPoint);
+                }
+
+                state->record.clear();
+            }
+
+            state->depth--;
+        }
+    }
+
+    // Send the whole chunk at once to keep the GUI thread's work per chunk
+    // small
+    if (!dataPoints.empty())
+    {
+        emit dataPointsParsed(dataPoints, url, generation);
+    }
+}
+
+void XmlParser::finishXml(const std::string& url, quint64 generation)
+{
+    auto stateIt = streamStates_.find(url);
+
+    // Whatever couldn't be parsed by now is incomplete and can't be used
+    if (stateIt != streamStates_.end()
+        && stateIt->second->generation == generation)
+    {
+        streamStates_.erase(stateIt);
+    }
+
+    emit xmlFinished(url, generation);
+}
+
+void XmlParser::dropXml(const std::string& url, quint64 generation)
+{
+    streamStates_.erase(url);
+
+    emit xmlDropped(url, generation);
+}
+
+}
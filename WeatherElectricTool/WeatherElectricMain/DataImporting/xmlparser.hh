@@ -0,0 +1,164 @@
+/**
+  * @file xmlparser.hh declares the XmlParser class, which is used to parse
+  * streamed XML data into data points outside the GUI thread.
+  * @date 16.10.2026
+  */
+
+#ifndef XMLPARSER_HH
+#define XMLPARSER_HH
+
+#include "dataimporter.hh"
+
+#include <QByteArray>
+#include <QObject>
+#include <QXmlStreamReader>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace DataImporting
+{
+
+/**
+ * @brief The XmlRecord type stores the text content of each child element of
+ * a record, mapped by the child elements' qualified names.
+ */
+typedef std::map<QString, QString> XmlRecord;
+
+/**
+ * @brief The ParsedDataPoint struct stores a data point parsed from a record
+ * along with the type of its data.
+ */
+struct ParsedDataPoint
+{
+    ApiDataType dataType;
+    DataPoint dataPoint;
+};
+
+/**
+ * @brief The XmlRecordParser type parses a single record for a data point.
+ * It gets the record and the URL the record was fetched from, and returns
+ * true if it stored a valid data point in its last parameter.
+ */
+typedef std::function<bool(const XmlRecord&, const std::string&,
+                           ParsedDataPoint&)> XmlRecordParser;
+
+/**
+ * @brief The XmlParser class parses XML data as a stream while it arrives
+ * and splits it into records: elements at a fixed depth whose child elements
+ * hold the values of a single data point. It's meant to live in a thread of
+ * its own, so that parsing large replies doesn't block the GUI thread. It's
+ * only used through queued connections and sends the data points parsed from
+ * each chunk back in one batch.
+ *
+ * Every chunk is given with the generation of its URL's stream. A chunk of a
+ * new generation starts the stream of the URL over, and the generation is
+ * passed back with the results so that results of an abandoned stream can be
+ * recognised.
+ */
+class XmlParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief The default constructor.
+     * @param recordDepth: The depth in the XML document where the record
+     * elements are located, the root element being at depth 1
+     * @param recordParser: The function to parse each record with. Called in
+     * the parser's thread.
+     */
+    XmlParser(int recordDepth, XmlRecordParser recordParser);
+
+    /**
+     * @brief The default destructor.
+     */
+    virtual ~XmlParser();
+
+public slots:
+    /**
+     * @brief parseXmlData parses as many records as the received chunk of
+     * XML data allows and sends the parsed data points with
+     * dataPointsParsed.
+     * @param xmlData: The received chunk of XML data
+     * @param url: The URL the data is being fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void parseXmlData(const QByteArray& xmlData, const std::string& url,
+                      quint64 generation);
+
+    /**
+     * @brief finishXml ends the stream of the given URL and sends
+     * xmlFinished. Whatever couldn't be parsed by now is left out.
+     * @param url: The URL the data was fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void finishXml(const std::string& url, quint64 generation);
+
+    /**
+     * @brief dropXml throws away the stream of the given URL without parsing
+     * any more of it and sends xmlDropped.
+     * @param url: The URL the data was being fetched from
+     * @param generation: The generation the URL's stream was abandoned for
+     */
+    void dropXml(const std::string& url, quint64 generation);
+
+signals:
+    /**
+     * @brief The dataPointsParsed signal is sent with the data points parsed
+     * from a chunk of XML data.
+     * @param dataPoints: The parsed data points in the order they were parsed
+     * @param url: The URL the data is being fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void dataPointsParsed(const std::vector<ParsedDataPoint>& dataPoints,
+                          const std::string& url, quint64 generation);
+
+    /**
+     * @brief The xmlFinished signal is sent after the data points of the last
+     * chunk of a URL have been sent.
+     * @param url: The URL the data was fetched from
+     * @param generation: The generation of the URL's stream
+     */
+    void xmlFinished(const std::string& url, quint64 generation);
+
+    /**
+     * @brief The xmlDropped signal is sent after the stream of a URL has been
+     * thrown away. Nothing parsed from the old stream is sent after it.
+     * @param url: The URL the data was being fetched from
+     * @param generation: The generation the URL's stream was abandoned for
+     */
+    void xmlDropped(const std::string& url, quint64 generation);
+
+private:
+    /**
+     * @brief The XmlStreamState struct stores the state of an unfinished
+     * streaming parse between received chunks of data.
+     */
+    struct XmlStreamState
+    {
+        QXmlStreamReader reader;
+        quint64 generation;
+        int depth;
+        XmlRecord record;
+        QString elementText;
+    };
+
+    // Stores the depth of the record elements
+    int recordDepth_;
+
+    // Stores the function each record is parsed with
+    XmlRecordParser recordParser_;
+
+    // Stores the state of each unfinished streaming parse by request URL
+    std::map<std::string, std::unique_ptr<XmlStreamState>> streamStates_;
+};
+
+}
+
+// Allow passing these through queued connections
+Q_DECLARE_METATYPE(std::string)
+Q_DECLARE_METATYPE(std::vector<DataImporting::ParsedDataPoint>)
+
+#endif // XMLPARSER_HH
@@ -9,6 +9,8 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++11
 
+include(../sanitize.pri)
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -29,6 +31,16 @@ SOURCES += \
     DataImporting/xmldataimporter.cpp \
     DataImporting/fmidataimporter.cpp \
     DataImporting/fingriddataimporter.cpp \
+    DataImporting/timeseries.cpp \
+    DataImporting/requestscheduler.cpp \
+    DataImporting/intervalset.cpp \
+    DataImporting/segmentcache.cpp \
+    DataImporting/datajournal.cpp \
+    DataImporting/cachingdataimporter.cpp \
+    DataImporting/rolluppyramid.cpp \
+    DataImporting/xmlparser.cpp \
+    DataImporting/minmaxtree.cpp \
+    DataImporting/windowaggregates.cpp \
     weatherpie.cpp
 
 HEADERS += \
@@ -46,6 +58,16 @@ HEADERS += \
     DataImporting/xmldataimporter.hh \
     DataImporting/fmidataimporter.hh \
     DataImporting/fingriddataimporter.hh \
+    DataImporting/timeseries.hh \
+    DataImporting/requestscheduler.hh \
+    DataImporting/intervalset.hh \
+    DataImporting/segmentcache.hh \
+    DataImporting/datajournal.hh \
+    DataImporting/cachingdataimporter.hh \
+    DataImporting/rolluppyramid.hh \
+    DataImporting/xmlparser.hh \
+    DataImporting/minmaxtree.hh \
+    DataImporting/windowaggregates.hh \
     weatherpie.hh
 
 FORMS += \
@@ -6,77 +6,415 @@
 
 #include "cachefilehandler.h"
 
+#include <QDataStream>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstdio>
+#include <cstring>
+
+// Identifies binary data set files ("WEVW")
+static const quint32 BINARY_FILE_MAGIC = 0x57455657;
+
+// Version of the binary data set format, increased whenever the format changes. Version 1 files
+// have no coverage and always store their data point columns as byte arrays.
+static const quint16 BINARY_FILE_VERSION = 2;
+
+// Flag telling that the data point columns of a binary data set file are compressed
+static const quint16 COMPRESSED_FLAG = 0x1;
+
+// Uncompressed data point columns start at multiples of this so that they can be read in place
+static const qint64 COLUMN_ALIGNMENT = 8;
+
+// Xml data set files are written in pieces of about this many bytes
+static const int XML_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * @brief appendInteger formats an integer into an xml buffer without going through QString.
+ * @param buffer is the buffer to append to.
+ * @param value is the integer.
+ */
+static void appendInteger(QByteArray& buffer, qint64 value)
+{
+    char digits[20];
+    int digitCount = 0;
+
+    // Negate digit by digit so that the smallest qint64 doesn't overflow
+    bool negative = value < 0;
+    do
+    {
+        int digit = value % 10;
+        digits[digitCount++] = '0' + (negative ? -digit : digit);
+        value /= 10;
+    } while(value != 0);
+
+    if(negative)
+    {
+        buffer.append('-');
+    }
+    while(digitCount > 0)
+    {
+        buffer.append(digits[--digitCount]);
+    }
+}
+
+/**
+ * @brief appendFloat formats a float into an xml buffer with enough digits to read it back exactly.
+ * @param buffer is the buffer to append to.
+ * @param value is the float.
+ */
+static void appendFloat(QByteArray& buffer, float value)
+{
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.9g", value);
+    buffer.append(text, length);
+}
+
+/**
+ * @brief appendXmlElement appends the indentation and start tag of an xml element.
+ * @param buffer is the buffer to append to.
+ * @param depth is the nesting depth of the element.
+ * @param tag is the name of the element.
+ */
+static void appendXmlElement(QByteArray& buffer, int depth, const char* tag)
+{
+    buffer.append(QByteArray(depth * 4, ' '));
+    buffer.append('<').append(tag).append('>');
+}
+
+/**
+ * @brief appendXmlTextElement appends a whole xml element containing escaped text.
+ * @param buffer is the buffer to append to.
+ * @param depth is the nesting depth of the element.
+ * @param tag is the name of the element.
+ * @param text is the text of the element.
+ */
+static void appendXmlTextElement(QByteArray& buffer, int depth, const char* tag, const std::string& text)
+{
+    appendXmlElement(buffer, depth, tag);
+    buffer.append(QString::fromStdString(text).toHtmlEscaped().toUtf8());
+    buffer.append("</").append(tag).append(">\n");
+}
+
+/**
+ * @brief flushBuffer writes the contents of a buffer to a file and empties the buffer.
+ * @param file is the file to write to.
+ * @param buffer is the buffer to write.
+ * @return true if everything was written, otherwise false.
+ */
+static bool flushBuffer(QIODevice& file, QByteArray& buffer)
+{
+    bool written = file.write(buffer) == buffer.size();
+    // Keeps the allocated memory for the next piece
+    buffer.resize(0);
+    return written;
+}
+
+/**
+ * @brief alignedPosition rounds a file position up to the next column start.
+ * @param position is the position in bytes.
+ * @return the aligned position.
+ */
+static qint64 alignedPosition(qint64 position)
+{
+    return (position + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+/**
+ * @brief writeDataSetDetails writes everything of a data set except its data points.
+ * @param stream is the stream to write to.
+ * @param dataSet is the data set to write.
+ */
+static void writeDataSetDetails(QDataStream& stream, const DataSet& dataSet)
+{
+    // DataSourceDetails data
+    stream << QString::fromStdString(dataSet.dataSource.dataSourceName)
+           << QString::fromStdString(dataSet.dataSource.dataLocationName)
+           << QString::fromStdString(dataSet.dataSource.graphName)
+           << (qint32)dataSet.dataSource.dataSourceIndex
+           << (qint32)dataSet.dataSource.dataType
+           << (qint32)dataSet.hide;
+
+    // DataSeries data
+    stream << QString::fromStdString(dataSet.series.unitOfMeasurement)
+           << dataSet.series.maxY
+           << dataSet.series.minY
+           << dataSet.series.magnitude;
+
+    // Time intervals the data points were fetched from
+    std::vector<DataImporting::TimeInterval> coverage = dataSet.coverage.intervals();
+    stream << (quint32)coverage.size();
+    for(const DataImporting::TimeInterval& interval : coverage)
+    {
+        stream << interval.first << interval.second;
+    }
+}
+
+/**
+ * @brief readDataSetDetails reads details written by writeDataSetDetails.
+ * @param stream is the stream to read from.
+ * @param version is the version of the file being read.
+ * @param dataSet is the data set which gets the read details.
+ */
+static void readDataSetDetails(QDataStream& stream, quint16 version, DataSet& dataSet)
+{
+    QString dataSourceName;
+    QString dataLocationName;
+    QString graphName;
+    qint32 importerIndex = 0;
+    qint32 apiDataType = 0;
+    qint32 hide = 0;
+    QString unitOfMeasurement;
+
+    // DataSourceDetails info
+    stream >> dataSourceName >> dataLocationName >> graphName
+           >> importerIndex >> apiDataType >> hide;
+    dataSet.dataSource.dataSourceName = dataSourceName.toStdString();
+    dataSet.dataSource.dataLocationName = dataLocationName.toStdString();
+    dataSet.dataSource.graphName = graphName.toStdString();
+    dataSet.dataSource.dataSourceIndex = importerIndex;
+    dataSet.dataSource.dataType = static_cast<DataImporting::ApiDataType>(apiDataType);
+    dataSet.hide = hide;
+
+    // DataSeries info
+    stream >> unitOfMeasurement >> dataSet.series.maxY >> dataSet.series.minY
+           >> dataSet.series.magnitude;
+    dataSet.series.unitOfMeasurement = unitOfMeasurement.toStdString();
+
+    if(version >= 2)
+    {
+        quint32 intervalCount = 0;
+        stream >> intervalCount;
+        for(quint32 i = 0; intervalCount > i && stream.status() == QDataStream::Ok; i++)
+        {
+            qint64 startSecs = 0;
+            qint64 endSecs = 0;
+            stream >> startSecs >> endSecs;
+            dataSet.coverage.add(startSecs, endSecs);
+        }
+    }
+}
+
+/**
+ * @brief encodeColumns packs data points into a column of little-endian times and a column of
+ * little-endian values.
+ * @param data contains the data points.
+ * @param timeDifferences tells if times are stored as differences to the previous time, which
+ * compress better.
+ * @param times gets the packed times.
+ * @param values gets the packed values.
+ */
+static void encodeColumns(const DataImporting::TimeSeries& data, bool timeDifferences,
+                          QByteArray& times, QByteArray& values)
+{
+    times = QByteArray(data.size() * sizeof(qint64), Qt::Uninitialized);
+    values = QByteArray(data.size() * sizeof(quint32), Qt::Uninitialized);
+    char* timePosition = times.data();
+    char* valuePosition = values.data();
+    qint64 previousTime = 0;
+
+    data.forEachPoint(0, data.size(), [&](qint64 time, float value)
+    {
+        quint32 valueBits;
+        std::memcpy(&valueBits, &value, sizeof(valueBits));
+
+        qToLittleEndian<qint64>(timeDifferences ? time - previousTime : time, timePosition);
+        qToLittleEndian<quint32>(valueBits, valuePosition);
+
+        previousTime = time;
+        timePosition += sizeof(qint64);
+        valuePosition += sizeof(quint32);
+    });
+}
+
+/**
+ * @brief decodeValue reads a single value from a packed value column.
+ * @param position is the position of the value.
+ * @return the value.
+ */
+static float decodeValue(const char* position)
+{
+    quint32 valueBits = qFromLittleEndian<quint32>(position);
+    float value;
+    std::memcpy(&value, &valueBits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief decodeColumns unpacks data points packed by encodeColumns.
+ * @param times contains the packed times.
+ * @param values contains the packed values.
+ * @param pointCount is the number of packed data points.
+ * @param timeDifferences tells if times are stored as differences to the previous time.
+ * @param data gets the data points appended to it.
+ */
+static void decodeColumns(const char* times, const char* values, quint32 pointCount,
+                          bool timeDifferences, DataImporting::TimeSeries& data)
+{
+    qint64 time = 0;
+
+    for(quint32 i = 0; pointCount > i; i++)
+    {
+        qint64 storedTime = qFromLittleEndian<qint64>(times + i * sizeof(qint64));
+        time = timeDifferences ? time + storedTime : storedTime;
+
+        data.append(time, decodeValue(values + i * sizeof(quint32)));
+    }
+}
 
 void CacheFileHandler::saveDataSet(std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> savedDataSet, QString fileName)
 {
-    qint64 startDate = savedDataSet.first.first.toSecsSinceEpoch();
-    qint64 endDate = savedDataSet.first.second.toSecsSinceEpoch();
-    std::vector<DataSet> data = savedDataSet.second;
+    // Write to a temporary file first so that a failed save can't break an old file
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        std::cout<<"Saving data set failed"<<std::endl;
+        return;
+    }
 
-    QFile file(fileName);
-    file.open(QIODevice::WriteOnly);
+    // The xml is written by hand in the same layout QXmlStreamWriter would use, because data points
+    // are formatted much faster without going through QString
+    QByteArray buffer;
+    buffer.reserve(XML_BUFFER_SIZE + XML_BUFFER_SIZE / 4);
+    bool writeFailed = false;
 
-    QXmlStreamWriter xmlWriter(&file);
-    xmlWriter.setAutoFormatting(true);
-    xmlWriter.writeStartDocument();
-    xmlWriter.writeStartElement("savedDataSets");
+    buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<savedDataSets>\n");
 
-    xmlWriter.writeStartElement("startTime");
-    xmlWriter.writeTextElement("secsSinceEpoch", QString::number(startDate));
-    xmlWriter.writeEndElement();
+    buffer.append("    <startTime>\n");
+    appendXmlElement(buffer, 2, "secsSinceEpoch");
+    appendInteger(buffer, savedDataSet.first.first.toSecsSinceEpoch());
+    buffer.append("</secsSinceEpoch>\n    </startTime>\n");
 
-    xmlWriter.writeStartElement("endTime");
-    xmlWriter.writeTextElement("secsSinceEpoch", QString::number(endDate));
-    xmlWriter.writeEndElement();
+    buffer.append("    <endTime>\n");
+    appendXmlElement(buffer, 2, "secsSinceEpoch");
+    appendInteger(buffer, savedDataSet.first.second.toSecsSinceEpoch());
+    buffer.append("</secsSinceEpoch>\n    </endTime>\n");
 
-    xmlWriter.writeStartElement("graphs");
+    buffer.append("    <graphs>\n");
 
     // Go through each graph
-    for(DataSet data_it : data)
+    for(const DataSet& data_it : savedDataSet.second)
     {
-        xmlWriter.writeStartElement("graph");
+        buffer.append("        <graph>\n");
         // DataSourceDetails data
-        xmlWriter.writeTextElement("dataSourceName", QString::fromStdString(data_it.dataSource.dataSourceName));
-        xmlWriter.writeTextElement("dataLocationName", QString::fromStdString(data_it.dataSource.dataLocationName));
-        xmlWriter.writeTextElement("graphName", QString::fromStdString(data_it.dataSource.graphName));
-        xmlWriter.writeTextElement("importerIndex", QString::number(data_it.dataSource.dataSourceIndex));
-        xmlWriter.writeTextElement("apiDataType", QString::number(data_it.dataSource.dataType));
+        appendXmlTextElement(buffer, 3, "dataSourceName", data_it.dataSource.dataSourceName);
+        appendXmlTextElement(buffer, 3, "dataLocationName", data_it.dataSource.dataLocationName);
+        appendXmlTextElement(buffer, 3, "graphName", data_it.dataSource.graphName);
+        appendXmlElement(buffer, 3, "importerIndex");
+        appendInteger(buffer, data_it.dataSource.dataSourceIndex);
+        buffer.append("</importerIndex>\n");
+        appendXmlElement(buffer, 3, "apiDataType");
+        appendInteger(buffer, data_it.dataSource.dataType);
+        buffer.append("</apiDataType>\n");
 
-        xmlWriter.writeTextElement("hide", QString::number(data_it.hide));
+        appendXmlElement(buffer, 3, "hide");
+        appendInteger(buffer, data_it.hide);
+        buffer.append("</hide>\n");
 
         // DataSeries data
-        xmlWriter.writeTextElement("unitOfMeasurement", QString::fromStdString(data_it.series.unitOfMeasurement));
-        xmlWriter.writeTextElement("maxY", QString::number(data_it.series.maxY));
-        xmlWriter.writeTextElement("minY", QString::number(data_it.series.minY));
-        xmlWriter.writeTextElement("magnitude", QString::number(data_it.series.magnitude));
+        appendXmlTextElement(buffer, 3, "unitOfMeasurement", data_it.series.unitOfMeasurement);
+        appendXmlElement(buffer, 3, "maxY");
+        appendFloat(buffer, data_it.series.maxY);
+        buffer.append("</maxY>\n");
+        appendXmlElement(buffer, 3, "minY");
+        appendFloat(buffer, data_it.series.minY);
+        buffer.append("</minY>\n");
+        appendXmlElement(buffer, 3, "magnitude");
+        appendFloat(buffer, data_it.series.magnitude);
+        buffer.append("</magnitude>\n");
 
-        xmlWriter.writeStartElement("data");
-        QSplineSeries* series = data_it.series.splineSeries;
+        buffer.append("            <data>\n");
         // Go through each data point
-        for(int i = 0; series->count() > i; i++)
+        data_it.data.forEachPoint(0, data_it.data.size(), [&](qint64 x, float y)
+        {
+            buffer.append("                <point>\n                    <value>");
+            appendFloat(buffer, y);
+            buffer.append("</value>\n                    <secsSinceEpoch>");
+            appendInteger(buffer, x);
+            buffer.append("</secsSinceEpoch>\n                </point>\n");
+
+            if(buffer.size() >= XML_BUFFER_SIZE)
+            {
+                writeFailed |= !flushBuffer(file, buffer);
+            }
+        });
+        // Close tags "data" and "graph"
+        buffer.append("            </data>\n        </graph>\n");
+    }
+    // Close tags "graphs" and "savedDataSets"
+    buffer.append("    </graphs>\n</savedDataSets>\n");
+
+    writeFailed |= !flushBuffer(file, buffer);
+    if(writeFailed || !file.commit())
+    {
+        std::cout<<"Saving data set failed"<<std::endl;
+    }
+}
+
+void CacheFileHandler::saveDataSetBinary(std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> savedDataSet,
+                                         QString fileName, bool compress)
+{
+    // Write to a temporary file first so that a failed save can't break an old file
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        std::cout<<"Saving data set failed"<<std::endl;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint16 flags = compress ? COMPRESSED_FLAG : 0;
+    stream << BINARY_FILE_MAGIC << BINARY_FILE_VERSION << flags
+           << savedDataSet.first.first.toSecsSinceEpoch()
+           << savedDataSet.first.second.toSecsSinceEpoch()
+           << (quint32)savedDataSet.second.size();
+
+    // Go through each graph
+    for(const DataSet& dataSet : savedDataSet.second)
+    {
+        writeDataSetDetails(stream, dataSet);
+
+        quint32 pointCount = dataSet.data.size();
+        stream << pointCount;
+
+        // Data points are stored as a column of times and a column of values
+        QByteArray times;
+        QByteArray values;
+
+        if(compress)
         {
-            float y = series->at(i).y();
-            qint64 x = series->at(i).x();
-            xmlWriter.writeStartElement("point");
-            xmlWriter.writeTextElement("value", QString::number(y));
-            xmlWriter.writeTextElement("secsSinceEpoch", QString::number(x));
-            xmlWriter.writeEndElement();
+            encodeColumns(dataSet.data, true, times, values);
+            stream << qCompress(times) << qCompress(values);
+        }
+        // Uncompressed columns are aligned so that they can be read straight from a mapped file
+        else
+        {
+            static const char padding[COLUMN_ALIGNMENT] = {};
+            stream.writeRawData(padding, alignedPosition(file.pos()) - file.pos());
+
+            encodeColumns(dataSet.data, false, times, values);
+            stream.writeRawData(times.constData(), times.size());
+            stream.writeRawData(values.constData(), values.size());
         }
-        // Close tag "data"
-        xmlWriter.writeEndElement();
-        // Close tag "graph"
-        xmlWriter.writeEndElement();
     }
-    // Close tag "graphs"
-    xmlWriter.writeEndElement();
-    // Close tag "savedDataSets"
-    xmlWriter.writeEndElement();
 
-    xmlWriter.writeEndDocument();
-    file.close();
+    if(stream.status() != QDataStream::Ok || !file.commit())
+    {
+        std::cout<<"Saving data set failed"<<std::endl;
+    }
 }
 
 std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandler::readDataSet(QString fileName)
+{
+    if(isBinaryDataSetFile(fileName))
+    {
+        return readDataSetBinary(fileName);
+    }
+    return readDataSetXml(fileName);
+}
+
+std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandler::readDataSetXml(QString fileName)
 {
     std::vector<DataSet> data;
     QDateTime startDate;
@@ -114,7 +452,6 @@ std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandl
             if(child.tagName() == "graph")
             {
                 DataSet dataSet = {};
-                dataSet.series.splineSeries = new QSplineSeries();
                 QDomElement graphElement = child.firstChild().toElement();
                 // Go through graph info
                 while(!graphElement.isNull())
@@ -158,8 +495,8 @@ std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandl
                         // Go through data
                         while(!dataElement.isNull())
                         {
-                            float x;
-                            float y;
+                            qint64 x = 0;
+                            float y = 0;
                             QDomElement pointElement = dataElement.firstChild().toElement();
                             // Go through point values
                             while(!pointElement.isNull())
@@ -168,11 +505,12 @@ std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandl
                                     y = pointElement.firstChild().toText().data().toFloat();
                                 }
                                 else if(pointElement.tagName() == "secsSinceEpoch"){
-                                    x = pointElement.firstChild().toText().data().toFloat();
+                                    // Seconds since the epoch don't fit in a float exactly
+                                    x = pointElement.firstChild().toText().data().toLongLong();
                                 }
                                 pointElement = pointElement.nextSibling().toElement();
                             }
-                            dataSet.series.splineSeries->append(QPointF(x, y));
+                            dataSet.data.append(x, y);
                             dataElement = dataElement.nextSibling().toElement();
                         }
                     }
@@ -187,6 +525,268 @@ std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandl
     return {{startDate, endDate}, data};
 }
 
+std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet> > CacheFileHandler::readDataSetBinary(QString fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly))
+    {
+        std::cout<<"Loading data set failed"<<std::endl;
+        return {};
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 flags = 0;
+    qint64 startDateEpoch = 0;
+    qint64 endDateEpoch = 0;
+    quint32 graphCount = 0;
+    stream >> magic >> version >> flags >> startDateEpoch >> endDateEpoch >> graphCount;
+
+    if(magic != BINARY_FILE_MAGIC || version < 1 || version > BINARY_FILE_VERSION)
+    {
+        std::cout<<"Loading data set failed: unsupported file version"<<std::endl;
+        return {};
+    }
+
+    // Version 1 columns are always stored as byte arrays
+    bool packedColumns = version >= 2 && !(flags & COMPRESSED_FLAG);
+
+    std::vector<DataSet> data;
+    // Go through each graph
+    for(quint32 i = 0; graphCount > i && stream.status() == QDataStream::Ok; i++)
+    {
+        DataSet dataSet = {};
+        readDataSetDetails(stream, version, dataSet);
+
+        quint32 pointCount = 0;
+        stream >> pointCount;
+
+        QByteArray times;
+        QByteArray values;
+
+        // Don't trust the point count of a broken file
+        if(stream.status() != QDataStream::Ok || (quint64)pointCount * sizeof(qint64) > (quint64)file.size())
+        {
+            std::cout<<"Loading data set failed: broken file"<<std::endl;
+            return {};
+        }
+
+        if(packedColumns)
+        {
+            file.seek(alignedPosition(file.pos()));
+            times = file.read(pointCount * sizeof(qint64));
+            values = file.read(pointCount * sizeof(quint32));
+        }
+        else
+        {
+            stream >> times >> values;
+
+            if(flags & COMPRESSED_FLAG)
+            {
+                times = qUncompress(times);
+                values = qUncompress(values);
+            }
+        }
+
+        // Columns of a broken file might not match the point count
+        if(stream.status() != QDataStream::Ok
+           || (quint64)times.size() != (quint64)pointCount * sizeof(qint64)
+           || (quint64)values.size() != (quint64)pointCount * sizeof(quint32))
+        {
+            std::cout<<"Loading data set failed: broken file"<<std::endl;
+            return {};
+        }
+
+        decodeColumns(times.constData(), values.constData(), pointCount, !packedColumns, dataSet.data);
+        data.push_back(dataSet);
+    }
+
+    if(stream.status() != QDataStream::Ok)
+    {
+        std::cout<<"Loading data set failed: broken file"<<std::endl;
+        return {};
+    }
+    return {{QDateTime::fromSecsSinceEpoch(startDateEpoch), QDateTime::fromSecsSinceEpoch(endDateEpoch)}, data};
+}
+
+bool CacheFileHandler::isBinaryDataSetFile(QString fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    stream >> magic;
+    return magic == BINARY_FILE_MAGIC;
+}
+
+
+std::shared_ptr<MappedDataSetFile> CacheFileHandler::mapDataSet(QString fileName)
+{
+    std::shared_ptr<MappedDataSetFile> mappedFile = std::make_shared<MappedDataSetFile>(fileName);
+    if(!mappedFile->isMapped())
+    {
+        return nullptr;
+    }
+    return mappedFile;
+}
+
+MappedDataSetFile::MappedDataSetFile(QString fileName)
+    : file_(fileName), mapping_(nullptr)
+{
+    if(!file_.open(QFile::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file_);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 flags = 0;
+    qint64 startDateEpoch = 0;
+    qint64 endDateEpoch = 0;
+    quint32 graphCount = 0;
+    stream >> magic >> version >> flags >> startDateEpoch >> endDateEpoch >> graphCount;
+
+    // Only files with uncompressed, aligned columns can be read in place
+    if(magic != BINARY_FILE_MAGIC || version != BINARY_FILE_VERSION || (flags & COMPRESSED_FLAG))
+    {
+        return;
+    }
+
+    startDate_ = QDateTime::fromSecsSinceEpoch(startDateEpoch);
+    endDate_ = QDateTime::fromSecsSinceEpoch(endDateEpoch);
+
+    // Only go through the details of each graph, the data points are skipped
+    for(quint32 i = 0; graphCount > i; i++)
+    {
+        MappedDataSet mappedDataSet = {};
+        readDataSetDetails(stream, version, mappedDataSet.details);
+        stream >> mappedDataSet.pointCount;
+
+        mappedDataSet.timesOffset = alignedPosition(file_.pos());
+        mappedDataSet.valuesOffset = mappedDataSet.timesOffset
+                                     + (qint64)mappedDataSet.pointCount * sizeof(qint64);
+        qint64 endOffset = mappedDataSet.valuesOffset
+                           + (qint64)mappedDataSet.pointCount * sizeof(quint32);
+
+        if(stream.status() != QDataStream::Ok || endOffset > file_.size())
+        {
+            dataSets_.clear();
+            return;
+        }
+
+        dataSets_.push_back(mappedDataSet);
+        file_.seek(endOffset);
+    }
+
+    // Pages of the file are only read once they are accessed
+    mapping_ = file_.map(0, file_.size());
+    if(mapping_ == nullptr)
+    {
+        dataSets_.clear();
+    }
+}
+
+MappedDataSetFile::~MappedDataSetFile()
+{
+    if(mapping_ != nullptr)
+    {
+        file_.unmap(mapping_);
+    }
+}
+
+bool MappedDataSetFile::isMapped() const
+{
+    return mapping_ != nullptr;
+}
+
+std::pair<QDateTime, QDateTime> MappedDataSetFile::getTimeInterval() const
+{
+    return {startDate_, endDate_};
+}
+
+std::vector<DataSet> MappedDataSetFile::getDataSets(qint64 startSecs, qint64 endSecs) const
+{
+    std::vector<DataSet> dataSets;
+    for(int i = 0; (int)dataSets_.size() > i; i++)
+    {
+        DataSet dataSet = dataSets_[i].details;
+        dataSet.data = readData(i, startSecs, endSecs);
+
+        // Only the given time interval is read
+        DataImporting::IntervalSet coverage;
+        for(const DataImporting::TimeInterval& interval : dataSet.coverage.covered(startSecs, endSecs))
+        {
+            coverage.add(interval.first, interval.second);
+        }
+        dataSet.coverage = coverage;
+
+        dataSets.push_back(dataSet);
+    }
+    return dataSets;
+}
+
+int MappedDataSetFile::findDataSet(DataSourceDetails dataSource) const
+{
+    for(int i = 0; (int)dataSets_.size() > i; i++)
+    {
+        if(dataSets_[i].details.dataSource == dataSource)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+DataSet MappedDataSetFile::getDataSetDetails(int index) const
+{
+    return dataSets_.at(index).details;
+}
+
+DataImporting::TimeSeries MappedDataSetFile::readData(int index, qint64 startSecs, qint64 endSecs) const
+{
+    const MappedDataSet& mappedDataSet = dataSets_.at(index);
+    const char* times = reinterpret_cast<const char*>(mapping_) + mappedDataSet.timesOffset;
+    const char* values = reinterpret_cast<const char*>(mapping_) + mappedDataSet.valuesOffset;
+
+    // Binary search the first time inside the interval so that only its pages get read
+    quint32 first = 0;
+    quint32 last = mappedDataSet.pointCount;
+    while(first < last)
+    {
+        quint32 middle = first + (last - first) / 2;
+        if(qFromLittleEndian<qint64>(times + middle * sizeof(qint64)) < startSecs)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    DataImporting::TimeSeries data;
+    for(quint32 i = first; mappedDataSet.pointCount > i; i++)
+    {
+        qint64 time = qFromLittleEndian<qint64>(times + i * sizeof(qint64));
+        if(time > endSecs)
+        {
+            break;
+        }
+        data.append(time, decodeValue(values + i * sizeof(quint32)));
+    }
+    return data;
+}
+
 void CacheFileHandler::savePreference(std::vector<DataSourceDetails> savedPreference, QString fileName)
 {
     QFile file(fileName);
@@ -12,6 +12,9 @@
 #include <QXmlStreamWriter>
 #include <QtXml>
 #include <QFile>
+#include <memory>
+
+class MappedDataSetFile;
 
 /**
  * @brief The CacheFileHandler class saves/reads data sets and preferences to/from
@@ -29,12 +32,31 @@ public:
     static void saveDataSet(std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> savedDataSet, QString fileName);
 
     /**
-     * @brief readDataSet reads a data set and stores data so it can be used.
+     * @brief saveDataSetBinary saves given data set into a binary file, which is much smaller and
+     * faster to read than an xml file.
+     * @param savedDataSet contains data of the data set.
+     * @param fileName is the name of the file in which data will be saved.
+     * @param compress tells if the data points are compressed. Compressed files can't be mapped.
+     */
+    static void saveDataSetBinary(std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> savedDataSet,
+                                  QString fileName, bool compress = false);
+
+    /**
+     * @brief readDataSet reads a data set and stores data so it can be used. The file can be
+     * either an xml or a binary file, the format is detected from its contents.
      * @param fileName is the name of the file from which data will be read.
      * @return the stored data set.
      */
     static std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> readDataSet(QString fileName);
 
+    /**
+     * @brief mapDataSet maps an uncompressed binary data set file into memory so that its data
+     * points can be read lazily.
+     * @param fileName is the name of the file to map.
+     * @return the mapped file, or nullptr if the file can't be mapped.
+     */
+    static std::shared_ptr<MappedDataSetFile> mapDataSet(QString fileName);
+
     /**
      * @brief savePreference saves given preference into an xml file.
      * @param savedPreference contains data of each given data source.
@@ -52,6 +74,117 @@ public:
 private:
     // Don't allow creating an instance of this object
     CacheFileHandler() {};
+
+    /**
+     * @brief readDataSetXml reads a data set from an xml file.
+     * @param fileName is the name of the file from which data will be read.
+     * @return the stored data set.
+     */
+    static std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> readDataSetXml(QString fileName);
+
+    /**
+     * @brief readDataSetBinary reads a data set from a binary file.
+     * @param fileName is the name of the file from which data will be read.
+     * @return the stored data set, which is empty if the file is broken.
+     */
+    static std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> readDataSetBinary(QString fileName);
+
+    /**
+     * @brief isBinaryDataSetFile checks if a file is a binary data set file.
+     * @param fileName is the name of the file to check.
+     * @return true if the file starts like a binary data set file, false otherwise.
+     */
+    static bool isBinaryDataSetFile(QString fileName);
+};
+
+/**
+ * @brief The MappedDataSetFile class keeps a binary data set file mapped into memory. Only the
+ * details of each graph are read when the file is opened, data points are read from the mapping
+ * when asked for, so only the pages containing them get loaded.
+ */
+class MappedDataSetFile
+{
+public:
+    /**
+     * @brief MappedDataSetFile maps the given file. Check isMapped to see if it succeeded.
+     * @param fileName is the name of the file to map.
+     */
+    explicit MappedDataSetFile(QString fileName);
+
+    /**
+     * @brief ~MappedDataSetFile unmaps the file.
+     */
+    ~MappedDataSetFile();
+
+    /**
+     * @brief isMapped checks if the file was mapped.
+     * @return true if the file is an uncompressed binary data set file and it was mapped.
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief getTimeInterval returns the time interval shown when the file was saved.
+     * @return the start and end of the time interval.
+     */
+    std::pair<QDateTime, QDateTime> getTimeInterval() const;
+
+    /**
+     * @brief getDataSets reads the data sets of the file, with only the data points in the given
+     * time interval.
+     * @param startSecs is the start of the time interval.
+     * @param endSecs is the end of the time interval.
+     * @return the data sets.
+     */
+    std::vector<DataSet> getDataSets(qint64 startSecs, qint64 endSecs) const;
+
+    /**
+     * @brief findDataSet finds the data set of a data source.
+     * @param dataSource is the data source to look for.
+     * @return the index of the data set, or -1 if the file has none for the data source.
+     */
+    int findDataSet(DataSourceDetails dataSource) const;
+
+    /**
+     * @brief getDataSetDetails returns the details of a data set without reading its data points.
+     * @param index is the index of the data set.
+     * @return the data set without data points.
+     */
+    DataSet getDataSetDetails(int index) const;
+
+    /**
+     * @brief readData reads the data points of a data set in the given time interval.
+     * @param index is the index of the data set.
+     * @param startSecs is the start of the time interval.
+     * @param endSecs is the end of the time interval.
+     * @return the data points.
+     */
+    DataImporting::TimeSeries readData(int index, qint64 startSecs, qint64 endSecs) const;
+
+private:
+    /**
+     * @brief The MappedDataSet struct contains the details of a data set and where its data
+     * point columns are in the file.
+     */
+    struct MappedDataSet
+    {
+        DataSet details;
+        quint32 pointCount;
+        qint64 timesOffset;
+        qint64 valuesOffset;
+    };
+
+    // The mapped file
+    QFile file_;
+
+    // Start of the mapped memory, nullptr if the file isn't mapped
+    uchar* mapping_;
+
+    // Time interval shown when the file was saved
+    QDateTime startDate_;
+    QDateTime endDate_;
+
+    // Data sets of the file
+    std::vector<MappedDataSet> dataSets_;
 };
 
 #endif // CACHEFILEHANDLER_H
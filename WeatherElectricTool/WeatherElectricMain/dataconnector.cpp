@@ -7,27 +7,96 @@
 #include "dataconnector.h"
 #include "cachefilehandler.h"
 
+#include <QTimer>
+
 DataConnector::DataConnector(QObject* parent)
-    : QObject(parent)
+    // Serve previously fetched data from the disk cache when possible
+    : DataConnector({new DataImporting::CachingDataImporter(new DataImporting::FmiDataImporter),
+                     new DataImporting::CachingDataImporter(new DataImporting::FingridDataImporter)},
+                    parent)
 {
-    dataImporters_ = {new DataImporting::FmiDataImporter,
-                      new DataImporting::FingridDataImporter};
+}
 
+DataConnector::DataConnector(std::vector<DataImporting::DataImporter*> dataImporters, QObject* parent)
+    : QObject(parent), dataImporters_(dataImporters), seriesResolution_(DEFAULT_SERIES_RESOLUTION),
+      bucketSecs_(1)
+{
     for(auto dataImporter : dataImporters_)
     {
         connect(dataImporter, &DataImporting::DataImporter::dataFetched,
                 this, &DataConnector::save_data);
+        connect(dataImporter, &DataImporting::DataImporter::fetchProgressed,
+                this, &DataConnector::relayFetchProgress);
+        connect(dataImporter, &DataImporting::DataImporter::fetchCancelled,
+                this, &DataConnector::forgetCancelledFetch);
+        connect(dataImporter, &DataImporting::DataImporter::segmentDownloaded,
+                this, &DataConnector::journalSegment);
     }
 
     // Set default time period to be the from past week
     startDateTime_ = QDateTime::currentDateTime().addDays(-7);
     endDateTime_ = QDateTime::currentDateTime();
+
+    replayJournal();
+
+    bucketSecs_ = calcBucketSecs(startDateTime_, endDateTime_);
+
+    // Fetch data inside the shown time period first
+    for(auto dataImporter : dataImporters_)
+    {
+        dataImporter->setVisibleTimeRange(startDateTime_, endDateTime_);
+    }
 }
 
 DataConnector::~DataConnector()
 {
 }
 
+void DataConnector::replayJournal()
+{
+    for(DataImporting::JournalEntry& entry : journal_.replay(startDateTime_.toSecsSinceEpoch(),
+                                                             endDateTime_.toSecsSinceEpoch()))
+    {
+        // Data that has to be fetched again anyway isn't worth keeping
+        std::vector<DataImporting::TimeInterval> intervals = entry.coverage.intervals();
+        auto importerIt = std::find_if(dataImporters_.begin(), dataImporters_.end(),
+                                       [&entry](DataImporting::DataImporter* importer)
+        {
+            return importer->getSourceName() == entry.sourceName;
+        });
+        if(intervals.empty() || importerIt == dataImporters_.end())
+        {
+            continue;
+        }
+
+        // Same key as fetched data gets in save_data
+        DataSourceDetails dataSource = {entry.sourceName,
+                                        entry.dataLocation,
+                                        DataImporting::getDataTypeName(entry.dataType) + ", "
+                                        + entry.dataLocation, 0,
+                                        entry.dataType};
+        DataImporting::DataFetchDetails fetchDetails = {entry.dataType,
+                                                        entry.dataLocation,
+                                                        entry.unitOfMeasurement,
+                                                        *importerIt,
+                                                        QDateTime::fromSecsSinceEpoch(intervals.front().first),
+                                                        QDateTime::fromSecsSinceEpoch(intervals.back().second),
+                                                        entry.maxValue,
+                                                        entry.minValue};
+        allData_[dataSource] = {fetchDetails, entry.data};
+        fetchedIntervals_[dataSource] = entry.coverage;
+
+        rollups_[dataSource].clear();
+        aggregates_[dataSource].clear();
+        if(!entry.data.empty())
+        {
+            rollups_[dataSource].update(entry.data, entry.data.timeAt(0),
+                                        entry.data.timeAt(entry.data.size() - 1));
+            aggregates_[dataSource].update(entry.data, entry.data.timeAt(0));
+        }
+    }
+}
+
 std::vector<DataSourceDetails> DataConnector::getAllDataSourceDetails()
 {
     std::vector<DataSourceDetails> dataSD;
@@ -79,10 +148,7 @@ void DataConnector::addActiveDataSource(DataSourceDetails dataSource)
             if(dataImporter->canFetchDataType(DataType))
             {
                 activeDataSources_.push_back(dataSource);
-                dataImporter->fetchData(DataType,
-                                        startDateTime_,
-                                        endDateTime_,
-                                        dataSource.dataLocationName);
+                fetchMissingData(dataSource, dataImporter, startDateTime_, endDateTime_);
             }
         }
     }
@@ -92,81 +158,38 @@ void DataConnector::reAddActiveDataSource(DataSourceDetails dataSource)
 {
     auto it = allData_.find(dataSource);
     auto importer = it->second.first.importer;
-    auto old_data = it->second.second;
-
-    // Start and end dates of old data's time interval
-    QDateTime startDate = it->second.first.startDateTime;
-    QDateTime endDate = it->second.first.endDateTime;
-
-    // If time interval changed completely, erase previous data
-    if(startDateTime_ >= endDate || endDateTime_ <= startDate)
-    {
-        allData_.erase(it);
-        auto DataSource = std::find(activeDataSources_.begin(), activeDataSources_.end(), dataSource);
-        activeDataSources_.erase(DataSource);
 
-        addActiveDataSource(dataSource);
-    }
-    // Get more data to the heads of previous data if needed
-    else
+    // Only fetch the parts of the time interval that don't exist yet, the rest is re-used
+    if(!fetchMissingData(dataSource, importer, startDateTime_, endDateTime_))
     {
-        // Fetch new data from the front and end of old data
-        if(startDate > startDateTime_ && endDate < endDateTime_)
-        {
-            importer->fetchData(dataSource.dataType,
-                                startDateTime_,
-                                startDate,
-                                dataSource.dataLocationName);
-            importer->fetchData(dataSource.dataType,
-                                endDate,
-                                endDateTime_,
-                                dataSource.dataLocationName);
-        }
-        // Fetch new data from the front of old data
-        else if(startDate > startDateTime_)
-        {
-            importer->fetchData(dataSource.dataType,
-                                startDateTime_,
-                                startDate,
-                                dataSource.dataLocationName);
-        }
-        // Fetch new data from the end of old data
-         else if(endDate < endDateTime_)
-        {
-            importer->fetchData(dataSource.dataType,
-                                endDate,
-                                endDateTime_,
-                                dataSource.dataLocationName);
-        }
         // Data from new boundaries already exist
-        else
-        {
-            float maxY = it->second.first.maxValue;
-            float minY = it->second.first.minValue;
-            QSplineSeries* series = makeSeries(old_data, maxY, minY);
-
-            float magnitude = calcMagnitude(series);
-            DataSeries dataSeries = {it->second.first.unitOfMeasurement,
-                                     series,
-                                     nullptr,
-                                     maxY,
-                                     minY,
-                                     magnitude};
-            data_.insert({it->first.graphName, dataSeries});
-            emit data_saved();
-        }
+        float maxY = it->second.first.maxValue;
+        float minY = it->second.first.minValue;
+        float magnitude = 0;
+        QLineSeries* series = makeSeries(it->second.second, maxY, minY, magnitude,
+                                           &rollups_[it->first], &aggregates_[it->first]);
+
+        DataSeries dataSeries = {it->second.first.unitOfMeasurement,
+                                 series,
+                                 nullptr,
+                                 maxY,
+                                 minY,
+                                 magnitude};
+        data_.insert({it->first.graphName, dataSeries});
+        emit data_saved();
     }
 }
 
-
-
 void DataConnector::removeActiveDataSource(DataSourceDetails dataSource)
 {
     auto DataSource = std::find(activeDataSources_.begin(), activeDataSources_.end(), dataSource);
     activeDataSources_.erase(DataSource);
 
+    // Data of this data source might still be on its way
     auto dataIter = data_.find(dataSource.graphName);
-    data_.erase(dataIter);
+    if(dataIter != data_.end()){
+        data_.erase(dataIter);
+    }
 }
 
 QDateTime DataConnector::getStartDate()
@@ -187,51 +210,63 @@ void DataConnector::setBoundaryDates(QDateTime newStartDate, QDateTime newEndDat
     endDateTime_ = newEndDate;
     startDateTime_ = newStartDate;
 
-    std::vector<DataSourceDetails>::iterator activeDS_iter = activeDataSources_.begin();
-    while(activeDS_iter != activeDataSources_.end())
+    // Points of series shown with a different bucket length can't be mixed with new ones
+    qint64 newBucketSecs = calcBucketSecs(newStartDate, newEndDate);
+    bool resolutionChanged = newBucketSecs != bucketSecs_;
+    bucketSecs_ = newBucketSecs;
+
+    // Data of the old time period that hasn't arrived yet isn't needed anymore. The cancelled
+    // parts are forgotten right away, so the ones still needed are fetched again below.
+    for(auto dataImporter : dataImporters_)
+    {
+        dataImporter->setVisibleTimeRange(startDateTime_, endDateTime_);
+        dataImporter->cancelFetchesOutside(startDateTime_, endDateTime_);
+    }
+
+    // Active data sources get removed and re-added below, so go through a copy
+    std::vector<DataSourceDetails> activeDataSources = activeDataSources_;
+
+    for(DataSourceDetails& dataSource : activeDataSources)
     {
-        auto it = allData_.find(*activeDS_iter);
+        auto it = allData_.find(dataSource);
 
-        if(it == allData_.end()){
-            break;
+        // First fetch of this data source is still on its way
+        if(it == allData_.end())
+        {
+            fetchMissingData(dataSource, dataImporters_.at(dataSource.dataSourceIndex),
+                             newStartDate, newEndDate);
+            continue;
         }
 
-        // Delete old data if new time boundary isn't within the old one
-        if(newStartDate >= oldEndDate || newEndDate <= oldStartDate)
+        // Rebuild series if new time boundary isn't within the old one or the resolution changed
+        if(newStartDate >= oldEndDate || newEndDate <= oldStartDate || resolutionChanged)
         {
-            DataSourceDetails dSource = it->first;
-            allData_.erase(it);
-            removeActiveDataSource(dSource);
+            removeActiveDataSource(dataSource);
 
-            emit reAddSeries(dSource);
-            addActiveDataSource(dSource);
+            emit reAddSeries(dataSource);
+            addActiveDataSource(dataSource);
         }
         // Modify the heads of current old series
         else
         {
             auto importer = it->second.first.importer;
-            auto old_data = it->second.second;
+            DataImporting::TimeSeries& old_data = it->second.second;
 
             auto oldDataIter = data_.find(it->first.graphName);
 
-
-
-            // Start and end dates of old data's time interval
-            QDateTime startDate = it->second.first.startDateTime;
-            QDateTime endDate = it->second.first.endDateTime;
-
             // Remove points from the active series if needed
-            if(oldEndDate > newEndDate || oldStartDate < newStartDate)
+            if(oldDataIter != data_.end() && (oldEndDate > newEndDate || oldStartDate < newStartDate))
             {
                 float newMaxY = it->second.first.maxValue;
                 float newMinY = it->second.first.minValue;
-                QSplineSeries* new_ser = makeSeries(old_data, newMaxY, newMinY);
+                float newMagnitude = 0;
+                QLineSeries* new_ser = makeSeries(old_data, newMaxY, newMinY, newMagnitude,
+                                                    &rollups_[it->first], &aggregates_[it->first]);
 
-                removeFromActiveSeries(oldDataIter->second.splineSeries, new_ser,
+                removeFromActiveSeries(oldDataIter->second.lineSeries, new_ser,
                                        it->first.graphName);
 
                 data_.erase(oldDataIter);
-                float newMagnitude = calcMagnitude(new_ser);
                 DataSeries dataSeries = {it->second.first.unitOfMeasurement,
                                          new_ser,
                                          nullptr,
@@ -240,17 +275,19 @@ void DataConnector::setBoundaryDates(QDateTime newStartDate, QDateTime newEndDat
                                          newMagnitude};
                 data_.insert({it->first.graphName, dataSeries});
 
-                emit updateCharts(activeDS_iter->graphName, newMagnitude, newMaxY, newMinY);
+                emit updateCharts(dataSource.graphName, newMagnitude, newMaxY, newMinY);
             }
             // Time boundary widened from start
             if(oldStartDate > newStartDate)
             {
-                // Add data to the start of active series if it already exists
-                if(oldStartDate > startDate)
+                // Add data that already exists to the start of active series
+                float magnitude = 0;
+                std::pair<QLineSeries*, std::pair<float, float>> start_SPser =
+                        makeSnippetSeries(old_data, oldStartDate, true, magnitude,
+                                          &rollups_[it->first], &aggregates_[it->first]);
+
+                if(start_SPser.first->count() > 0)
                 {
-                    std::pair<QSplineSeries*, std::pair<float, float>> start_SPser =
-                            makeSnippetSeries(old_data, oldStartDate, true);
-                    float magnitude = calcMagnitude(start_SPser.first);
                     DataSeries start_ser = {it->second.first.unitOfMeasurement,
                                             start_SPser.first,
                                             nullptr,
@@ -260,24 +297,25 @@ void DataConnector::setBoundaryDates(QDateTime newStartDate, QDateTime newEndDat
 
                     addToActiveSeries(it->first.graphName, start_ser, true);
                 }
-                // Fetch new data from the front of old data if needed
-                if(startDate > newStartDate)
+                else
                 {
-                    importer->fetchData(activeDS_iter->dataType,
-                                        newStartDate,
-                                        startDate,
-                                        activeDS_iter->dataLocationName);
+                    delete start_SPser.first;
                 }
+
+                // Fetch the gaps in the new part
+                fetchMissingData(dataSource, importer, newStartDate, oldStartDate);
             }
             // Time boundary widened from end
             if(oldEndDate < newEndDate)
             {
-                // Add data to the end of active series of it already exists
-                if(oldEndDate < endDate)
+                // Add data that already exists to the end of active series
+                float magnitude = 0;
+                std::pair<QLineSeries*, std::pair<float, float>> end_SPser =
+                        makeSnippetSeries(old_data, oldEndDate, false, magnitude,
+                                          &rollups_[it->first], &aggregates_[it->first]);
+
+                if(end_SPser.first->count() > 0)
                 {
-                    std::pair<QSplineSeries*, std::pair<float, float>> end_SPser =
-                            makeSnippetSeries(old_data, oldEndDate, false);
-                    float magnitude = calcMagnitude(end_SPser.first);
                     DataSeries end_ser = {it->second.first.unitOfMeasurement,
                                           end_SPser.first,
                                           nullptr,
@@ -287,56 +325,204 @@ void DataConnector::setBoundaryDates(QDateTime newStartDate, QDateTime newEndDat
 
                     addToActiveSeries(it->first.graphName, end_ser, false);
                 }
-                // Fetch new data from the end of old data if needed
-                if(endDate < newEndDate){
-                    importer->fetchData(activeDS_iter->dataType,
-                                        endDate,
-                                        newEndDate,
-                                        activeDS_iter->dataLocationName);
+                else
+                {
+                    delete end_SPser.first;
                 }
+
+                // Fetch the gaps in the new part
+                fetchMissingData(dataSource, importer, oldEndDate, newEndDate);
             }
-            activeDS_iter++;
         }
     }
 }
 
-float DataConnector::calcMagnitude(QSplineSeries *series)
+bool DataConnector::fetchMissingData(DataSourceDetails dataSource,
+                                     DataImporting::DataImporter* importer,
+                                     QDateTime startDate, QDateTime endDate)
 {
-    float magnitude = 0;
-    for(int i = 0; series->count() > i; i++){
-        magnitude += series->at(i).y();
+    // Data that is still being fetched doesn't need to be fetched again
+    DataImporting::IntervalSet knownIntervals = fetchedIntervals_[dataSource];
+    knownIntervals.add(pendingIntervals_[dataSource]);
+
+    std::vector<DataImporting::TimeInterval> gaps =
+            knownIntervals.gaps(startDate.toSecsSinceEpoch(), endDate.toSecsSinceEpoch());
+
+    for(DataImporting::TimeInterval& gap : gaps)
+    {
+        pendingIntervals_[dataSource].add(gap.first, gap.second);
+
+        // Parts stored in a loaded data set file don't need to be fetched
+        DataImporting::IntervalSet archivedParts = loadArchivedData(dataSource, gap.first, gap.second);
+
+        for(DataImporting::TimeInterval& missingPart : archivedParts.gaps(gap.first, gap.second))
+        {
+            importer->fetchData(dataSource.dataType,
+                                QDateTime::fromSecsSinceEpoch(missingPart.first),
+                                QDateTime::fromSecsSinceEpoch(missingPart.second),
+                                dataSource.dataLocationName);
+        }
     }
-    return magnitude;
+    return !gaps.empty();
+}
+
+DataImporting::IntervalSet DataConnector::loadArchivedData(DataSourceDetails dataSource,
+                                                           qint64 startSecs, qint64 endSecs)
+{
+    DataImporting::IntervalSet archivedParts;
+    int archiveIndex = archive_ != nullptr ? archive_->findDataSet(dataSource) : -1;
+    if(archiveIndex < 0)
+    {
+        return archivedParts;
+    }
+
+    std::shared_ptr<MappedDataSetFile> archive = archive_;
+    DataSet details = archive->getDataSetDetails(archiveIndex);
+    DataImporting::DataImporter* importer = dataImporters_.at(dataSource.dataSourceIndex);
+
+    for(const DataImporting::TimeInterval& part : details.coverage.covered(startSecs, endSecs))
+    {
+        archivedParts.add(part.first, part.second);
+
+        // Pass the data on like fetched data once the caller is done, only then is it read
+        QTimer::singleShot(0, this, [this, archive, archiveIndex, details, importer, part]()
+        {
+            std::shared_ptr<DataImporting::TimeSeries> data = std::make_shared<DataImporting::TimeSeries>(
+                        archive->readData(archiveIndex, part.first, part.second));
+            std::pair<float, float> minMax = data->minMaxValues();
+
+            DataImporting::DataFetchDetails fetchDetails = {details.dataSource.dataType,
+                                                            details.dataSource.dataLocationName,
+                                                            details.series.unitOfMeasurement,
+                                                            importer,
+                                                            QDateTime::fromSecsSinceEpoch(part.first),
+                                                            QDateTime::fromSecsSinceEpoch(part.second),
+                                                            data->empty() ? INT_MIN : minMax.second,
+                                                            data->empty() ? INT_MAX : minMax.first};
+            save_data(fetchDetails, data);
+        });
+    }
+    return archivedParts;
+}
+
+void DataConnector::addUnreadArchivedData(DataSourceDetails dataSource,
+                                          DataImporting::TimeSeries& data,
+                                          DataImporting::IntervalSet& coverage)
+{
+    int archiveIndex = archive_ != nullptr ? archive_->findDataSet(dataSource) : -1;
+    if(archiveIndex < 0)
+    {
+        return;
+    }
+
+    DataSet details = archive_->getDataSetDetails(archiveIndex);
+    for(const DataImporting::TimeInterval& part : details.coverage.intervals())
+    {
+        for(const DataImporting::TimeInterval& gap : coverage.gaps(part.first, part.second))
+        {
+            // Gaps share their ends with the covered parts, whose points are newer
+            qint64 startSecs = coverage.covers(gap.first, gap.first) ? gap.first + 1 : gap.first;
+            qint64 endSecs = coverage.covers(gap.second, gap.second) ? gap.second - 1 : gap.second;
+            if(startSecs > endSecs)
+            {
+                continue;
+            }
+
+            data.replaceRange(startSecs, endSecs, archive_->readData(archiveIndex, startSecs, endSecs));
+        }
+    }
+    coverage.add(details.coverage);
+}
+
+void DataConnector::setSeriesResolution(int pointCount)
+{
+    seriesResolution_ = std::max(pointCount, 2);
+}
+
+qint64 DataConnector::calcBucketSecs(QDateTime startDate, QDateTime endDate)
+{
+    // Each bucket is shown as at most two points
+    qint64 bucketCount = seriesResolution_ / 2;
+    qint64 intervalSecs = startDate.secsTo(endDate);
+
+    // Bucket lengths are rounded up so that small changes of the time interval keep the same
+    // buckets and long buckets can be made of rollups
+    return DataImporting::RollupPyramid::bucketLength((intervalSecs + bucketCount - 1) / bucketCount);
 }
 
 void DataConnector::saveCurrentDataSets(QString fileName)
 {
+    // Xml files are still supported, but everything else is saved in the smaller binary format
+    bool saveXml = fileName.endsWith(".xml", Qt::CaseInsensitive);
 
     std::vector<DataSet> dataSets = {};
     for(DataSourceDetails dsd : activeDataSources_)
     {
         auto it = data_.find(dsd.graphName);
+        auto dataIter = allData_.find(dsd);
+
+        // Save every data point, not just the shown ones. Binary files also get the data outside
+        // of the time interval, which is read from them only if it's shown later.
+        DataImporting::TimeSeries data;
+        DataImporting::IntervalSet coverage;
+        if(dataIter != allData_.end() && saveXml)
+        {
+            data = dataIter->second.second.slice(startDateTime_.toSecsSinceEpoch() + 1,
+                                                 endDateTime_.toSecsSinceEpoch() - 1);
+        }
+        else if(!saveXml)
+        {
+            if(dataIter != allData_.end())
+            {
+                data = dataIter->second.second;
+                coverage = fetchedIntervals_[dsd];
+            }
+            addUnreadArchivedData(dsd, data, coverage);
+        }
         DataSet dSet = {0,
                         dsd,
-                        it->second};
+                        it->second,
+                        data,
+                        coverage};
         dataSets.push_back(dSet);
     }
-    CacheFileHandler::saveDataSet({{startDateTime_, endDateTime_},  dataSets}, fileName);
+    if(saveXml)
+    {
+        CacheFileHandler::saveDataSet({{startDateTime_, endDateTime_},  dataSets}, fileName);
+    }
+    else
+    {
+        CacheFileHandler::saveDataSetBinary({{startDateTime_, endDateTime_},  dataSets}, fileName);
+    }
 }
 
 void DataConnector::loadDataSets(QString fileName)
 {
-    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> data =
-                                    CacheFileHandler::readDataSet(fileName);
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> data;
+
+    // Only the shown time interval is read from mapped files, the rest is read when it's needed
+    std::shared_ptr<MappedDataSetFile> mappedFile = CacheFileHandler::mapDataSet(fileName);
+    if(mappedFile != nullptr)
+    {
+        std::pair<QDateTime, QDateTime> timeInterval = mappedFile->getTimeInterval();
+        data = {timeInterval, mappedFile->getDataSets(timeInterval.first.toSecsSinceEpoch(),
+                                                      timeInterval.second.toSecsSinceEpoch())};
+    }
+    else
+    {
+        data = CacheFileHandler::readDataSet(fileName);
+    }
 
     std::vector<DataSet> dataSets = data.second;
     if(dataSets.size() != 0)
     {
         clearAllActiveData();
+        archive_ = mappedFile;
         startDateTime_ = data.first.first;
         endDateTime_ = data.first.second;
+        bucketSecs_ = calcBucketSecs(startDateTime_, endDateTime_);
 
-        for(DataSet dataSet : dataSets)
+        for(const DataSet& dataSet : dataSets)
         {
             DataSourceDetails dataSource = dataSet.dataSource;
             DataSeries dataSeries = dataSet.series;
@@ -347,7 +533,12 @@ void DataConnector::loadDataSets(QString fileName)
             }
             float curMaxY = dataSet.series.maxY;
             float curMinY = dataSet.series.minY;
-            std::vector<DataImporting::DataPoint> dataPoints = makeDataPoints(dataSet.series.splineSeries, curMaxY, curMinY);
+            if(!dataSet.data.empty())
+            {
+                std::pair<float, float> minMax = dataSet.data.minMaxValues();
+                curMaxY = std::max(curMaxY, minMax.second);
+                curMinY = std::min(curMinY, minMax.first);
+            }
 
             DataImporting::DataImporter* importer = dataImporters_.at(dataSource.dataSourceIndex);
 
@@ -360,7 +551,24 @@ void DataConnector::loadDataSets(QString fileName)
                                                             curMaxY,
                                                             curMinY};
 
-            allData_.insert({dataSource, {fetchDetails, dataPoints}});
+            allData_.insert({dataSource, {fetchDetails, dataSet.data}});
+
+            rollups_[dataSource].clear();
+            aggregates_[dataSource].clear();
+            if(!dataSet.data.empty())
+            {
+                rollups_[dataSource].update(dataSet.data, dataSet.data.timeAt(0),
+                                            dataSet.data.timeAt(dataSet.data.size() - 1));
+                aggregates_[dataSource].update(dataSet.data, dataSet.data.timeAt(0));
+            }
+
+            // Older files don't tell which time intervals their data covers
+            fetchedIntervals_[dataSource] = dataSet.coverage;
+            if(dataSet.coverage.empty())
+            {
+                fetchedIntervals_[dataSource].add(startDateTime_.toSecsSinceEpoch(),
+                                                  endDateTime_.toSecsSinceEpoch());
+            }
             emit addSourceWidget(dataSource);
         }
     }
@@ -389,97 +597,98 @@ std::vector<DataSourceDetails> DataConnector::getActiveDataSources()
     return activeDataSources_;
 }
 
-std::vector<DataImporting::DataPoint> DataConnector::makeDataPoints(QSplineSeries *series, float& maxY, float& minY)
+QLineSeries* DataConnector::makeSeries(const DataImporting::TimeSeries& data_vec, float& maxY, float& minY,
+                                         float& magnitude, const DataImporting::RollupPyramid* rollups,
+                                         const DataImporting::WindowAggregates* aggregates)
+{
+    // Only use data that is within requested time interval
+    qint64 startSecs = startDateTime_.toSecsSinceEpoch() + 1;
+    qint64 endSecs = endDateTime_.toSecsSinceEpoch() - 1;
+
+    if(rollups != nullptr && aggregates != nullptr)
+    {
+        return makeSeriesFromRollups(data_vec, *rollups, *aggregates, startSecs, endSecs,
+                                     maxY, minY, magnitude);
+    }
+    return makeSeriesFromView(data_vec.view(startSecs, endSecs), maxY, minY, magnitude);
+}
+
+std::pair<QLineSeries*, std::pair<float, float>>DataConnector::makeSnippetSeries
+(const DataImporting::TimeSeries& data_vec, QDateTime oldDateTime, bool isStartDate, float& magnitude,
+ const DataImporting::RollupPyramid* rollups, const DataImporting::WindowAggregates* aggregates)
 {
-    std::vector<DataImporting::DataPoint> dataPoints = {};
+    float maxVal = INT_MIN;
+    float minVal = INT_MAX;
+    qint64 oldSecs = oldDateTime.toSecsSinceEpoch();
+
+    // Use data between start date and old date, or between old date and end date
+    qint64 startSecs = isStartDate ? startDateTime_.toSecsSinceEpoch() : oldSecs + 1;
+    qint64 endSecs = isStartDate ? oldSecs - 1 : endDateTime_.toSecsSinceEpoch();
 
-    for(int i = 0; series->count() > i; i++){
-        float value = series->at(i).y();
-        DataImporting::DataPoint dataPoint = {QDateTime::fromSecsSinceEpoch(series->at(i).x()), value};
-        dataPoints.push_back(dataPoint);
+    QLineSeries* series = rollups != nullptr && aggregates != nullptr
+        ? makeSeriesFromRollups(data_vec, *rollups, *aggregates, startSecs, endSecs,
+                                maxVal, minVal, magnitude)
+        : makeSeriesFromView(data_vec.view(startSecs, endSecs), maxVal, minVal, magnitude);
+
+    return {series, {maxVal, minVal}};
+}
 
+QLineSeries* DataConnector::makeSeriesFromView(const DataImporting::TimeSeriesView& data_view,
+                                                 float& maxY, float& minY, float& magnitude)
+{
+    QLineSeries* series = new QLineSeries;
+
+    // Values and magnitude are calculated from every data point so that pie and bar charts stay exact
+    data_view.forEachPoint([&maxY, &minY, &magnitude](qint64, float value)
+    {
+        magnitude += value;
         if(maxY < value){
             maxY = value;
         }
         if(minY > value){
             minY = value;
         }
-    }
-    return dataPoints;
-}
-
-QSplineSeries* DataConnector::makeSeries(std::vector<DataImporting::DataPoint> data_vec, float& maxY, float& minY)
-{
-    QSplineSeries* series = new QSplineSeries;
+    });
 
-    // Transfer data to QSplineSeries
-    for(auto dataPoint : data_vec)
+    // Transfer only about as many data points as can be drawn to QLineSeries, all at once so
+    // that the series is only updated once
+    QVector<QPointF> points;
+    data_view.forEachDecimatedPoint(bucketSecs_, [&points](qint64 time, float value)
     {
-        // Data is within requested time interval
-        if(dataPoint.dateTime > startDateTime_ && dataPoint.dateTime < endDateTime_)
-        {
-            series->append(QPointF(dataPoint.dateTime.toSecsSinceEpoch(), dataPoint.value));
-            if(maxY < dataPoint.value){
-                maxY = dataPoint.value;
-            }
-            if(minY > dataPoint.value){
-                minY = dataPoint.value;
-            }
-        }
-        if(dataPoint.dateTime > endDateTime_)
-        {
-            break;
-        }
-    }
+        points.append(QPointF(time, value));
+    });
+    series->replace(points);
     return series;
 }
 
-std::pair<QSplineSeries*, std::pair<float, float>>DataConnector::makeSnippetSeries
-(std::vector<DataImporting::DataPoint> data_vec, QDateTime oldDateTime, bool isStartDate)
+QLineSeries* DataConnector::makeSeriesFromRollups(const DataImporting::TimeSeries& data_vec,
+                                                    const DataImporting::RollupPyramid& rollups,
+                                                    const DataImporting::WindowAggregates& aggregates,
+                                                    qint64 startSecs, qint64 endSecs,
+                                                    float& maxY, float& minY, float& magnitude)
 {
-    QSplineSeries* series = new QSplineSeries;
-    float maxVal = INT_MIN;
-    float minVal = INT_MAX;
-    if(isStartDate)
+    QLineSeries* series = new QLineSeries;
+
+    // Values and magnitude for the pie and bar charts are read from the prefix sums and
+    // sparse tables instead of going through the data points. The magnitude stays the sum of
+    // the values like in makeSeriesFromView, so pie slices don't depend on which one is used.
+    DataImporting::WindowSummary summary = aggregates.summarize(data_vec, startSecs, endSecs);
+    if(summary.count > 0)
     {
-        for(auto dataPoint : data_vec)
-        {
-            if(dataPoint.dateTime < oldDateTime && dataPoint.dateTime >= startDateTime_)
-            {
-                series->append(QPointF(dataPoint.dateTime.toSecsSinceEpoch(), dataPoint.value));
-                if(maxVal < dataPoint.value){
-                    maxVal = dataPoint.value;
-                }
-                if(minVal > dataPoint.value){
-                    minVal = dataPoint.value;
-                }
-            }
-            if(dataPoint.dateTime > oldDateTime)
-            {
-                break;
-            }
-        }
+        magnitude += summary.sum;
+        maxY = std::max(maxY, summary.maxValue);
+        minY = std::min(minY, summary.minValue);
     }
-    else
+
+    // Whole hours, days and weeks are decimated with their rollups
+    QVector<QPointF> points;
+    rollups.forEachDecimatedPoint(data_vec, startSecs, endSecs, bucketSecs_,
+                                  [&points](qint64 time, float value)
     {
-        for(auto dataPoint : data_vec)
-        {
-            if(dataPoint.dateTime > endDateTime_){
-                break;
-            }
-            if(dataPoint.dateTime > oldDateTime)
-            {
-                series->append(QPointF(dataPoint.dateTime.toSecsSinceEpoch(), dataPoint.value));
-                if(maxVal < dataPoint.value){
-                    maxVal = dataPoint.value;
-                }
-                if(minVal > dataPoint.value){
-                    minVal = dataPoint.value;
-                }
-            }
-        }
-    }
-    return {series, {maxVal, minVal}};
+        points.append(QPointF(time, value));
+    });
+    series->replace(points);
+    return series;
 }
 
 bool DataConnector::addToActiveSeries(std::string seriesName, DataSeries dataSeries, bool addBefore)
@@ -494,24 +703,32 @@ bool DataConnector::addToActiveSeries(std::string seriesName, DataSeries dataSer
     return false;
 }
 
-void DataConnector::removeFromActiveSeries(QSplineSeries *old_ser, QSplineSeries *new_ser, std::string dataType)
+void DataConnector::removeFromActiveSeries(QLineSeries *old_ser, QLineSeries *new_ser, std::string dataType)
 {
-    int delBeforeIndex = 0;
-    for(int i = 1; old_ser->count() > i; i++)
+    if(new_ser->count() == 0)
     {
-        // Delete points from start to index
-        if(old_ser->at(i) == new_ser->at(0))
-        {
-            delBeforeIndex = i;
-            emit delFromSeries(dataType, delBeforeIndex, true);
-        }
-        // Delete points from index to end
-        if(old_ser->at(i) == (new_ser->at(new_ser->count()-1)))
-        {
-            int delAfterIndex = i - delBeforeIndex;
-            emit delFromSeries(dataType, delAfterIndex, false);
-            break;
-        }
+        return;
+    }
+
+    // Points are in chronological order, so the new ends can be binary searched
+    QVector<QPointF> old_points = old_ser->pointsVector();
+    auto isBefore = [](const QPointF& point, qreal x) { return point.x() < x; };
+
+    int firstIndex = std::lower_bound(old_points.begin(), old_points.end(),
+                                      new_ser->at(0).x(), isBefore) - old_points.begin();
+    int lastIndex = std::lower_bound(old_points.begin() + firstIndex, old_points.end(),
+                                     new_ser->at(new_ser->count()-1).x(), isBefore) - old_points.begin();
+
+    // Delete points from start to index
+    if(firstIndex > 0)
+    {
+        emit delFromSeries(dataType, firstIndex, true);
+    }
+    // Delete points after the new last point
+    if(lastIndex + 1 < old_points.size())
+    {
+        int delAfterIndex = lastIndex + 1 - firstIndex;
+        emit delFromSeries(dataType, delAfterIndex, false);
     }
 }
 
@@ -522,7 +739,7 @@ void DataConnector::clearAllActiveData()
 }
 
 void DataConnector::save_data(DataImporting::DataFetchDetails fetchDetails,
-                              std::shared_ptr<std::vector<DataImporting::DataPoint>> data)
+                              std::shared_ptr<DataImporting::TimeSeries> data)
 {
     DataSourceDetails fetchedDSD = { fetchDetails.importer->getSourceName(),
                                      fetchDetails.dataLocation,
@@ -532,70 +749,129 @@ void DataConnector::save_data(DataImporting::DataFetchDetails fetchDetails,
                                      fetchDetails.dataType };
 
     auto it = allData_.find(fetchedDSD);
-    std::vector<DataImporting::DataPoint>& old_data = it->second.second;
-    QSplineSeries* series = new QSplineSeries();
     float maxY = fetchDetails.maxValue;
     float minY = fetchDetails.minValue;
 
-    bool addDataBeforeSeries = false;
+    qint64 fetchedStartSecs = fetchDetails.startDateTime.toSecsSinceEpoch();
+    qint64 fetchedEndSecs = fetchDetails.endDateTime.toSecsSinceEpoch();
+
+    pendingIntervals_[fetchedDSD].remove(fetchedStartSecs, fetchedEndSecs);
+
+    // An empty segment may be a failed fetch, so its range is left unfetched to be requested again
+    if(!data->empty())
+    {
+        fetchedIntervals_[fetchedDSD].add(fetchedStartSecs, fetchedEndSecs);
+    }
+    // Nothing to add to existing data
+    else if(it != allData_.end())
+    {
+        return;
+    }
 
     // No earlier data of this type exists
     if(it == allData_.end())
     {
-        allData_.insert({fetchedDSD, {fetchDetails, *data}});
-        series = makeSeries(*data, maxY, minY);
+        it = allData_.insert({fetchedDSD, {fetchDetails, *data}}).first;
 
-        startDateTime_ = fetchDetails.startDateTime;
-        endDateTime_ = fetchDetails.endDateTime;
+        rollups_[fetchedDSD].clear();
+        aggregates_[fetchedDSD].clear();
+        if(!data->empty())
+        {
+            rollups_[fetchedDSD].update(*data, data->timeAt(0), data->timeAt(data->size() - 1));
+            aggregates_[fetchedDSD].update(*data, data->timeAt(0));
+        }
     }
-    // New fetched data is added to the end of old data
-    else if(it->second.first.endDateTime == fetchDetails.startDateTime)
+    // New fetched data fills a gap in old data or extends it, existing data points aren't copied
+    else
     {
-        old_data.insert(old_data.end(), data->begin(),data->end());
-        it->second.first.endDateTime= fetchDetails.endDateTime;
-        series = makeSeries(old_data, maxY, minY);
-
-        addDataBeforeSeries = false;
+        DataImporting::DataFetchDetails& oldDetails = it->second.first;
+        it->second.second.replaceRange(fetchedStartSecs, fetchedEndSecs, *data);
+        rollups_[fetchedDSD].update(it->second.second, fetchedStartSecs, fetchedEndSecs);
+        aggregates_[fetchedDSD].update(it->second.second, fetchedStartSecs);
+
+        oldDetails.startDateTime = std::min(oldDetails.startDateTime, fetchDetails.startDateTime);
+        oldDetails.endDateTime = std::max(oldDetails.endDateTime, fetchDetails.endDateTime);
+        oldDetails.maxValue = std::max(oldDetails.maxValue, fetchDetails.maxValue);
+        oldDetails.minValue = std::min(oldDetails.minValue, fetchDetails.minValue);
     }
-    // New fetched data is added to the front of old data
-    else if(it->second.first.startDateTime == fetchDetails.endDateTime)
+
+    auto activeIter = data_.find(fetchedDSD.graphName);
+
+    // Data isn't shown yet, make a series of all of it
+    if(activeIter == data_.end())
     {
-        // Reversing vectors so data can be combined
-        std::reverse(old_data.begin(), old_data.end());
-        std::reverse(data->begin(), data->end());
-        old_data.insert(old_data.end(), data->begin(),data->end());
+        float magnitude = 0;
+        QLineSeries* series = makeSeries(it->second.second, maxY, minY, magnitude,
+                                           &rollups_[fetchedDSD], &aggregates_[fetchedDSD]);
+        DataSeries dataSeries = {fetchDetails.unitOfMeasurement,
+                                 series,
+                                 nullptr,
+                                 maxY,
+                                 minY,
+                                 magnitude};
+        data_.insert({fetchedDSD.graphName, dataSeries});
+
+        emit data_saved();
+        return;
+    }
 
-        // Reverse to get values in back correct order
-        std::reverse(old_data.begin(), old_data.end());
-        std::reverse(data->begin(), data->end());
+    QLineSeries* activeSeries = activeIter->second.lineSeries;
+    int activeCount = activeSeries->count();
 
-        it->second.first.startDateTime = fetchDetails.startDateTime;
-        series = makeSeries(old_data, maxY, minY);
+    bool addDataBeforeSeries = activeCount > 0 && fetchedEndSecs <= activeSeries->at(0).x();
+    bool addDataAfterSeries = activeCount > 0
+                              && fetchedStartSecs >= activeSeries->at(activeCount - 1).x();
 
-        addDataBeforeSeries = true;
+    // New data fell between points of the active series, so it has to be redrawn whole
+    if(!addDataBeforeSeries && !addDataAfterSeries)
+    {
+        float magnitude = 0;
+        QLineSeries* series = makeSeries(it->second.second, maxY, minY, magnitude,
+                                           &rollups_[fetchedDSD], &aggregates_[fetchedDSD]);
+        DataSeries dataSeries = {fetchDetails.unitOfMeasurement,
+                                 series,
+                                 nullptr,
+                                 maxY,
+                                 minY,
+                                 magnitude};
+        data_.erase(activeIter);
+        data_.insert({fetchedDSD.graphName, dataSeries});
+
+        emit reAddSeries(fetchedDSD);
+        emit data_saved();
+        return;
     }
 
-    QSplineSeries* addedSeries = makeSeries(*data, maxY, minY);
-    float addedMagnitude = calcMagnitude(addedSeries);
+    // Only the new data points have to be made into a series
+    float addedMagnitude = 0;
+    QLineSeries* addedSeries = makeSeries(*data, maxY, minY, addedMagnitude);
 
-    // DataSeries of data to be added (if needed) to active data
+    // DataSeries of data to be added to active data
     DataSeries addedDataSeries = {fetchDetails.unitOfMeasurement,
                                   addedSeries,
                                   nullptr,
                                   maxY,
                                   minY,
                                   addedMagnitude};
-    bool isSeriesModified = addToActiveSeries(fetchedDSD.graphName,
-                                              addedDataSeries, addDataBeforeSeries);
 
-    auto dataIter = data_.find(fetchedDSD.graphName);
-    // Old data needs to be deleted from data_ if it exists
-    if(dataIter != data_.end()){
-        data_.erase(dataIter);
-    }
+    // Combine the points of the active series with the new ones instead of going through all the
+    // stored data again. Has to be done before the active series is modified by the graph.
+    QVector<QPointF> points = addDataBeforeSeries ? addedSeries->pointsVector()
+                                                  : activeSeries->pointsVector();
+    points += addDataBeforeSeries ? activeSeries->pointsVector() : addedSeries->pointsVector();
+
+    QLineSeries* series = new QLineSeries();
+    series->replace(points);
+
+    float magnitude = activeIter->second.magnitude + addedMagnitude;
+    maxY = std::max(maxY, activeIter->second.maxY);
+    minY = std::min(minY, activeIter->second.minY);
 
-    float magnitude = calcMagnitude(series);
-    // DataSeries of data that will be activated
+    addToActiveSeries(fetchedDSD.graphName, addedDataSeries, addDataBeforeSeries);
+
+    data_.erase(activeIter);
+
+    // DataSeries of data that is active
     DataSeries dataSeries = {fetchDetails.unitOfMeasurement,
                              series,
                              nullptr,
@@ -604,10 +880,36 @@ void DataConnector::save_data(DataImporting::DataFetchDetails fetchDetails,
                              magnitude};
     data_.insert({fetchedDSD.graphName, dataSeries});
 
-    if(!isSeriesModified){
-        emit data_saved();
-    }
-    else{
-        emit updateCharts(fetchedDSD.graphName, magnitude, maxY, minY);
-    }
+    emit updateCharts(fetchedDSD.graphName, magnitude, maxY, minY);
+}
+
+void DataConnector::forgetCancelledFetch(DataImporting::DataFetchDetails fetchDetails)
+{
+    DataSourceDetails cancelledDSD = { fetchDetails.importer->getSourceName(),
+                                       fetchDetails.dataLocation,
+                                       DataImporting::getDataTypeName(
+                                          fetchDetails.dataType) + ", "
+                                       + fetchDetails.dataLocation, 0,
+                                       fetchDetails.dataType };
+
+    // The cancelled part can be requested again later
+    pendingIntervals_[cancelledDSD].remove(fetchDetails.startDateTime.toSecsSinceEpoch(),
+                                           fetchDetails.endDateTime.toSecsSinceEpoch());
+}
+
+void DataConnector::journalSegment(DataImporting::DataFetchDetails fetchDetails,
+                                   std::shared_ptr<DataImporting::TimeSeries> data)
+{
+    // Only downloaded segments are journaled, cached data is already kept on disk
+    journal_.append(fetchDetails.importer->getSourceName(), fetchDetails.dataType,
+                    fetchDetails.dataLocation, fetchDetails.unitOfMeasurement,
+                    fetchDetails.startDateTime.toSecsSinceEpoch(),
+                    fetchDetails.endDateTime.toSecsSinceEpoch(), *data);
+}
+
+void DataConnector::relayFetchProgress(DataImporting::ApiDataType dataType, std::string dataLocation,
+                                       int receivedSegments, int totalSegments)
+{
+    emit fetchProgress(DataImporting::getDataTypeName(dataType) + ", " + dataLocation,
+                       receivedSegments, totalSegments);
 }
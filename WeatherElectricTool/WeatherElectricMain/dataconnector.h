@@ -10,6 +10,11 @@
 
 #include "DataImporting/fmidataimporter.hh"
 #include "DataImporting/fingriddataimporter.hh"
+#include "DataImporting/cachingdataimporter.hh"
+#include "DataImporting/intervalset.hh"
+#include "DataImporting/datajournal.hh"
+#include "DataImporting/rolluppyramid.hh"
+#include "DataImporting/windowaggregates.hh"
 #include "weathergraph.hh"
 #include "weatherpie.hh"
 #include "weatherbar.hh"
@@ -21,6 +26,8 @@
 #include <algorithm>
 #include <tuple>
 
+class MappedDataSetFile;
+
 /**
  * @brief The DataSourceDetails struct contains information of data type
  */
@@ -40,6 +47,8 @@ struct DataSet{
     int hide;
     DataSourceDetails dataSource;
     DataSeries series;
+    DataImporting::TimeSeries data;
+    DataImporting::IntervalSet coverage;
 };
 
 // Defining == for DataSourceDetails so that it can be compared with others
@@ -68,6 +77,13 @@ public:
      */
     explicit DataConnector(QObject *parent = nullptr);
 
+    /**
+     * @brief DataConnector that gets its data from the given importers instead of the default ones.
+     * @param dataImporters are the DataImporters used, in the order of their data source indices.
+     * @param parent
+     */
+    DataConnector(std::vector<DataImporting::DataImporter*> dataImporters, QObject *parent = nullptr);
+
     /**
      * @brief ~DataConnector
      */
@@ -121,11 +137,11 @@ public:
     void setBoundaryDates(QDateTime newStartDate, QDateTime newEndDate);
 
     /**
-     * @brief calcMagnitude calculates the magnitude of given series
-     * @param series contains points from which magnitude is calculated
-     * @return magnitude of the series
+     * @brief setSeriesResolution sets about how many points a series is reduced to for drawing.
+     * Takes effect when the time interval is set next time.
+     * @param pointCount is the number of points, usually the width of the chart in pixels.
      */
-    float calcMagnitude(QSplineSeries* series);
+    void setSeriesResolution(int pointCount);
 
     /**
      * @brief saveCurrentDataSets saves current data into DataSets.
@@ -203,17 +219,56 @@ signals:
      */
     void addSourceWidget(DataSourceDetails dataSource);
 
+    /**
+     * @brief fetchProgress is a signal that is emitted whenever a segment of requested data
+     * has been received.
+     * @param dataSeriesName is the name of the series the data is fetched for.
+     * @param receivedSegments is how many segments of the data have been received.
+     * @param totalSegments is how many segments the data was split into.
+     */
+    void fetchProgress(std::string dataSeriesName, int receivedSegments, int totalSegments);
+
 private slots:
     /**
      * @brief save_data recieves fetched data and saves it into a map.
      * @param fetchDetails: The details of the data retrieved.
-     * @param data: The data in a vector.
+     * @param data: The data as a time series.
      */
     void save_data(DataImporting::DataFetchDetails fetchDetails,
-                   std::shared_ptr<std::vector<DataImporting::DataPoint>> data);
+                   std::shared_ptr<DataImporting::TimeSeries> data);
+
+    /**
+     * @brief relayFetchProgress passes the fetch progress of an importer on with fetchProgress.
+     * @param dataType: The type of the data being fetched.
+     * @param dataLocation: The location of the data being fetched.
+     * @param receivedSegments: How many segments have been received.
+     * @param totalSegments: How many segments the data was split into.
+     */
+    void relayFetchProgress(DataImporting::ApiDataType dataType, std::string dataLocation,
+                            int receivedSegments, int totalSegments);
+
+    /**
+     * @brief forgetCancelledFetch stops waiting for data whose fetch was cancelled or failed.
+     * @param fetchDetails: The details of the cancelled data.
+     */
+    void forgetCancelledFetch(DataImporting::DataFetchDetails fetchDetails);
+
+    /**
+     * @brief journalSegment keeps a downloaded segment of data over restarts.
+     * @param fetchDetails: The details of the downloaded data.
+     * @param data: The downloaded data.
+     */
+    void journalSegment(DataImporting::DataFetchDetails fetchDetails,
+                        std::shared_ptr<DataImporting::TimeSeries> data);
 
 private:
 
+    /**
+     * @brief replayJournal rebuilds the data of the shown time period fetched before the last
+     * restart from the journal so that only the missing data is fetched again.
+     */
+    void replayJournal();
+
     /**
      * @brief reAddActiveDataSource adds requested data type to be activated. Re-uses data if possible
      * and fetches more data if needed. Removes old data if it's not usable.
@@ -222,34 +277,110 @@ private:
     void reAddActiveDataSource(DataSourceDetails dataSource);
 
     /**
-     * @brief makeDataPoints copies QSplineSeries values into a vector of DataPoints and
-     * updates max and min values if needed.
-     * @param series is the QSplineSeries which is copied.
-     * @param maxY is the highest Y value which gets updated if needed.
-     * @param minY is the smallest Y value which gets updated if needed.
-     * @return the vector of DataPoints.
+     * @brief fetchMissingData fetches the parts of a time interval that haven't been fetched
+     * or requested yet for a data source.
+     * @param dataSource contains information of the data type to fetch.
+     * @param importer is the DataImporter used to fetch the data.
+     * @param startDate is the start of the time interval.
+     * @param endDate is the end of the time interval.
+     * @return true if some of the data had to be fetched, false if all of it already exists.
+     */
+    bool fetchMissingData(DataSourceDetails dataSource, DataImporting::DataImporter* importer,
+                          QDateTime startDate, QDateTime endDate);
+
+    /**
+     * @brief loadArchivedData reads the parts of a time interval that are stored in the loaded data
+     * set file and passes them to save_data like fetched data.
+     * @param dataSource contains information of the data type to read.
+     * @param startSecs is the start of the time interval.
+     * @param endSecs is the end of the time interval.
+     * @return the parts of the time interval that will be read from the file.
      */
-    std::vector<DataImporting::DataPoint> makeDataPoints(QSplineSeries* series, float& maxY, float& minY);
+    DataImporting::IntervalSet loadArchivedData(DataSourceDetails dataSource,
+                                                qint64 startSecs, qint64 endSecs);
+
+    /**
+     * @brief addUnreadArchivedData adds the parts of a data source stored in the loaded data set
+     * file that haven't been read from it yet, so that saving doesn't lose them.
+     * @param dataSource contains information of the data type.
+     * @param data is the data to add the read data points to.
+     * @param coverage is the coverage of data, the read parts are added to it.
+     */
+    void addUnreadArchivedData(DataSourceDetails dataSource, DataImporting::TimeSeries& data,
+                               DataImporting::IntervalSet& coverage);
+
+    /**
+     * @brief calcBucketSecs calculates how long time buckets series are decimated with so that
+     * a time interval is shown with about seriesResolution_ points. Long buckets consist of
+     * whole rollups.
+     * @param startDate is the start of the time interval.
+     * @param endDate is the end of the time interval.
+     * @return the length of a bucket in seconds.
+     */
+    qint64 calcBucketSecs(QDateTime startDate, QDateTime endDate);
 
     /**
      * @brief makeSeries makes a series from given data between current time interval and
      * updates max and min values if needed.
-     * @param data_vec is a vector of data points which is converted into a series.
+     * @param data_vec is a time series of data points which is converted into a series.
      * @param maxY is the highest Y value which gets updated if needed.
      * @param minY is the smallest Y value which gets updated if needed.
-     * @return a series of data points from current time interval.
+     * @param magnitude gets the sum of the data point values added to it.
+     * @param rollups are the rollups of data_vec, or nullptr if there are none.
+     * @param aggregates are the window aggregates of data_vec, or nullptr if there are none.
+     * @return a decimated series of data points from current time interval.
      */
-    QSplineSeries* makeSeries(std::vector<DataImporting::DataPoint> data_vec, float& maxY, float& minY);
+    QLineSeries* makeSeries(const DataImporting::TimeSeries& data_vec, float& maxY, float& minY,
+                              float& magnitude, const DataImporting::RollupPyramid* rollups = nullptr,
+                              const DataImporting::WindowAggregates* aggregates = nullptr);
 
     /**
      * @brief makeSnippetSeries makes a series between given datetime and start/end datetime.
-     * @param data_vec is a vector containing data points which are used to make a series.
+     * @param data_vec is a time series containing data points which are used to make a series.
      * @param oldDateTime is a date time which determines starting/ending date time for series creation.
      * @param isStartDate tells if oldDateTime is the starting/ending date time for series creation.
+     * @param magnitude gets the sum of the data point values added to it.
+     * @param rollups are the rollups of data_vec, or nullptr if there are none.
+     * @param aggregates are the window aggregates of data_vec, or nullptr if there are none.
      * @return the created series, a pair containing the highest and lowest values of the series.
      */
-    std::pair<QSplineSeries*, std::pair<float, float>> makeSnippetSeries
-    (std::vector<DataImporting::DataPoint> data_vec, QDateTime oldDateTime, bool isStartDate);
+    std::pair<QLineSeries*, std::pair<float, float>> makeSnippetSeries
+    (const DataImporting::TimeSeries& data_vec, QDateTime oldDateTime, bool isStartDate, float& magnitude,
+     const DataImporting::RollupPyramid* rollups = nullptr,
+     const DataImporting::WindowAggregates* aggregates = nullptr);
+
+    /**
+     * @brief makeSeriesFromView makes a series of the smallest and largest data point of each time
+     * bucket in a view and updates max and min values if needed. Values are taken from every data
+     * point, not just the ones in the series.
+     * @param data_view is a view of the data points which are converted into a series.
+     * @param maxY is the highest Y value which gets updated if needed.
+     * @param minY is the smallest Y value which gets updated if needed.
+     * @param magnitude gets the sum of the data point values added to it.
+     * @return a decimated series of the viewed data points.
+     */
+    QLineSeries* makeSeriesFromView(const DataImporting::TimeSeriesView& data_view,
+                                      float& maxY, float& minY, float& magnitude);
+
+    /**
+     * @brief makeSeriesFromRollups does the same as makeSeriesFromView for a time range, but
+     * decimates with the longest rollups that fit and takes the values from window aggregates
+     * instead of going through every data point.
+     * @param data_vec is a time series of data points which is converted into a series.
+     * @param rollups are the rollups of data_vec.
+     * @param aggregates are the window aggregates of data_vec.
+     * @param startSecs is the start of the time range.
+     * @param endSecs is the end of the time range.
+     * @param maxY is the highest Y value which gets updated if needed.
+     * @param minY is the smallest Y value which gets updated if needed.
+     * @param magnitude gets the sum of the data point values added to it.
+     * @return a decimated series of the data points in the time range.
+     */
+    QLineSeries* makeSeriesFromRollups(const DataImporting::TimeSeries& data_vec,
+                                         const DataImporting::RollupPyramid& rollups,
+                                         const DataImporting::WindowAggregates& aggregates,
+                                         qint64 startSecs, qint64 endSecs,
+                                         float& maxY, float& minY, float& magnitude);
 
     /**
      * @brief addToActiveSeries adds more data points to an active series.
@@ -266,7 +397,7 @@ private:
      * @param new_ser is the new series.
      * @param dataType tells the data type of both series'.
      */
-    void removeFromActiveSeries(QSplineSeries *old_ser, QSplineSeries* new_ser, std::string dataType);
+    void removeFromActiveSeries(QLineSeries *old_ser, QLineSeries* new_ser, std::string dataType);
 
     // Stores instances of each DataImporter
     std::vector<DataImporting::DataImporter*> dataImporters_;
@@ -279,11 +410,39 @@ private:
 
     // Keeps track of data that is within or close to the current time interval.
     std::map<DataSourceDetails, std::pair<DataImporting::DataFetchDetails,
-                                std::vector<DataImporting::DataPoint> >> allData_;
+                                DataImporting::TimeSeries>> allData_;
+
+    // Keeps track of the time intervals that have been fetched for each data source.
+    std::map<DataSourceDetails, DataImporting::IntervalSet> fetchedIntervals_;
+
+    // Keeps track of the time intervals that are being fetched for each data source.
+    std::map<DataSourceDetails, DataImporting::IntervalSet> pendingIntervals_;
+
+    // Keeps hourly, daily and weekly rollups of the data in allData_ for each data source.
+    std::map<DataSourceDetails, DataImporting::RollupPyramid> rollups_;
+
+    // Keeps prefix sums and min/max tables of the data in allData_ for each data source, so that
+    // the values shown in pie and bar charts can be read for any time interval.
+    std::map<DataSourceDetails, DataImporting::WindowAggregates> aggregates_;
+
+    // Loaded data set file that data outside of its saved time interval is read from when needed.
+    std::shared_ptr<MappedDataSetFile> archive_;
+
+    // Keeps every fetched segment on disk so that fetched data survives restarts.
+    DataImporting::DataJournal journal_;
 
     // Current time interval.
     QDateTime startDateTime_;
     QDateTime endDateTime_;
+
+    // About how many points a series is reduced to before it's drawn.
+    int seriesResolution_;
+
+    // Length of the time buckets the shown series are decimated with.
+    qint64 bucketSecs_;
+
+    // Default for seriesResolution_ before the chart's size is known.
+    static const int DEFAULT_SERIES_RESOLUTION = 1000;
 };
 
 #endif // DATACONNECTOR_H
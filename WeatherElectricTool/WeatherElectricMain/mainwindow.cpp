@@ -55,6 +55,9 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(dataConnector_, &DataConnector::addSourceWidget,
             this, &MainWindow::createDataSourceWidget);
+
+    connect(dataConnector_, &DataConnector::fetchProgress,
+            this, &MainWindow::showFetchProgress);
 }
 
 MainWindow::~MainWindow()
@@ -172,6 +175,13 @@ void MainWindow::updateChartValues(std::string dataSeriesName, float newMagnitud
     weatherBar_->changeBarLength(dataSeriesName, newMinY, newMaxY);
 }
 
+void MainWindow::showFetchProgress(std::string dataSeriesName, int receivedSegments, int totalSegments)
+{
+    ui_->statusbar->showMessage(QString::fromStdString(dataSeriesName)
+                                + QString(": fetched %1/%2").arg(receivedSegments).arg(totalSegments),
+                                STATUS_MESSAGE_TIMEOUT_MS);
+}
+
 void MainWindow::on_refreshButton_clicked()
 {
     // Check if data changed is eligible
@@ -182,6 +192,8 @@ void MainWindow::on_refreshButton_clicked()
     }
 
     else {
+        // Series don't need more points than the chart has pixels
+        dataConnector_->setSeriesResolution(ui_->chartView->width());
         dataConnector_->setBoundaryDates(ui_->startDateTimeEdit->dateTime(),
                                          ui_->endDateTimeEdit->dateTime());
 
@@ -195,13 +207,13 @@ void MainWindow::reAddGraphSeries(DataSourceDetails dataSource)
     weatherGraph_->deleteActiveSeries(dataSource.graphName);
     weatherPie_->deleteActiveSeries(dataSource.graphName);
     weatherBar_->deleteActiveSeries(dataSource.graphName);
-    passedGraphNames_.erase(passedGraphNames_.find(dataSource.graphName));
+    passedGraphNames_.erase(dataSource.graphName);
 }
 
 void MainWindow::on_saveView_clicked()
 {
     QString fileName = QFileDialog::getSaveFileName(this, "Save Data File",
-                                                    QString(), "XML files (*.xml);;All files (*)");
+                                                    QString(), "View files (*.wev);;XML files (*.xml);;All files (*)");
     if (fileName.isEmpty())
         {return;}
 
@@ -218,7 +230,7 @@ void MainWindow::on_loadView_clicked()
     else
     {
         QString fileName = QFileDialog::getOpenFileName(this, "Open Data File",
-                                                        QString(), "XML files (*.xml);;All files (*)");
+                                                        QString(), "View files (*.wev *.xml);;All files (*)");
 
         if (fileName.isEmpty())
             {return;}
@@ -87,6 +87,9 @@ private slots:
     void on_chartComboBox_currentTextChanged(const QString &arg1);
 
 private:
+    // Stores how long fetch progress messages are shown in the status bar
+    static const int STATUS_MESSAGE_TIMEOUT_MS = 5000;
+
     // Stores the UI of this MainWindow
     Ui::MainWindow* ui_;
 
@@ -147,6 +150,15 @@ private:
      * @param newMinY is a new value for smallest Y value.
      */
     void updateChartValues(std::string dataSeriesName, float newMagnitude, float newMaxY, float newMinY);
+
+    /**
+     * @brief showFetchProgress shows how much of the data of a series has
+     * been fetched in the status bar.
+     * @param dataSeriesName is the name of the series being fetched.
+     * @param receivedSegments is how many segments have been received.
+     * @param totalSegments is how many segments the data was split into.
+     */
+    void showFetchProgress(std::string dataSeriesName, int receivedSegments, int totalSegments);
 };
 
 #endif // MAINWINDOW_H
@@ -18,11 +18,14 @@ namespace Ui { class WeatherChartBase; }
  */
 struct DataSeries {
     std::string unitOfMeasurement;
-    QSplineSeries* splineSeries;
+    QLineSeries* lineSeries;
     QValueAxis* axisY;
     float maxY;
     float minY;
     float magnitude;
+    // Spline copy of lineSeries that a graph shows instead when the points
+    // are sparse enough to be smoothed, nullptr otherwise
+    QSplineSeries* splineSeries;
 };
 
 // Maximum number of series that will be displayed
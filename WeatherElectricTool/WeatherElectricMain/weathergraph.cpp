@@ -11,6 +11,11 @@ WeatherGraph::WeatherGraph(QDateTime startDate) :
     startDate_(startDate)
 {
     initGraphAxis();
+
+    // Switch between splines and polylines as the plot area's width changes
+    connect(this, &QChart::plotAreaChanged, this, [this](const QRectF&){
+        updateRenderModes();
+    });
 }
 
 WeatherGraph::~WeatherGraph()
@@ -25,17 +30,23 @@ bool WeatherGraph::addActiveSeries(std::pair<std::string, DataSeries> seriesPair
         return false;
     }
 
-    QSplineSeries* splineSeries = seriesPair.second.splineSeries;
+    QLineSeries* lineSeries = seriesPair.second.lineSeries;
 
-    if (splineSeries->points().size() == 0){
+    if (lineSeries->count() == 0){
         return false;
     }
 
-    splineSeries->setName(QString::fromStdString(seriesPair.first));
-    splineSeries->setPen(QPen(determineSeriesColor(), 2, Qt::SolidLine, Qt::RoundCap));
+    // The spline copy is made by the graph when needed
+    seriesPair.second.splineSeries = nullptr;
+
+    lineSeries->setName(QString::fromStdString(seriesPair.first));
+    lineSeries->setPen(QPen(determineSeriesColor(), 2, Qt::SolidLine, Qt::RoundCap));
 
-    addSeries(splineSeries);
-    splineSeries->attachAxis(valueAxisX_);
+    // Dense series are drawn as polylines, which can be drawn with OpenGL
+    lineSeries->setUseOpenGL(true);
+
+    addSeries(lineSeries);
+    lineSeries->attachAxis(valueAxisX_);
 
     // Update x-axes
     std::pair<int, int> graphValues = calcGraphX(series());
@@ -56,10 +67,10 @@ bool WeatherGraph::addActiveSeries(std::pair<std::string, DataSeries> seriesPair
 
         axisY->setGridLineColor(AXIS_HORIZONTAL_GRID_COLOR);
         addAxis(axisY, ALIGNMENT_Y[countUniqueAxisY()%2]);
-        splineSeries->attachAxis(axisY);
+        lineSeries->attachAxis(axisY);
     }
     else {
-        splineSeries->attachAxis(axisY);
+        lineSeries->attachAxis(axisY);
 
         // Compare current axis values to new one and update accordingly
         std::pair<float, float> minMax = findMinMaxAttachedToAxis(axisY);
@@ -73,7 +84,11 @@ bool WeatherGraph::addActiveSeries(std::pair<std::string, DataSeries> seriesPair
         axisY->setRange((smallestY - buffer), (largestY + buffer));
     }
 
-    weatherData_.insert({seriesPair.first, seriesPair.second});
+    auto it = weatherData_.insert({seriesPair.first, seriesPair.second}).first;
+    seriesMinMax_[seriesPair.first].assign(seriesValuesY(lineSeries));
+
+    // Show sparse series as splines
+    updateRenderMode(it->second);
 
     return true;
 }
@@ -84,11 +99,14 @@ bool WeatherGraph::deleteActiveSeries(std::string dataSeriesName)
     if (it == weatherData_.end()){
         return false;
     }
-    QSplineSeries* dataSeries = it->second.splineSeries;
+    QLineSeries* lineSeries = it->second.lineSeries;
+    QSplineSeries* splineSeries = it->second.splineSeries;
     QValueAxis* axisY = it->second.axisY;
 
     weatherData_.erase(dataSeriesName);
-    delete dataSeries;
+    seriesMinMax_.erase(dataSeriesName);
+    delete splineSeries;
+    delete lineSeries;
 
     // If axis has no attached series delete it, update range otherwise
     if (attachedSeries(axisY).size() == 0){
@@ -117,7 +135,7 @@ bool WeatherGraph::deleteActiveSeries(std::string dataSeriesName)
 bool WeatherGraph::hideSeries(std::string dataSeriesName, bool hide)
 {
     DataSeries* currentSeries = &weatherData_[dataSeriesName];
-    QSplineSeries* currentSplineSeries = currentSeries->splineSeries;
+    QXYSeries* currentShownSeries = shownSeries(*currentSeries);
     QValueAxis* seriesAxis = currentSeries->axisY;
 
     if (hide){
@@ -125,11 +143,11 @@ bool WeatherGraph::hideSeries(std::string dataSeriesName, bool hide)
             seriesAxis->hide();
         }
 
-        currentSplineSeries->hide();
+        currentShownSeries->hide();
 
     }
     else {
-        currentSplineSeries->show();
+        currentShownSeries->show();
         seriesAxis->show();
     }
 
@@ -140,36 +158,55 @@ bool WeatherGraph::hideSeries(std::string dataSeriesName, bool hide)
 void WeatherGraph::addPointsToSeries(std::string dataSeriesName,
                                      DataSeries addedSeries, bool addBefore)
 {
-    DataSeries* currentSeries = &weatherData_[dataSeriesName];
-    QSplineSeries* oldSplineSeries = currentSeries->splineSeries;
-    QSplineSeries* newSplineSeries = addedSeries.splineSeries;
+    QLineSeries* newLineSeries = addedSeries.lineSeries;
+
+    auto it = weatherData_.find(dataSeriesName);
+    if (it == weatherData_.end()){
+        delete newLineSeries;
+        return;
+    }
+
+    DataSeries* currentSeries = &it->second;
+    QLineSeries* oldLineSeries = currentSeries->lineSeries;
     QValueAxis* seriesAxis = currentSeries->axisY;
 
-    // Add points to series
+    // Combine the points in a buffer and replace the points of the shown
+    // series with it at once, so that the series is redrawn only once and
+    // stays attached to its axes
+    QVector<QPointF> points;
+    points.reserve(oldLineSeries->count() + newLineSeries->count());
+
     if (addBefore){
-        *newSplineSeries << oldSplineSeries->points();
+        points += newLineSeries->pointsVector();
+        points += oldLineSeries->pointsVector();
+    }
+    else {
+        points += oldLineSeries->pointsVector();
+        points += newLineSeries->pointsVector();
+    }
 
-        addSeries(newSplineSeries);
-        newSplineSeries->attachAxis(valueAxisX_);
-        newSplineSeries->attachAxis(seriesAxis);
-        newSplineSeries->setName(oldSplineSeries->name());
-        newSplineSeries->setPen(oldSplineSeries->pen());
+    oldLineSeries->replace(points);
 
-        currentSeries->splineSeries = newSplineSeries;
+    // Add the new values to the same end of the series' tree
+    DataImporting::MinMaxTree& minMaxTree = seriesMinMax_[dataSeriesName];
 
-        delete oldSplineSeries;
+    if (addBefore){
+        minMaxTree.prepend(seriesValuesY(newLineSeries));
     }
     else {
-        *oldSplineSeries << newSplineSeries->points();
+        minMaxTree.append(seriesValuesY(newLineSeries));
     }
 
+    delete newLineSeries;
+
+    // The series may have become too dense for a spline
+    updateRenderMode(*currentSeries);
+
     // Update dataSeries min and max Y
-    if (addedSeries.maxY > currentSeries->maxY){
-        currentSeries->maxY = addedSeries.maxY;
-    }
-    if (addedSeries.minY < currentSeries->minY){
-        currentSeries->minY = addedSeries.minY;
-    }
+    std::pair<float, float> seriesMinMaxY = minMaxTree.minMaxValues();
+
+    currentSeries->minY = seriesMinMaxY.first;
+    currentSeries->maxY = seriesMinMaxY.second;
 
     // Update y-axis
     std::pair<float, float> minMax = findMinMaxAttachedToAxis(seriesAxis);
@@ -187,21 +224,33 @@ void WeatherGraph::addPointsToSeries(std::string dataSeriesName,
 void WeatherGraph::removePointsFromSeries(std::string dataSeriesName, int delIndex, bool delBefore)
 {
     DataSeries* currentSeries = &weatherData_[dataSeriesName];
-    QSplineSeries* currentSplineSeries = currentSeries->splineSeries;
+    QLineSeries* currentLineSeries = currentSeries->lineSeries;
     QValueAxis* seriesAxis = currentSeries->axisY;
 
+    DataImporting::MinMaxTree& minMaxTree = seriesMinMax_[dataSeriesName];
+
     if (delBefore){
-        currentSplineSeries->removePoints(0, delIndex);
+        currentLineSeries->removePoints(0, delIndex);
+        minMaxTree.removeFirst(delIndex);
     }
     else {
-        currentSplineSeries->removePoints(delIndex, currentSplineSeries->count()-delIndex);
+        minMaxTree.removeLast(currentLineSeries->count()-delIndex);
+        currentLineSeries->removePoints(delIndex, currentLineSeries->count()-delIndex);
+    }
+
+    // The series may have become sparse enough for a spline
+    updateRenderMode(*currentSeries);
+
+    // An emptied series has no range, keep the previous one until new points arrive
+    if (minMaxTree.size() == 0){
+        return;
     }
 
-    // Update DataSeries Y-values
-    std::tuple<float, float> seriesValuesY = findSeriesMinMaxY(*currentSeries);
+    // Update DataSeries Y-values from the remaining points' tree
+    std::pair<float, float> seriesMinMaxY = minMaxTree.minMaxValues();
 
-    currentSeries->minY = std::get<0>(seriesValuesY);
-    currentSeries->maxY = std::get<1>(seriesValuesY);
+    currentSeries->minY = seriesMinMaxY.first;
+    currentSeries->maxY = seriesMinMaxY.second;
 
     // Update Y-axis range
     std::pair<float, float> minMax = findMinMaxAttachedToAxis(seriesAxis);
@@ -237,10 +286,10 @@ QColor WeatherGraph::determineSeriesColor()
     std::vector<QColor> lineColors = SERIESCOLORS;
 
     for (QAbstractSeries* series : series()){
-        QSplineSeries* splineSeries = dynamic_cast<QSplineSeries*>(series);
+        QXYSeries* xySeries = dynamic_cast<QXYSeries*>(series);
 
         for (int i = 0; i < int(lineColors.size()); i++){
-            if (splineSeries->pen().color() == lineColors[i]){
+            if (xySeries->pen().color() == lineColors[i]){
                 lineColors.erase(lineColors.begin() + i);
                 i--;
             }
@@ -289,9 +338,9 @@ QValueAxis *WeatherGraph::createValueAxisY(DataSeries series, float minY, float
 {
     QValueAxis *axisY = new QValueAxis();
 
-    axisY->setLabelsColor(series.splineSeries->pen().color());
+    axisY->setLabelsColor(series.lineSeries->pen().color());
     axisY->setTitleText(QString::fromStdString(series.unitOfMeasurement));
-    axisY->setTitleBrush(QBrush(series.splineSeries->pen().color()));
+    axisY->setTitleBrush(QBrush(series.lineSeries->pen().color()));
     axisY->setRange(minY, maxY);
     axisY->setLinePen(AXIS_PEN);
 
@@ -309,9 +358,9 @@ std::pair<int, int> WeatherGraph::calcGraphX(QList<QAbstractSeries*> seriesList)
 
     for (QAbstractSeries* series : seriesList){
 
-        QSplineSeries* splineSeries = dynamic_cast<QSplineSeries*>(series);
-        float maxX = splineSeries->at(splineSeries->count()-1).x();
-        float minX = splineSeries->at(0).x();
+        QXYSeries* xySeries = dynamic_cast<QXYSeries*>(series);
+        float maxX = xySeries->at(xySeries->count()-1).x();
+        float minX = xySeries->at(0).x();
 
         largestX = std::max(maxX, largestX);
         smallestX = std::min(minX, smallestX);
@@ -329,30 +378,30 @@ float WeatherGraph::calcBuffer(float min, float max)
 
 std::pair<float, float> WeatherGraph::findMinMaxAttachedToAxis(QValueAxis *axis)
 {
-    std::vector<DataSeries> attached = attachedSeries(axis);
-    float largestY = std::numeric_limits<float>::min();
+    // The series' min and max are kept up to date as points change, so only
+    // the few series on the axis have to be compared
+    std::vector<DataSeries*> attached = attachedSeries(axis);
+    float largestY = std::numeric_limits<float>::lowest();
     float smallestY = std::numeric_limits<float>::max();
 
-    for (DataSeries series : attached){
-        smallestY = std::min(series.minY, smallestY);
-        largestY = std::max(series.maxY, largestY);
+    for (DataSeries* series : attached){
+        smallestY = std::min(series->minY, smallestY);
+        largestY = std::max(series->maxY, largestY);
     }
 
     return {smallestY, largestY};
 }
 
-std::pair<float, float> WeatherGraph::findSeriesMinMaxY(const DataSeries &series)
+std::vector<float> WeatherGraph::seriesValuesY(QLineSeries* lineSeries)
 {
-    float largestY = std::numeric_limits<float>::min();
-    float smallestY = std::numeric_limits<float>::max();
-
-    for (QPointF dataPoint : series.splineSeries->points()){
+    std::vector<float> valuesY;
+    valuesY.reserve(lineSeries->count());
 
-        largestY = std::max(float(dataPoint.y()), largestY);
-        smallestY = std::min(float(dataPoint.y()), smallestY);
+    for (const QPointF& dataPoint : lineSeries->pointsVector()){
+        valuesY.push_back(dataPoint.y());
     }
 
-    return {smallestY, largestY};
+    return valuesY;
 }
 
 QValueAxis *WeatherGraph::findAxisByUnit(std::string dataSeriesUnit)
@@ -430,18 +479,18 @@ void WeatherGraph::updateDateAxisX(int newMinX, int newMaxX)
 
 void WeatherGraph::updateAxisColor(QValueAxis* axis)
 {
-    std::vector<DataSeries> attached = attachedSeries(axis);
-    axis->setLabelsColor(attached[0].splineSeries->pen().color());
-    axis->setTitleBrush(QBrush(attached[0].splineSeries->pen().color()));
+    std::vector<DataSeries*> attached = attachedSeries(axis);
+    axis->setLabelsColor(attached[0]->lineSeries->pen().color());
+    axis->setTitleBrush(QBrush(attached[0]->lineSeries->pen().color()));
 }
 
-std::vector<DataSeries> WeatherGraph::attachedSeries(QValueAxis* axis)
+std::vector<DataSeries*> WeatherGraph::attachedSeries(QValueAxis* axis)
 {
-    std::vector<DataSeries> attached;
+    std::vector<DataSeries*> attached;
 
-    for (auto dataSeries : weatherData_){
+    for (auto& dataSeries : weatherData_){
         if (dataSeries.second.axisY  == axis){
-            attached.push_back(dataSeries.second);
+            attached.push_back(&dataSeries.second);
         }
     }
 
@@ -453,7 +502,7 @@ int WeatherGraph::countShownSeries(QValueAxis* axis)
     int count = 0;
 
     for (auto dataSeries : weatherData_){
-        if (dataSeries.second.axisY  == axis and dataSeries.second.splineSeries->isVisible()){
+        if (dataSeries.second.axisY  == axis and shownSeries(dataSeries.second)->isVisible()){
             count += 1;
         }
     }
@@ -479,3 +528,60 @@ int WeatherGraph::countUniqueAxisY()
 
     return count;
 }
+
+QXYSeries* WeatherGraph::shownSeries(const DataSeries& series)
+{
+    if (series.splineSeries != nullptr){
+        return series.splineSeries;
+    }
+
+    return series.lineSeries;
+}
+
+void WeatherGraph::updateRenderMode(DataSeries& series)
+{
+    QLineSeries* lineSeries = series.lineSeries;
+
+    // The plot area is empty until the chart has been laid out
+    qreal plotWidth = plotArea().width() > 0 ? plotArea().width() : size().width();
+    bool sparse = lineSeries->count() * SPLINE_MIN_PIXELS_PER_POINT <= plotWidth;
+
+    if (sparse and series.splineSeries == nullptr){
+        QSplineSeries* splineSeries = new QSplineSeries();
+        splineSeries->replace(lineSeries->pointsVector());
+
+        swapShownSeries(lineSeries, splineSeries, series.axisY);
+        series.splineSeries = splineSeries;
+    }
+    else if (sparse){
+        // Keep the shown spline up to date with the points
+        series.splineSeries->replace(lineSeries->pointsVector());
+    }
+    else if (series.splineSeries != nullptr){
+        swapShownSeries(series.splineSeries, lineSeries, series.axisY);
+
+        delete series.splineSeries;
+        series.splineSeries = nullptr;
+    }
+}
+
+void WeatherGraph::updateRenderModes()
+{
+    for (auto& dataSeries : weatherData_){
+        updateRenderMode(dataSeries.second);
+    }
+}
+
+void WeatherGraph::swapShownSeries(QXYSeries* oldSeries, QXYSeries* newSeries, QValueAxis* axisY)
+{
+    newSeries->setName(oldSeries->name());
+    newSeries->setPen(oldSeries->pen());
+    newSeries->setVisible(oldSeries->isVisible());
+
+    addSeries(newSeries);
+    newSeries->attachAxis(valueAxisX_);
+    newSeries->attachAxis(axisY);
+
+    // The chart gives up the ownership of the removed series
+    removeSeries(oldSeries);
+}
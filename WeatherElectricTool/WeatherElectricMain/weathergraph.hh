@@ -9,6 +9,7 @@
 #define WEATHERGRAPH_HH
 
 #include "weatherchartbase.hh"
+#include "DataImporting/minmaxtree.hh"
 #include <vector>
 
 namespace Ui { class WeatherGraph; }
@@ -16,9 +17,17 @@ namespace Ui { class WeatherGraph; }
 // Different axis alignments
 const std::vector<QFlag> ALIGNMENT_Y{Qt::AlignLeft, Qt::AlignRight};
 
+// Series are drawn as splines only when each of their points has at least
+// this many pixels of the plot's width, denser ones are drawn as polylines
+const qreal SPLINE_MIN_PIXELS_PER_POINT = 4;
+
 /**
  * @brief The WeatherGraph class initializes the graphs characteristics and
- * displays given splineseries as spline graphs
+ * displays given series as line graphs. Series whose points are sparse
+ * compared to the plot's width are smoothed into splines, denser series are
+ * drawn as polylines with OpenGL, since splines through points closer than
+ * pixels only cost time. The mode of each series is switched whenever its
+ * points or the plot's width change.
  */
 class WeatherGraph : public WeatherChartBase
 {
@@ -61,10 +70,12 @@ public:
     bool hideSeries(std::string dataSeriesName, bool hide) override;
 
     /**
-     * @brief addPointsToSeries adds data points to an existing series
+     * @brief addPointsToSeries adds data points to an existing series. The
+     * existing series is updated in place.
      * @param dataSeriesName: Name of the data series that the points will be
      * added to
-     * @param addedSeries: DataSeries that will be combined to the existing one
+     * @param addedSeries: DataSeries that will be combined to the existing one,
+     * its spline series is deleted afterwards
      * @param addBefore: Defines if the new series will be added in front or
      * after the existing one
      */
@@ -144,12 +155,11 @@ private:
     std::pair<float, float> findMinMaxAttachedToAxis(QValueAxis* axis);
 
     /**
-     * @brief findSeriesMinMaxY iterates through series' points and return the
-     * min and max y-values
-     * @param series: Series which the values will be searched for
-     * @return found maximum and minimum values
+     * @brief seriesValuesY collects the y-values of the given series' points
+     * @param lineSeries: Series whose values will be collected
+     * @return the y-values in the order of the points
      */
-    std::pair<float, float> findSeriesMinMaxY(const DataSeries &series);
+    std::vector<float> seriesValuesY(QLineSeries* lineSeries);
 
     /**
      * @brief findAxisByUnit tries to find an axis matching the given unit
@@ -187,9 +197,9 @@ private:
     /**
      * @brief attachedSeries finds DataSeries attached to the given axis
      * @param axis: Axis the searched series are attached to
-     * @return series attached to the given axis
+     * @return pointers to the series attached to the given axis
      */
-    std::vector<DataSeries> attachedSeries(QValueAxis* axis);
+    std::vector<DataSeries*> attachedSeries(QValueAxis* axis);
 
     /**
      * @brief countShownSeries counts the amount of series shown on the graph
@@ -205,12 +215,50 @@ private:
      */
     int countUniqueAxisY();
 
+    /**
+     * @brief shownSeries returns the series that is drawn for the given
+     * data series
+     * @param series: The data series
+     * @return the spline copy of the series if there is one, the line
+     * series otherwise
+     */
+    QXYSeries* shownSeries(const DataSeries& series);
+
+    /**
+     * @brief updateRenderMode shows the given series as a spline if its
+     * points are sparse enough and as a polyline otherwise, and keeps the
+     * spline copy up to date with the points
+     * @param series: The data series whose mode will be updated
+     */
+    void updateRenderMode(DataSeries& series);
+
+    /**
+     * @brief updateRenderModes updates the mode of every series on the graph
+     */
+    void updateRenderModes();
+
+    /**
+     * @brief swapShownSeries shows newSeries on the graph in place of
+     * oldSeries, which is removed from the graph but not deleted
+     * @param oldSeries: The series currently shown
+     * @param newSeries: The series to show instead
+     * @param axisY: The y-axis the series are attached to
+     */
+    void swapShownSeries(QXYSeries* oldSeries, QXYSeries* newSeries, QValueAxis* axisY);
 
     /**
      * @brief weatherData_ stores the data which will be plotted
      */
     std::map<std::string, DataSeries> weatherData_;
 
+    /**
+     * @brief seriesMinMax_ stores the y-values of each series in weatherData_
+     * in a tree, so that the series' min and max y-values can be updated
+     * without going through all of its points when points are added or
+     * removed at either end
+     */
+    std::map<std::string, DataImporting::MinMaxTree> seriesMinMax_;
+
     /**
      * @brief startDate_ stores the startdate used as an anchor point
      */
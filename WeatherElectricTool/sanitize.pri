@@ -0,0 +1,6 @@
+# Build with qmake CONFIG+=sanitize to catch memory errors and leaks at run
+# time with AddressSanitizer
+sanitize {
+    QMAKE_CXXFLAGS += -fsanitize=address -fno-omit-frame-pointer
+    QMAKE_LFLAGS += -fsanitize=address
+}
@@ -0,0 +1,13 @@
+include(../tests.pri)
+
+# The data set structs are declared with the chart types
+QT += gui charts widgets xml
+
+TARGET = tst_cachefilehandler
+
+SOURCES += \
+    tst_cachefilehandler.cpp \
+    $$COMMON_DIR/memoryusage.cpp \
+    $$MAIN_DIR/cachefilehandler.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/intervalset.cpp
@@ -0,0 +1,384 @@
+/**
+  * @file tst_cachefilehandler.cpp tests that data sets saved by
+  * CacheFileHandler are read back exactly, and compares the file formats by
+  * how long reading them takes and how large they are.
+  * @date 16.10.2026
+  */
+
+#include "cachefilehandler.h"
+#include "memoryusage.hh"
+
+#include <QTemporaryDir>
+#include <QtTest>
+
+// Times past 2^24 seconds since the epoch don't fit in a float exactly, so
+// neighbouring seconds would be read back as the same time
+static const qint64 START_SECS = 1618000001;
+
+// Stores how many data points the large data set has, one every second
+static const qint64 LARGE_POINT_COUNT = 4000000;
+
+// Stores how long the time interval saved with the large data set is
+static const qint64 SHOWN_SECS = 24 * 60 * 60;
+
+// Stores how many data points the benchmarked view has
+static const qint64 VIEW_POINT_COUNT = 1000000;
+
+/**
+ * @brief makeDataSet creates a data set with data points one second apart, with values that
+ * need every digit of a float.
+ * @return the data set.
+ */
+static DataSet makeDataSet()
+{
+    DataSet dataSet = {};
+    dataSet.hide = 1;
+    dataSet.dataSource = {"FMI", "Tampere", "Temperature, Tampere", 0,
+                          DataImporting::Temperature};
+    dataSet.series.unitOfMeasurement = "degC";
+
+    const float values[] = {0.1f, -273.15f, 1e-7f, 123456.789f, 0.3f, 3.4e38f, 2.5f};
+    for(qint64 i = 0; i < 7; i++)
+    {
+        dataSet.data.append(START_SECS + i, values[i]);
+    }
+    // A later data point far past 2^31 seconds
+    dataSet.data.append(qint64(1) << 33, 7.75f);
+
+    dataSet.series.maxY = 3.4e38f;
+    dataSet.series.minY = -273.15f;
+    dataSet.series.magnitude = 123194.3f;
+    dataSet.coverage.add(START_SECS, START_SECS + 6);
+    return dataSet;
+}
+
+/**
+ * @brief makeLargeDataSet creates a data set with a data point every second, covering all of
+ * them.
+ * @param pointCount is the number of data points.
+ * @return the data set.
+ */
+static DataSet makeLargeDataSet(qint64 pointCount)
+{
+    DataSet dataSet = makeDataSet();
+    dataSet.data = DataImporting::TimeSeries();
+    for(qint64 i = 0; i < pointCount; i++)
+    {
+        dataSet.data.append(START_SECS + i, float(i % 50));
+    }
+    dataSet.coverage = DataImporting::IntervalSet();
+    dataSet.coverage.add(START_SECS, START_SECS + pointCount - 1);
+    return dataSet;
+}
+
+/**
+ * @brief makeView creates a view of a large data set that shows all of its data points.
+ * @param pointCount is the number of data points.
+ * @return the view.
+ */
+static std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> makeView(qint64 pointCount)
+{
+    return {{QDateTime::fromSecsSinceEpoch(START_SECS),
+             QDateTime::fromSecsSinceEpoch(START_SECS + pointCount - 1)},
+            {makeLargeDataSet(pointCount)}};
+}
+
+/**
+ * @brief The TestCacheFileHandler class tests saving and reading data sets.
+ */
+class TestCacheFileHandler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief xmlKeepsTimestamps saves a data set into an xml file and checks that it's read back
+     * exactly.
+     */
+    void xmlKeepsTimestamps();
+
+    /**
+     * @brief binaryKeepsTimestamps saves a data set into an uncompressed binary file and checks
+     * that it's read back exactly.
+     */
+    void binaryKeepsTimestamps();
+
+    /**
+     * @brief compressedBinaryKeepsTimestamps saves a data set into a compressed binary file and
+     * checks that it's read back exactly.
+     */
+    void compressedBinaryKeepsTimestamps();
+
+    /**
+     * @brief mappedFileReadsOnlyShownData maps a large data set file and checks that reading the
+     * saved time interval doesn't bring the rest of the file into memory.
+     */
+    void mappedFileReadsOnlyShownData();
+
+    /**
+     * @brief loadTime_data makes a row for the xml, binary and compressed binary formats.
+     */
+    void loadTime_data();
+
+    /**
+     * @brief loadTime benchmarks reading a saved view of a million data points.
+     */
+    void loadTime();
+
+    /**
+     * @brief fileSizes saves a view of a million data points in every file format and checks
+     * that the binary files are smaller than the xml file.
+     */
+    void fileSizes();
+
+    /**
+     * @brief roundTripTime_data makes a row for the xml and binary formats.
+     */
+    void roundTripTime_data();
+
+    /**
+     * @brief roundTripTime benchmarks saving a view of a million data points and reading it back,
+     * and checks that it's read back exactly.
+     */
+    void roundTripTime();
+
+private:
+    /**
+     * @brief saveView saves a view in a file of the given format.
+     * @param view is the time interval and data sets of the view.
+     * @param fileName is the name of the file.
+     * @param binary tells if the binary format is used instead of xml.
+     * @param compressed tells if a binary file is compressed.
+     */
+    void saveView(const std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>>& view,
+                  QString fileName, bool binary, bool compressed);
+
+    /**
+     * @brief compareRoundTrip reads a saved file and compares it with what was saved.
+     * @param saved is the saved data set.
+     * @param fileName is the name of the file the data set was saved in.
+     * @param hasCoverage tells if the file format stores coverage.
+     */
+    void compareRoundTrip(const std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>>& saved,
+                          QString fileName, bool hasCoverage);
+
+    // Temporary directory for the saved files
+    QTemporaryDir directory_;
+};
+
+void TestCacheFileHandler::xmlKeepsTimestamps()
+{
+    QVERIFY(directory_.isValid());
+
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> saved =
+        {{QDateTime::fromSecsSinceEpoch(START_SECS), QDateTime::fromSecsSinceEpoch(START_SECS + 1)},
+         {makeDataSet()}};
+    QString fileName = directory_.filePath("dataSet.xml");
+
+    CacheFileHandler::saveDataSet(saved, fileName);
+    compareRoundTrip(saved, fileName, false);
+}
+
+void TestCacheFileHandler::binaryKeepsTimestamps()
+{
+    QVERIFY(directory_.isValid());
+
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> saved =
+        {{QDateTime::fromSecsSinceEpoch(START_SECS), QDateTime::fromSecsSinceEpoch(START_SECS + 1)},
+         {makeDataSet()}};
+    QString fileName = directory_.filePath("dataSet.bin");
+
+    CacheFileHandler::saveDataSetBinary(saved, fileName);
+    compareRoundTrip(saved, fileName, true);
+}
+
+void TestCacheFileHandler::compressedBinaryKeepsTimestamps()
+{
+    QVERIFY(directory_.isValid());
+
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> saved =
+        {{QDateTime::fromSecsSinceEpoch(START_SECS), QDateTime::fromSecsSinceEpoch(START_SECS + 1)},
+         {makeDataSet()}};
+    QString fileName = directory_.filePath("compressedDataSet.bin");
+
+    CacheFileHandler::saveDataSetBinary(saved, fileName, true);
+    compareRoundTrip(saved, fileName, true);
+}
+
+void TestCacheFileHandler::mappedFileReadsOnlyShownData()
+{
+    QVERIFY(directory_.isValid());
+    if(residentBytes() < 0)
+    {
+        QSKIP("Memory use can't be measured on this system");
+    }
+
+    // The shown time interval is in the middle of the data
+    qint64 shownStartSecs = START_SECS + LARGE_POINT_COUNT / 2;
+    QString fileName = directory_.filePath("largeDataSet.bin");
+    CacheFileHandler::saveDataSetBinary(
+        {{QDateTime::fromSecsSinceEpoch(shownStartSecs),
+          QDateTime::fromSecsSinceEpoch(shownStartSecs + SHOWN_SECS)},
+         {makeLargeDataSet(LARGE_POINT_COUNT)}}, fileName);
+
+    qint64 fileSize = QFileInfo(fileName).size();
+    QVERIFY(fileSize > LARGE_POINT_COUNT * 12);
+
+    qint64 residentBefore = residentBytes();
+
+    std::shared_ptr<MappedDataSetFile> mappedFile = CacheFileHandler::mapDataSet(fileName);
+    QVERIFY(mappedFile != nullptr);
+    std::pair<QDateTime, QDateTime> timeInterval = mappedFile->getTimeInterval();
+    std::vector<DataSet> dataSets = mappedFile->getDataSets(timeInterval.first.toSecsSinceEpoch(),
+                                                            timeInterval.second.toSecsSinceEpoch());
+
+    qint64 residentAfter = residentBytes();
+
+    QCOMPARE(dataSets.size(), std::size_t(1));
+    QCOMPARE(dataSets.front().data.size(), std::size_t(SHOWN_SECS + 1));
+    QCOMPARE(dataSets.front().data.timeAt(0), shownStartSecs);
+
+    // Only the pages of the shown data points and their neighbours are read
+    QVERIFY2(residentAfter - residentBefore < fileSize / 8,
+             qPrintable(QString("%1 bytes of a %2 byte file were read into memory")
+                        .arg(residentAfter - residentBefore).arg(fileSize)));
+}
+
+void TestCacheFileHandler::loadTime_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::addColumn<bool>("compressed");
+
+    QTest::newRow("xml") << false << false;
+    QTest::newRow("binary") << true << false;
+    QTest::newRow("compressed binary") << true << true;
+}
+
+void TestCacheFileHandler::loadTime()
+{
+    QFETCH(bool, binary);
+    QFETCH(bool, compressed);
+    QVERIFY(directory_.isValid());
+
+    QString fileName = directory_.filePath("view");
+    saveView(makeView(VIEW_POINT_COUNT), fileName, binary, compressed);
+
+    std::size_t pointCount = 0;
+    QBENCHMARK
+    {
+        pointCount = CacheFileHandler::readDataSet(fileName).second.front().data.size();
+    }
+
+    QCOMPARE(pointCount, std::size_t(VIEW_POINT_COUNT));
+}
+
+void TestCacheFileHandler::fileSizes()
+{
+    QVERIFY(directory_.isValid());
+
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> view =
+        makeView(VIEW_POINT_COUNT);
+    QString xmlFileName = directory_.filePath("view.xml");
+    QString binaryFileName = directory_.filePath("view.bin");
+    QString compressedFileName = directory_.filePath("compressedView.bin");
+    saveView(view, xmlFileName, false, false);
+    saveView(view, binaryFileName, true, false);
+    saveView(view, compressedFileName, true, true);
+
+    qint64 xmlSize = QFileInfo(xmlFileName).size();
+    qint64 binarySize = QFileInfo(binaryFileName).size();
+    qint64 compressedSize = QFileInfo(compressedFileName).size();
+    qInfo("Size of a view of %lld data points: xml %lld bytes, binary %lld bytes, "
+          "compressed binary %lld bytes", VIEW_POINT_COUNT, xmlSize, binarySize, compressedSize);
+
+    // The binary format stores an 8 byte time and a 4 byte value for each data point
+    QVERIFY(binarySize < xmlSize);
+    QVERIFY(binarySize < VIEW_POINT_COUNT * 13);
+    QVERIFY(compressedSize < binarySize);
+}
+
+void TestCacheFileHandler::roundTripTime_data()
+{
+    QTest::addColumn<bool>("binary");
+
+    QTest::newRow("xml") << false;
+    QTest::newRow("binary") << true;
+}
+
+void TestCacheFileHandler::roundTripTime()
+{
+    QFETCH(bool, binary);
+    QVERIFY(directory_.isValid());
+
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> view =
+        makeView(VIEW_POINT_COUNT);
+    QString fileName = directory_.filePath("roundTrip");
+
+    std::size_t pointCount = 0;
+    QBENCHMARK
+    {
+        saveView(view, fileName, binary, false);
+        pointCount = CacheFileHandler::readDataSet(fileName).second.front().data.size();
+    }
+
+    QCOMPARE(pointCount, std::size_t(VIEW_POINT_COUNT));
+    compareRoundTrip(view, fileName, binary);
+}
+
+void TestCacheFileHandler::saveView(
+    const std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>>& view,
+    QString fileName, bool binary, bool compressed)
+{
+    if(binary)
+    {
+        CacheFileHandler::saveDataSetBinary(view, fileName, compressed);
+    }
+    else
+    {
+        CacheFileHandler::saveDataSet(view, fileName);
+    }
+}
+
+void TestCacheFileHandler::compareRoundTrip(
+    const std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>>& saved,
+    QString fileName, bool hasCoverage)
+{
+    std::pair<std::pair<QDateTime, QDateTime>, std::vector<DataSet>> read =
+        CacheFileHandler::readDataSet(fileName);
+
+    QCOMPARE(read.first.first.toSecsSinceEpoch(), saved.first.first.toSecsSinceEpoch());
+    QCOMPARE(read.first.second.toSecsSinceEpoch(), saved.first.second.toSecsSinceEpoch());
+    QCOMPARE(read.second.size(), saved.second.size());
+
+    const DataSet& savedSet = saved.second.front();
+    const DataSet& readSet = read.second.front();
+
+    QCOMPARE(readSet.hide, savedSet.hide);
+    QCOMPARE(readSet.dataSource.dataSourceName, savedSet.dataSource.dataSourceName);
+    QCOMPARE(readSet.dataSource.dataLocationName, savedSet.dataSource.dataLocationName);
+    QCOMPARE(readSet.dataSource.graphName, savedSet.dataSource.graphName);
+    QCOMPARE(readSet.dataSource.dataSourceIndex, savedSet.dataSource.dataSourceIndex);
+    QCOMPARE(readSet.dataSource.dataType, savedSet.dataSource.dataType);
+    QCOMPARE(readSet.series.unitOfMeasurement, savedSet.series.unitOfMeasurement);
+    QCOMPARE(readSet.series.maxY, savedSet.series.maxY);
+    QCOMPARE(readSet.series.minY, savedSet.series.minY);
+    QCOMPARE(readSet.series.magnitude, savedSet.series.magnitude);
+
+    // Every time must come back exactly, even neighbouring seconds
+    QCOMPARE(readSet.data.size(), savedSet.data.size());
+    for(std::size_t i = 0; i < savedSet.data.size(); i++)
+    {
+        QCOMPARE(readSet.data.timeAt(i), savedSet.data.timeAt(i));
+        // QCOMPARE allows floats to differ slightly, values must be exact
+        QVERIFY(readSet.data.valueAt(i) == savedSet.data.valueAt(i));
+    }
+
+    if(hasCoverage)
+    {
+        QVERIFY(readSet.coverage.intervals() == savedSet.coverage.intervals());
+    }
+}
+
+QTEST_APPLESS_MAIN(TestCacheFileHandler)
+
+#include "tst_cachefilehandler.moc"
@@ -0,0 +1,117 @@
+/**
+  * @file allocationcounter.cpp replaces the global operator new and delete
+  * with ones that count the allocations. The sizes are read back with
+  * malloc_usable_size, so this only works with glibc.
+  * @date 16.10.2026
+  */
+
+#include "allocationcounter.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// Stores how many allocations have been made
+static std::atomic<qint64> allocations(0);
+
+// Stores how many bytes are allocated right now
+static std::atomic<qint64> liveBytes(0);
+
+/**
+ * @brief countedAllocate allocates memory and counts it.
+ * @param size: How many bytes to allocate
+ * @return The allocated memory, or nullptr if there wasn't enough
+ */
+static void* countedAllocate(std::size_t size)
+{
+    void* memory = std::malloc(size == 0 ? 1 : size);
+
+    if (memory != nullptr)
+    {
+        allocations++;
+        liveBytes += qint64(malloc_usable_size(memory));
+    }
+
+    return memory;
+}
+
+/**
+ * @brief countedFree frees memory allocated with countedAllocate.
+ * @param memory: The memory to free, may be nullptr
+ */
+static void countedFree(void* memory)
+{
+    if (memory != nullptr)
+    {
+        liveBytes -= qint64(malloc_usable_size(memory));
+        std::free(memory);
+    }
+}
+
+qint64 allocationCount()
+{
+    return allocations;
+}
+
+qint64 liveAllocatedBytes()
+{
+    return liveBytes;
+}
+
+void* operator new(std::size_t size)
+{
+    void* memory = countedAllocate(size);
+
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    countedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    countedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    countedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    countedFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    countedFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    countedFree(memory);
+}
@@ -0,0 +1,29 @@
+/**
+  * @file allocationcounter.hh declares the functions the tests use to count
+  * the heap allocations of the test process. Linking allocationcounter.cpp
+  * into a test replaces the global operator new and delete with counting
+  * ones.
+  * @date 16.10.2026
+  */
+
+#ifndef ALLOCATIONCOUNTER_HH
+#define ALLOCATIONCOUNTER_HH
+
+#include <QtGlobal>
+
+/**
+ * @brief allocationCount returns how many times operator new has been called
+ * by this process.
+ * @return The number of allocations
+ */
+qint64 allocationCount();
+
+/**
+ * @brief liveAllocatedBytes returns how much memory allocated with operator
+ * new hasn't been deleted yet.
+ * @return The size of the live allocations in bytes, including what the
+ * allocator rounds each of them up to
+ */
+qint64 liveAllocatedBytes();
+
+#endif // ALLOCATIONCOUNTER_HH
@@ -0,0 +1,62 @@
+/**
+  * @file fmistub.cpp implements makeFmiReply.
+  * @date 16.10.2026
+  */
+
+#include "fmistub.hh"
+
+#include <QDateTime>
+#include <QUrl>
+#include <QUrlQuery>
+
+HttpStubReply makeFmiReply(const QByteArray& path, qint64 stepSecs)
+{
+    QUrlQuery query(QUrl("http://stub" + QString::fromLatin1(path)));
+
+    QDateTime startTime = QDateTime::fromString(
+        query.queryItemValue("starttime"), Qt::ISODate);
+    QDateTime endTime = QDateTime::fromString(
+        query.queryItemValue("endtime"), Qt::ISODate);
+
+    if (!startTime.isValid() || !endTime.isValid())
+    {
+        return { 400, QByteArray() };
+    }
+
+    QStringList parameters = query.queryItemValue("parameters").split(',');
+
+    QByteArray body =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<wfs:FeatureCollection"
+        " xmlns:wfs=\"http://www.opengis.net/wfs/2.0\""
+        " xmlns:BsWfs=\"http://xml.fmi.fi/namespace/wfs/2012/11/"
+        "simple-features\">\n";
+
+    for (qint64 secs = startTime.toSecsSinceEpoch();
+         secs <= endTime.toSecsSinceEpoch(); secs += stepSecs)
+    {
+        QByteArray time = QDateTime::fromSecsSinceEpoch(secs, Qt::UTC)
+            .toString(Qt::ISODate).toLatin1();
+
+        for (const QString& parameter : parameters)
+        {
+            body += "<wfs:member><BsWfs:BsWfsElement>"
+                    "<BsWfs:Time>" + time + "</BsWfs:Time>"
+                    "<BsWfs:ParameterName>" + parameter.toLatin1()
+                    + "</BsWfs:ParameterName>"
+                    "<BsWfs:ParameterValue>"
+                    + QByteArray::number(fmiValueAt(secs))
+                    + "</BsWfs:ParameterValue>"
+                    "</BsWfs:BsWfsElement></wfs:member>\n";
+        }
+    }
+
+    body += "</wfs:FeatureCollection>\n";
+
+    return { 200, body };
+}
+
+float fmiValueAt(qint64 secs)
+{
+    return float(secs / 3600 % 50);
+}
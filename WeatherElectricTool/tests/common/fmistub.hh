@@ -0,0 +1,31 @@
+/**
+  * @file fmistub.hh declares makeFmiReply, which is used by the tests to
+  * answer FMI API requests made to an HttpStubServer.
+  * @date 16.10.2026
+  */
+
+#ifndef FMISTUB_HH
+#define FMISTUB_HH
+
+#include "httpstubserver.hh"
+
+/**
+ * @brief makeFmiReply makes an FMI API reply with a data point of every
+ * requested parameter every given number of seconds between the requested
+ * start and end times. The value of each point is its time in hours modulo
+ * 50.
+ * @param path: The path of the request, including its query
+ * @param stepSecs: How many seconds there are between data points
+ * @return The reply, or a reply with status 400 if the request was missing
+ * its times
+ */
+HttpStubReply makeFmiReply(const QByteArray& path, qint64 stepSecs);
+
+/**
+ * @brief fmiValueAt returns the value makeFmiReply gives a data point.
+ * @param secs: The time of the data point in seconds since the epoch
+ * @return The value
+ */
+float fmiValueAt(qint64 secs);
+
+#endif // FMISTUB_HH
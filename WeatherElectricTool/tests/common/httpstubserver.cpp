@@ -0,0 +1,200 @@
+/**
+  * @file httpstubserver.cpp implements the HttpStubServer class.
+  * @date 16.10.2026
+  */
+
+#include "httpstubserver.hh"
+
+#include <QTimer>
+
+#include <algorithm>
+
+HttpStubServer::HttpStubServer(Handler handler, QObject* parent) :
+    QObject(parent), handler_(handler), server_(), receivedData_(),
+    openRequestCounts_(), heldReplies_(), replyDelayMilliseconds_(0),
+    holdReplies_(false), maxOpenRequestCount_(0), requestPaths_(),
+    requestTimes_(), clock_()
+{
+    clock_.start();
+
+    connect(&server_, &QTcpServer::newConnection,
+            this, &HttpStubServer::acceptConnections);
+
+    server_.listen(QHostAddress::LocalHost);
+}
+
+std::string HttpStubServer::baseUrl() const
+{
+    return "http://127.0.0.1:" + std::to_string(server_.serverPort());
+}
+
+void HttpStubServer::setReplyDelay(int milliseconds)
+{
+    replyDelayMilliseconds_ = milliseconds;
+}
+
+void HttpStubServer::setHoldReplies(bool hold)
+{
+    holdReplies_ = hold;
+}
+
+bool HttpStubServer::releaseRandomHeldReply(std::mt19937& random)
+{
+    while (!heldReplies_.empty())
+    {
+        std::size_t index = std::uniform_int_distribution<std::size_t>(
+            0, heldReplies_.size() - 1)(random);
+
+        OpenRequest request = heldReplies_.at(index);
+        heldReplies_.erase(heldReplies_.begin() + index);
+
+        if (sendReply(request))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool HttpStubServer::releaseFirstHeldReply()
+{
+    while (!heldReplies_.empty())
+    {
+        OpenRequest request = heldReplies_.front();
+        heldReplies_.erase(heldReplies_.begin());
+
+        if (sendReply(request))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int HttpStubServer::heldReplyCount() const
+{
+    // Replies to aborted requests can't be sent anymore
+    return int(std::count_if(heldReplies_.begin(), heldReplies_.end(),
+                             [this](const OpenRequest& request)
+    {
+        return !request.socket.isNull()
+               && openRequestCounts_.count(request.socket.data()) != 0;
+    }));
+}
+
+int HttpStubServer::openRequestCount() const
+{
+    int count = 0;
+
+    for (const auto& openRequestCount : openRequestCounts_)
+    {
+        count += openRequestCount.second;
+    }
+
+    return count;
+}
+
+int HttpStubServer::maxOpenRequestCount() const
+{
+    return maxOpenRequestCount_;
+}
+
+const std::vector<QByteArray>& HttpStubServer::requestPaths() const
+{
+    return requestPaths_;
+}
+
+const std::vector<qint64>& HttpStubServer::requestTimes() const
+{
+    return requestTimes_;
+}
+
+void HttpStubServer::acceptConnections()
+{
+    while (QTcpSocket* socket = server_.nextPendingConnection())
+    {
+        openRequestCounts_[socket] = 0;
+
+        connect(socket, &QTcpSocket::readyRead,
+                this, [this, socket]() { readRequests(socket); });
+
+        // Aborted requests are closed by the client
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]()
+        {
+            receivedData_.erase(socket);
+            openRequestCounts_.erase(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void HttpStubServer::readRequests(QTcpSocket* socket)
+{
+    QByteArray& data = receivedData_[socket];
+    data += socket->readAll();
+
+    std::vector<QByteArray> paths;
+
+    // GET requests end with an empty line and have no body
+    for (int headerEnd = data.indexOf("\r\n\r\n"); headerEnd >= 0;
+         headerEnd = data.indexOf("\r\n\r\n"))
+    {
+        QByteArray requestLine = data.left(data.indexOf("\r\n"));
+        data.remove(0, headerEnd + 4);
+
+        paths.push_back(requestLine.split(' ').value(1));
+    }
+
+    for (const QByteArray& path : paths)
+    {
+        requestPaths_.push_back(path);
+        requestTimes_.push_back(clock_.elapsed());
+
+        openRequestCounts_[socket]++;
+        maxOpenRequestCount_ = std::max(maxOpenRequestCount_,
+                                        openRequestCount());
+
+        OpenRequest request = { socket, handler_(path) };
+
+        if (holdReplies_)
+        {
+            heldReplies_.push_back(request);
+        }
+        else if (replyDelayMilliseconds_ > 0)
+        {
+            QTimer::singleShot(replyDelayMilliseconds_, this,
+                               [this, request]() { sendReply(request); });
+        }
+        else
+        {
+            sendReply(request);
+        }
+
+        emit requestReceived(path);
+    }
+}
+
+bool HttpStubServer::sendReply(const OpenRequest& request)
+{
+    QTcpSocket* socket = request.socket.data();
+
+    // The client has given up on the request
+    if (socket == nullptr || openRequestCounts_.count(socket) == 0)
+    {
+        return false;
+    }
+
+    openRequestCounts_[socket]--;
+
+    socket->write("HTTP/1.1 " + QByteArray::number(request.reply.statusCode)
+                  + " Stub\r\n"
+                  + "Content-Type: application/xml\r\n"
+                  + "Content-Length: "
+                  + QByteArray::number(request.reply.body.size())
+                  + "\r\n\r\n"
+                  + request.reply.body);
+
+    return true;
+}
@@ -0,0 +1,179 @@
+/**
+  * @file httpstubserver.hh declares the HttpStubServer class, which is used by
+  * the tests to answer network requests locally.
+  * @date 16.10.2026
+  */
+
+#ifndef HTTPSTUBSERVER_HH
+#define HTTPSTUBSERVER_HH
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+/**
+ * @brief The HttpStubReply struct stores the reply to a single request.
+ */
+struct HttpStubReply
+{
+    int statusCode;
+    QByteArray body;
+};
+
+/**
+ * @brief The HttpStubServer class is an HTTP server on the local host that
+ * answers every GET request with the reply a handler makes for its path.
+ * Replies can be delayed or held back and released later in any order, and
+ * the requests and the most replies awaited at once are recorded.
+ */
+class HttpStubServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<HttpStubReply(const QByteArray& path)> Handler;
+
+    /**
+     * @brief The default constructor. Starts listening right away.
+     * @param handler: Makes the reply to each request from its path
+     * @param parent: The QObject to parent this HttpStubServer to
+     */
+    explicit HttpStubServer(Handler handler, QObject* parent = nullptr);
+
+    /**
+     * @brief baseUrl returns the address requests to this server start with.
+     * @return The address, for example "http://127.0.0.1:12345"
+     */
+    std::string baseUrl() const;
+
+    /**
+     * @brief setReplyDelay makes every later reply wait before it's sent.
+     * @param milliseconds: How long to wait
+     */
+    void setReplyDelay(int milliseconds);
+
+    /**
+     * @brief setHoldReplies holds every later reply back until it's released
+     * with releaseRandomHeldReply or releaseFirstHeldReply.
+     * @param hold: True to hold replies back, false to send them right away
+     */
+    void setHoldReplies(bool hold);
+
+    /**
+     * @brief releaseRandomHeldReply sends one of the held replies, chosen at
+     * random.
+     * @param random: The random number generator to choose the reply with
+     * @return True if a reply was sent, false if none were held
+     */
+    bool releaseRandomHeldReply(std::mt19937& random);
+
+    /**
+     * @brief releaseFirstHeldReply sends the reply held the longest.
+     * @return True if a reply was sent, false if none were held
+     */
+    bool releaseFirstHeldReply();
+
+    /**
+     * @brief heldReplyCount returns how many replies are held back.
+     * @return The number of held replies
+     */
+    int heldReplyCount() const;
+
+    /**
+     * @brief openRequestCount returns how many requests haven't been replied
+     * to yet. Requests aborted by the client aren't counted.
+     * @return The number of open requests
+     */
+    int openRequestCount() const;
+
+    /**
+     * @brief maxOpenRequestCount returns the most requests that have been
+     * open at the same time.
+     * @return The highest number of open requests
+     */
+    int maxOpenRequestCount() const;
+
+    /**
+     * @brief requestPaths returns the paths of every request received, in
+     * the order they were received.
+     * @return The paths
+     */
+    const std::vector<QByteArray>& requestPaths() const;
+
+    /**
+     * @brief requestTimes returns when each request was received.
+     * @return The milliseconds since this server was created, in the order
+     * of requestPaths
+     */
+    const std::vector<qint64>& requestTimes() const;
+
+signals:
+    /**
+     * @brief The requestReceived signal is sent whenever a request has been
+     * received.
+     * @param path: The path of the request
+     */
+    void requestReceived(const QByteArray& path);
+
+private:
+    /**
+     * @brief The OpenRequest struct stores a request waiting for its reply.
+     */
+    struct OpenRequest
+    {
+        QPointer<QTcpSocket> socket;
+        HttpStubReply reply;
+    };
+
+    /**
+     * @brief acceptConnections starts reading the requests of new
+     * connections.
+     */
+    void acceptConnections();
+
+    /**
+     * @brief readRequests reads every whole request received by a socket and
+     * replies to them.
+     * @param socket: The socket that received data
+     */
+    void readRequests(QTcpSocket* socket);
+
+    /**
+     * @brief sendReply writes a reply to its socket unless the client has
+     * given up on the request.
+     * @param request: The request to reply to
+     * @return True if the reply was sent, otherwise false
+     */
+    bool sendReply(const OpenRequest& request);
+
+    // Makes the replies
+    Handler handler_;
+
+    QTcpServer server_;
+
+    // Stores the data received from each socket that isn't a whole request
+    std::map<QTcpSocket*, QByteArray> receivedData_;
+
+    // Stores how many requests of each socket are waiting for a reply
+    std::map<QTcpSocket*, int> openRequestCounts_;
+
+    // Stores the replies held back, in the order they were made
+    std::vector<OpenRequest> heldReplies_;
+
+    int replyDelayMilliseconds_;
+    bool holdReplies_;
+    int maxOpenRequestCount_;
+
+    std::vector<QByteArray> requestPaths_;
+    std::vector<qint64> requestTimes_;
+    QElapsedTimer clock_;
+};
+
+#endif // HTTPSTUBSERVER_HH
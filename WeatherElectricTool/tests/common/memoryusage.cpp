@@ -0,0 +1,57 @@
+/**
+  * @file memoryusage.cpp implements the memory measuring functions of the
+  * tests by reading the process status Linux provides.
+  * @date 16.10.2026
+  */
+
+#include "memoryusage.hh"
+
+#include <QByteArray>
+#include <QFile>
+
+/**
+ * @brief statusBytes reads a size from the status of this process.
+ * @param field: The name of the size, for example "VmRSS:"
+ * @return The size in bytes, or -1 if it can't be read
+ */
+static qint64 statusBytes(const QByteArray& field)
+{
+    QFile status("/proc/self/status");
+
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return -1;
+    }
+
+    // The line looks like "VmRSS:     1234 kB"
+    for (QByteArray line = status.readLine(); !line.isEmpty();
+         line = status.readLine())
+    {
+        if (line.startsWith(field))
+        {
+            return line.mid(field.size()).trimmed().split(' ').first()
+                .toLongLong() * 1024;
+        }
+    }
+
+    return -1;
+}
+
+qint64 residentBytes()
+{
+    return statusBytes("VmRSS:");
+}
+
+qint64 peakResidentBytes()
+{
+    return statusBytes("VmHWM:");
+}
+
+bool resetPeakResidentBytes()
+{
+    QFile clearRefs("/proc/self/clear_refs");
+
+    // Writing 5 resets the peak, see proc(5)
+    return clearRefs.open(QIODevice::WriteOnly)
+           && clearRefs.write("5") == 1;
+}
@@ -0,0 +1,33 @@
+/**
+  * @file memoryusage.hh declares the functions the tests use to measure how
+  * much memory the test process has in RAM.
+  * @date 16.10.2026
+  */
+
+#ifndef MEMORYUSAGE_HH
+#define MEMORYUSAGE_HH
+
+#include <QtGlobal>
+
+/**
+ * @brief residentBytes returns how much of the memory of this process is in
+ * RAM.
+ * @return The resident set size in bytes, or -1 if it can't be read
+ */
+qint64 residentBytes();
+
+/**
+ * @brief peakResidentBytes returns the most memory this process has had in
+ * RAM since it started or since resetPeakResidentBytes was last called.
+ * @return The peak resident set size in bytes, or -1 if it can't be read
+ */
+qint64 peakResidentBytes();
+
+/**
+ * @brief resetPeakResidentBytes sets the peak resident set size to the
+ * current one, so that the peak of a single step can be measured.
+ * @return True if the peak was reset, otherwise false
+ */
+bool resetPeakResidentBytes();
+
+#endif // MEMORYUSAGE_HH
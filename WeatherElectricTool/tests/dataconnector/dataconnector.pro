@@ -0,0 +1,53 @@
+include(../tests.pri)
+
+# The series are made with the chart types, fetches go to a stub server
+QT += gui charts widgets network xml
+
+TARGET = tst_dataconnector
+
+SOURCES += \
+    tst_dataconnector.cpp \
+    $$COMMON_DIR/allocationcounter.cpp \
+    $$COMMON_DIR/httpstubserver.cpp \
+    $$COMMON_DIR/fmistub.cpp \
+    $$MAIN_DIR/dataconnector.cpp \
+    $$MAIN_DIR/cachefilehandler.cpp \
+    $$MAIN_DIR/DataImporting/dataimporter.cpp \
+    $$MAIN_DIR/DataImporting/xmlfetcher.cpp \
+    $$MAIN_DIR/DataImporting/xmldataimporter.cpp \
+    $$MAIN_DIR/DataImporting/fmidataimporter.cpp \
+    $$MAIN_DIR/DataImporting/fingriddataimporter.cpp \
+    $$MAIN_DIR/DataImporting/datasegmenter.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/requestscheduler.cpp \
+    $$MAIN_DIR/DataImporting/intervalset.cpp \
+    $$MAIN_DIR/DataImporting/segmentcache.cpp \
+    $$MAIN_DIR/DataImporting/datajournal.cpp \
+    $$MAIN_DIR/DataImporting/cachingdataimporter.cpp \
+    $$MAIN_DIR/DataImporting/rolluppyramid.cpp \
+    $$MAIN_DIR/DataImporting/xmlparser.cpp \
+    $$MAIN_DIR/DataImporting/minmaxtree.cpp \
+    $$MAIN_DIR/DataImporting/windowaggregates.cpp
+
+HEADERS += \
+    $$COMMON_DIR/allocationcounter.hh \
+    $$COMMON_DIR/httpstubserver.hh \
+    $$COMMON_DIR/fmistub.hh \
+    $$MAIN_DIR/dataconnector.h \
+    $$MAIN_DIR/cachefilehandler.h \
+    $$MAIN_DIR/DataImporting/dataimporter.hh \
+    $$MAIN_DIR/DataImporting/xmlfetcher.hh \
+    $$MAIN_DIR/DataImporting/xmldataimporter.hh \
+    $$MAIN_DIR/DataImporting/fmidataimporter.hh \
+    $$MAIN_DIR/DataImporting/fingriddataimporter.hh \
+    $$MAIN_DIR/DataImporting/datasegmenter.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh \
+    $$MAIN_DIR/DataImporting/requestscheduler.hh \
+    $$MAIN_DIR/DataImporting/intervalset.hh \
+    $$MAIN_DIR/DataImporting/segmentcache.hh \
+    $$MAIN_DIR/DataImporting/datajournal.hh \
+    $$MAIN_DIR/DataImporting/cachingdataimporter.hh \
+    $$MAIN_DIR/DataImporting/rolluppyramid.hh \
+    $$MAIN_DIR/DataImporting/xmlparser.hh \
+    $$MAIN_DIR/DataImporting/minmaxtree.hh \
+    $$MAIN_DIR/DataImporting/windowaggregates.hh
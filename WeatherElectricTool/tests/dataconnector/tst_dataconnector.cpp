@@ -0,0 +1,640 @@
+/**
+  * @file tst_dataconnector.cpp tests that DataConnector fetches only the
+  * data it doesn't have yet when the shown time interval changes.
+  * @date 16.10.2026
+  */
+
+#include "allocationcounter.hh"
+#include "cachefilehandler.h"
+#include "dataconnector.h"
+#include "fmistub.hh"
+#include "httpstubserver.hh"
+
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <algorithm>
+
+// Times are counted in days from here
+static const qint64 START_SECS = 1600041600;
+static const qint64 DAY_SECS = 24 * 60 * 60;
+
+// Answered fetches get a data point every this many seconds
+static const qint64 POINT_STEP_SECS = 60 * 60;
+
+// How long the slow stub server waits before replying, long enough that a
+// request only ends early when it's cancelled
+static const int SLOW_REPLY_DELAY_MILLISECONDS = 3000;
+
+// How many times the time interval is moved while the fetches are slow
+static const int WINDOW_CHANGE_COUNT = 20;
+
+// The benchmarks store a data point every minute
+static const qint64 MINUTE_SECS = 60;
+
+// How many days of minute data make over a million stored points
+static const qint64 MILLION_POINT_DAYS = 720;
+
+/**
+ * @brief day returns the time some days after START_SECS.
+ * @param days is the number of days.
+ * @return the time in seconds since the epoch.
+ */
+static qint64 day(qint64 days)
+{
+    return START_SECS + days * DAY_SECS;
+}
+
+/**
+ * @brief dateTime converts seconds since the epoch into a QDateTime.
+ * @param secs is the time in seconds since the epoch.
+ * @return the QDateTime.
+ */
+static QDateTime dateTime(qint64 secs)
+{
+    return QDateTime::fromSecsSinceEpoch(secs);
+}
+
+/**
+ * @brief intervals makes a list of one time interval.
+ * @param startDays is the start of the time interval in days from START_SECS.
+ * @param endDays is the end of the time interval in days from START_SECS.
+ * @return the list.
+ */
+static std::vector<DataImporting::TimeInterval> intervals(qint64 startDays, qint64 endDays)
+{
+    return {{day(startDays), day(endDays)}};
+}
+
+/**
+ * @brief The FakeDataImporter class records the fetches made through it and
+ * answers them only when told to.
+ */
+class FakeDataImporter : public DataImporting::DataImporter
+{
+public:
+    FakeDataImporter() : DataImporter(nullptr), pointStepSecs_(POINT_STEP_SECS)
+    {
+    }
+
+    void fetchData(const DataImporting::ApiDataType& dataType, const QDateTime& startTime,
+                   const QDateTime& endTime, const std::string& location) override
+    {
+        DataImporting::TimeInterval interval = {startTime.toSecsSinceEpoch(),
+                                                endTime.toSecsSinceEpoch()};
+        requests_.push_back(interval);
+        unanswered_.push_back({dataType, location, interval});
+    }
+
+    std::vector<DataImporting::ApiDataType> getAvailableDataTypes() override
+    {
+        return {DataImporting::Temperature};
+    }
+
+    std::vector<std::string> getAvailableLocations() override
+    {
+        return {"Tampere"};
+    }
+
+    bool canFetchDataType(const DataImporting::ApiDataType& dataType) override
+    {
+        return dataType == DataImporting::Temperature;
+    }
+
+    std::string getSourceName() override
+    {
+        return "Fake";
+    }
+
+    /**
+     * @brief takeRequests returns the time intervals fetched since the last call.
+     * @return the fetched time intervals in the order they were fetched.
+     */
+    std::vector<DataImporting::TimeInterval> takeRequests()
+    {
+        std::vector<DataImporting::TimeInterval> requests;
+        requests.swap(requests_);
+        return requests;
+    }
+
+    /**
+     * @brief setPointStep sets how far apart the data points of later answers are.
+     * @param secs is the time between the data points in seconds.
+     */
+    void setPointStep(qint64 secs)
+    {
+        pointStepSecs_ = secs;
+    }
+
+    /**
+     * @brief answerFetches emits data for every fetch not answered yet.
+     */
+    void answerFetches()
+    {
+        std::vector<Fetch> unanswered;
+        unanswered.swap(unanswered_);
+
+        for(const Fetch& fetch : unanswered)
+        {
+            std::shared_ptr<DataImporting::TimeSeries> data =
+                std::make_shared<DataImporting::TimeSeries>();
+            for(qint64 time = fetch.interval.first; time <= fetch.interval.second;
+                time += pointStepSecs_)
+            {
+                data->append(time, float(time / POINT_STEP_SECS % 50));
+            }
+            std::pair<float, float> minMax = data->minMaxValues();
+
+            DataImporting::DataFetchDetails details = {fetch.dataType, fetch.location, "degC", this,
+                                                       dateTime(fetch.interval.first),
+                                                       dateTime(fetch.interval.second),
+                                                       minMax.second, minMax.first};
+            emit dataFetched(details, data);
+        }
+    }
+
+private:
+    /**
+     * @brief The Fetch struct stores a fetch that hasn't been answered yet.
+     */
+    struct Fetch
+    {
+        DataImporting::ApiDataType dataType;
+        std::string location;
+        DataImporting::TimeInterval interval;
+    };
+
+    // Time intervals fetched since the last takeRequests
+    std::vector<DataImporting::TimeInterval> requests_;
+
+    // Fetches that haven't been answered yet
+    std::vector<Fetch> unanswered_;
+
+    // Time between the data points of the answers
+    qint64 pointStepSecs_;
+};
+
+/**
+ * @brief The TestDataConnector class tests how DataConnector fetches data when the time
+ * interval changes.
+ */
+class TestDataConnector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief initTestCase keeps the journal away from the user's data.
+     */
+    void initTestCase();
+
+    /**
+     * @brief init creates a DataConnector with a fake importer that shows the first ten days.
+     */
+    void init();
+
+    /**
+     * @brief cleanup deletes the DataConnector and the series it made.
+     */
+    void cleanup();
+
+    /**
+     * @brief disjointWindowFetchesWholeWindow moves to a time interval that doesn't overlap the
+     * fetched one and checks that all of it is fetched once.
+     */
+    void disjointWindowFetchesWholeWindow();
+
+    /**
+     * @brief nestedWindowFetchesNothing narrows the time interval and widens it back and checks
+     * that nothing is fetched again.
+     */
+    void nestedWindowFetchesNothing();
+
+    /**
+     * @brief multiGapWindowFetchesEveryGap widens the time interval over several fetched ones and
+     * checks that exactly the gaps between them are fetched.
+     */
+    void multiGapWindowFetchesEveryGap();
+
+    /**
+     * @brief pendingDataIsNotFetchedAgain returns to time intervals whose fetches haven't been
+     * answered yet and checks that they aren't fetched twice.
+     */
+    void pendingDataIsNotFetchedAgain();
+
+    /**
+     * @brief resavingKeepsUnreadArchivedData loads a file whose data is mostly outside of its
+     * time interval, saves it again and checks that the data that was never read is kept.
+     */
+    void resavingKeepsUnreadArchivedData();
+
+    /**
+     * @brief rapidWindowChangesCancelFetches moves the time interval many times while a slow
+     * stub server answers the fetches and checks that the requests of earlier time intervals
+     * are cancelled and that none of their data is saved.
+     */
+    void rapidWindowChangesCancelFetches();
+
+    /**
+     * @brief leftwardPansBenchmark pans a week at a time from the end of a year of minute data
+     * to its start, so that every fetch lands before the stored data.
+     */
+    void leftwardPansBenchmark();
+
+    /**
+     * @brief setBoundaryDatesBenchmark moves between two month long time intervals of over a
+     * million stored points, which are shown without fetching anything.
+     */
+    void setBoundaryDatesBenchmark();
+
+    /**
+     * @brief setBoundaryDatesAllocations counts the allocations of showing a month of over a
+     * million stored points and checks that they don't grow with the stored points.
+     */
+    void setBoundaryDatesAllocations();
+
+    /**
+     * @brief drawnPointCount_data makes a row for some chart widths in points.
+     */
+    void drawnPointCount_data();
+
+    /**
+     * @brief drawnPointCount shows a month of minute data and counts how many data points are
+     * given to the chart, which must stay within the resolution of the chart.
+     */
+    void drawnPointCount();
+
+private:
+    /**
+     * @brief setWindow changes the shown time interval.
+     * @param startDays is the start of the time interval in days from START_SECS.
+     * @param endDays is the end of the time interval in days from START_SECS.
+     */
+    void setWindow(qint64 startDays, qint64 endDays);
+
+    /**
+     * @brief answerFetches answers every fetch not answered yet.
+     */
+    void answerFetches();
+
+    /**
+     * @brief storeMillionPoints fetches over a million data points, a minute apart.
+     */
+    void storeMillionPoints();
+
+    /**
+     * @brief adoptSeries gives the series the DataConnector has made to seriesOwner_, like the
+     * charts take them in the program.
+     */
+    void adoptSeries();
+
+    /**
+     * @brief adoptSeries gives the series some DataConnector has made to seriesOwner_.
+     * @param connector is the DataConnector.
+     */
+    void adoptSeries(DataConnector* connector);
+
+    // The importer the connector fetches from, outlives connector_
+    FakeDataImporter* importer_ = nullptr;
+
+    DataConnector* connector_ = nullptr;
+
+    // Parent of the series made by connector_, deleted after each test
+    QObject* seriesOwner_ = nullptr;
+
+    // Temporary directory for the saved files
+    QTemporaryDir directory_;
+};
+
+void TestDataConnector::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/journal")
+        .removeRecursively();
+}
+
+void TestDataConnector::init()
+{
+    importer_ = new FakeDataImporter;
+    connector_ = new DataConnector(std::vector<DataImporting::DataImporter*>{importer_});
+    seriesOwner_ = new QObject;
+
+    // The graph deletes the series of added points
+    connect(connector_, &DataConnector::addToSeries, seriesOwner_,
+            [](std::string, DataSeries addedSeries, bool)
+    {
+        delete addedSeries.lineSeries;
+    });
+
+    setWindow(0, 10);
+    connector_->addActiveDataSource(connector_->getAllDataSourceDetails().front());
+    QVERIFY(importer_->takeRequests() == intervals(0, 10));
+
+    answerFetches();
+}
+
+void TestDataConnector::cleanup()
+{
+    delete connector_;
+    delete importer_;
+    delete seriesOwner_;
+}
+
+void TestDataConnector::disjointWindowFetchesWholeWindow()
+{
+    setWindow(20, 30);
+    QVERIFY(importer_->takeRequests() == intervals(20, 30));
+    answerFetches();
+
+    // Both time intervals are fetched now
+    setWindow(0, 10);
+    QVERIFY(importer_->takeRequests().empty());
+    setWindow(20, 30);
+    QVERIFY(importer_->takeRequests().empty());
+}
+
+void TestDataConnector::nestedWindowFetchesNothing()
+{
+    setWindow(2, 8);
+    QVERIFY(importer_->takeRequests().empty());
+
+    setWindow(0, 10);
+    QVERIFY(importer_->takeRequests().empty());
+
+    // The points of the widened ends are taken from the stored data
+    QCOMPARE(connector_->getData().second.size(), std::size_t(1));
+    QVERIFY(connector_->getData().second.begin()->second.lineSeries->count() > 0);
+}
+
+void TestDataConnector::multiGapWindowFetchesEveryGap()
+{
+    setWindow(15, 20);
+    answerFetches();
+    setWindow(25, 30);
+    answerFetches();
+    importer_->takeRequests();
+
+    // The start is widened over three gaps and the end over one
+    setWindow(-5, 35);
+    std::vector<DataImporting::TimeInterval> expected = {{day(-5), day(0)},
+                                                         {day(10), day(15)},
+                                                         {day(20), day(25)},
+                                                         {day(30), day(35)}};
+    QVERIFY(importer_->takeRequests() == expected);
+
+    answerFetches();
+    setWindow(-5, 35);
+    QVERIFY(importer_->takeRequests().empty());
+}
+
+void TestDataConnector::pendingDataIsNotFetchedAgain()
+{
+    setWindow(20, 30);
+    QVERIFY(importer_->takeRequests() == intervals(20, 30));
+
+    // Narrowing and widening over the pending fetch finds no stored points to show
+    setWindow(25, 30);
+    setWindow(20, 30);
+    QVERIFY(importer_->takeRequests().empty());
+
+    setWindow(0, 10);
+    QVERIFY(importer_->takeRequests().empty());
+
+    answerFetches();
+    setWindow(0, 30);
+    QVERIFY(importer_->takeRequests() == intervals(10, 20));
+}
+
+void TestDataConnector::resavingKeepsUnreadArchivedData()
+{
+    QVERIFY(directory_.isValid());
+    QString savedFileName = directory_.filePath("saved.bin");
+    QString resavedFileName = directory_.filePath("resaved.bin");
+
+    setWindow(0, 30);
+    answerFetches();
+
+    // Only the shown time interval is read when the file is loaded
+    setWindow(10, 12);
+    connector_->saveCurrentDataSets(savedFileName);
+    connector_->loadDataSets(savedFileName);
+    connector_->addActiveDataSource(connector_->getAllDataSourceDetails().front());
+    adoptSeries();
+    QVERIFY(importer_->takeRequests().empty());
+
+    connector_->saveCurrentDataSets(resavedFileName);
+
+    std::vector<DataSet> saved = CacheFileHandler::readDataSet(savedFileName).second;
+    std::vector<DataSet> resaved = CacheFileHandler::readDataSet(resavedFileName).second;
+    QCOMPARE(resaved.size(), std::size_t(1));
+    QCOMPARE(saved.size(), std::size_t(1));
+    QCOMPARE(saved.front().data.size(), std::size_t(30 * DAY_SECS / POINT_STEP_SECS + 1));
+
+    QVERIFY(resaved.front().coverage.intervals() == intervals(0, 30));
+    QCOMPARE(resaved.front().data.size(), saved.front().data.size());
+    for(std::size_t i = 0; i < saved.front().data.size(); i++)
+    {
+        QCOMPARE(resaved.front().data.timeAt(i), saved.front().data.timeAt(i));
+        QCOMPARE(resaved.front().data.valueAt(i), saved.front().data.valueAt(i));
+    }
+}
+
+void TestDataConnector::rapidWindowChangesCancelFetches()
+{
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+    server.setReplyDelay(SLOW_REPLY_DELAY_MILLISECONDS);
+
+    // The importer outlives the connector like in init
+    DataImporting::CachingDataImporter importer(
+        new DataImporting::FmiDataImporter(server.baseUrl()));
+    DataConnector connector(std::vector<DataImporting::DataImporter*>{&importer});
+
+    connect(&connector, &DataConnector::addToSeries, seriesOwner_,
+            [](std::string, DataSeries addedSeries, bool)
+    {
+        delete addedSeries.lineSeries;
+    });
+
+    // Data reaching the connector has to be of the time interval shown when it arrives
+    DataImporting::TimeInterval shown = {day(0), day(3)};
+    std::vector<DataImporting::TimeInterval> staleIntervals;
+    bool shownDataArrived = false;
+    connect(&importer, &DataImporting::DataImporter::dataFetched, this,
+            [&](DataImporting::DataFetchDetails fetchDetails,
+                std::shared_ptr<DataImporting::TimeSeries>)
+    {
+        DataImporting::TimeInterval fetched = {fetchDetails.startDateTime.toSecsSinceEpoch(),
+                                               fetchDetails.endDateTime.toSecsSinceEpoch()};
+
+        if(fetched.second <= shown.first || fetched.first >= shown.second)
+        {
+            staleIntervals.push_back(fetched);
+        }
+        else
+        {
+            shownDataArrived = true;
+        }
+    });
+
+    connector.setBoundaryDates(dateTime(shown.first), dateTime(shown.second));
+
+    std::vector<DataSourceDetails> sources = connector.getAllDataSourceDetails();
+    auto sourceIt = std::find_if(sources.begin(), sources.end(), [](const DataSourceDetails& source)
+    {
+        return source.dataType == DataImporting::Temperature
+               && source.dataLocationName == "Tampere";
+    });
+    QVERIFY(sourceIt != sources.end());
+    connector.addActiveDataSource(*sourceIt);
+    adoptSeries(&connector);
+    QTRY_COMPARE(server.requestPaths().size(), std::size_t(1));
+
+    for(int i = 1; i < WINDOW_CHANGE_COUNT; i++)
+    {
+        shown = {day(10 * i), day(10 * i + 3)};
+        connector.setBoundaryDates(dateTime(shown.first), dateTime(shown.second));
+        adoptSeries(&connector);
+
+        // Only the request of the shown time interval may stay open
+        QTRY_COMPARE(server.requestPaths().size(), std::size_t(i + 1));
+        QTRY_VERIFY_WITH_TIMEOUT(server.openRequestCount() <= 1,
+                                 SLOW_REPLY_DELAY_MILLISECONDS / 2);
+    }
+
+    QVERIFY(server.maxOpenRequestCount() <= 2);
+
+    QTRY_VERIFY_WITH_TIMEOUT(shownDataArrived, 2 * SLOW_REPLY_DELAY_MILLISECONDS);
+    QTRY_COMPARE(server.openRequestCount(), 0);
+    adoptSeries(&connector);
+
+    QVERIFY(staleIntervals.empty());
+    QCOMPARE(server.requestPaths().size(), std::size_t(WINDOW_CHANGE_COUNT));
+}
+
+void TestDataConnector::leftwardPansBenchmark()
+{
+    importer_->setPointStep(MINUTE_SECS);
+    setWindow(358, 365);
+    answerFetches();
+    importer_->takeRequests();
+
+    // The last pan reaches the ten days fetched by init
+    int panCount = 0;
+    QBENCHMARK_ONCE
+    {
+        for(qint64 startDays = 351; startDays >= 8; startDays -= 7)
+        {
+            setWindow(startDays, startDays + 7);
+            answerFetches();
+            panCount++;
+        }
+    }
+
+    // Each pan fetched only the week it uncovered, so the whole year is stored now
+    QCOMPARE(importer_->takeRequests().size(), std::size_t(panCount));
+    setWindow(0, 365);
+    QVERIFY(importer_->takeRequests().empty());
+}
+
+void TestDataConnector::setBoundaryDatesBenchmark()
+{
+    storeMillionPoints();
+
+    QBENCHMARK
+    {
+        setWindow(100, 130);
+        setWindow(400, 430);
+    }
+
+    QVERIFY(importer_->takeRequests().empty());
+}
+
+void TestDataConnector::setBoundaryDatesAllocations()
+{
+    storeMillionPoints();
+    setWindow(400, 430);
+
+    qint64 allocationsBefore = allocationCount();
+    setWindow(100, 130);
+    qint64 allocations = allocationCount() - allocationsBefore;
+
+    QTest::setBenchmarkResult(allocations, QTest::Events);
+    QVERIFY(importer_->takeRequests().empty());
+    QVERIFY(allocations < MILLION_POINT_DAYS * DAY_SECS / MINUTE_SECS / 100);
+}
+
+void TestDataConnector::drawnPointCount_data()
+{
+    QTest::addColumn<int>("resolution");
+
+    QTest::newRow("100 points") << 100;
+    QTest::newRow("1000 points") << 1000;
+    QTest::newRow("1920 points") << 1920;
+    QTest::newRow("4000 points") << 4000;
+}
+
+void TestDataConnector::drawnPointCount()
+{
+    QFETCH(int, resolution);
+
+    connector_->setSeriesResolution(resolution);
+    importer_->setPointStep(MINUTE_SECS);
+    setWindow(40, 70);
+    answerFetches();
+
+    std::map<std::string, DataSeries> shownSeries = connector_->getData().second;
+    QCOMPARE(shownSeries.size(), std::size_t(1));
+
+    // Each bucket is drawn as at most two points, and the time interval may end in a bucket
+    // it only partly covers
+    int pointCount = shownSeries.begin()->second.lineSeries->count();
+    QTest::setBenchmarkResult(pointCount, QTest::Events);
+    QVERIFY(pointCount > 0);
+    QVERIFY(pointCount <= resolution + 2);
+}
+
+void TestDataConnector::setWindow(qint64 startDays, qint64 endDays)
+{
+    connector_->setBoundaryDates(dateTime(day(startDays)), dateTime(day(endDays)));
+    adoptSeries();
+}
+
+void TestDataConnector::answerFetches()
+{
+    importer_->answerFetches();
+    adoptSeries();
+}
+
+void TestDataConnector::storeMillionPoints()
+{
+    importer_->setPointStep(MINUTE_SECS);
+    setWindow(0, MILLION_POINT_DAYS);
+    answerFetches();
+    importer_->takeRequests();
+}
+
+void TestDataConnector::adoptSeries()
+{
+    adoptSeries(connector_);
+}
+
+void TestDataConnector::adoptSeries(DataConnector* connector)
+{
+    for(auto& series : connector->getData().second)
+    {
+        if(series.second.lineSeries->parent() == nullptr)
+        {
+            series.second.lineSeries->setParent(seriesOwner_);
+        }
+    }
+}
+
+QTEST_MAIN(TestDataConnector)
+
+#include "tst_dataconnector.moc"
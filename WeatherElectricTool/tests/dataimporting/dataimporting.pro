@@ -0,0 +1,33 @@
+include(../tests.pri)
+
+# The timestamp parser is part of the XML importers
+QT += network xml
+
+TARGET = tst_dataimporting
+
+SOURCES += \
+    tst_dataimporting.cpp \
+    $$COMMON_DIR/allocationcounter.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/intervalset.cpp \
+    $$MAIN_DIR/DataImporting/rolluppyramid.cpp \
+    $$MAIN_DIR/DataImporting/minmaxtree.cpp \
+    $$MAIN_DIR/DataImporting/windowaggregates.cpp \
+    $$MAIN_DIR/DataImporting/dataimporter.cpp \
+    $$MAIN_DIR/DataImporting/xmldataimporter.cpp \
+    $$MAIN_DIR/DataImporting/xmlfetcher.cpp \
+    $$MAIN_DIR/DataImporting/xmlparser.cpp \
+    $$MAIN_DIR/DataImporting/requestscheduler.cpp
+
+HEADERS += \
+    $$COMMON_DIR/allocationcounter.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh \
+    $$MAIN_DIR/DataImporting/intervalset.hh \
+    $$MAIN_DIR/DataImporting/rolluppyramid.hh \
+    $$MAIN_DIR/DataImporting/minmaxtree.hh \
+    $$MAIN_DIR/DataImporting/windowaggregates.hh \
+    $$MAIN_DIR/DataImporting/dataimporter.hh \
+    $$MAIN_DIR/DataImporting/xmldataimporter.hh \
+    $$MAIN_DIR/DataImporting/xmlfetcher.hh \
+    $$MAIN_DIR/DataImporting/xmlparser.hh \
+    $$MAIN_DIR/DataImporting/requestscheduler.hh
@@ -0,0 +1,1465 @@
+/**
+  * @file tst_dataimporting.cpp tests the data structures of DataImporting by
+  * comparing them with brute force versions over random data, and the
+  * parsing of API timestamps.
+  * @date 16.10.2026
+  */
+
+#include "DataImporting/intervalset.hh"
+#include "DataImporting/minmaxtree.hh"
+#include "DataImporting/rolluppyramid.hh"
+#include "DataImporting/timeseries.hh"
+#include "DataImporting/windowaggregates.hh"
+#include "DataImporting/xmldataimporter.hh"
+#include "allocationcounter.hh"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace DataImporting;
+
+/**
+ * @brief The Point struct stores a data point of the brute force version of
+ * a TimeSeries.
+ */
+struct Point
+{
+    qint64 time;
+    float value;
+
+    bool operator==(const Point& other) const
+    {
+        return time == other.time && value == other.value;
+    }
+};
+
+typedef std::vector<Point> Points;
+
+// The data starts in 2020 so that the times don't fit in a float
+static const qint64 START_SECS = 1600000000;
+
+// Stores how many data points WindowAggregates keeps in a block
+static const std::size_t BLOCK_SIZE = 64;
+
+// Stores how many timestamps the timestamp parsers are benchmarked with
+static const int TIMESTAMP_COUNT = 1000000;
+
+// Stores how many data points a year of minute data has
+static const qint64 MINUTES_PER_YEAR = 365 * 24 * 60;
+
+/**
+ * @brief The DateTimePoint struct stores a data point the way DataPoint did
+ * before TimeSeries, for comparing with it.
+ */
+struct DateTimePoint
+{
+    QDateTime time;
+    float value;
+};
+
+/**
+ * @brief randomInt returns a random integer in the given range.
+ * @param random: The random number generator to use
+ * @param min: The smallest possible integer
+ * @param max: The largest possible integer
+ * @return The random integer
+ */
+static qint64 randomInt(std::mt19937& random, qint64 min, qint64 max)
+{
+    return std::uniform_int_distribution<qint64>(min, max)(random);
+}
+
+/**
+ * @brief randomPoints creates data points with increasing times. Values are
+ * small integers so that they repeat and their sums are exact.
+ * @param random: The random number generator to use
+ * @param count: How many data points to create
+ * @param startSecs: The time of the first data point
+ * @param maxStepSecs: The longest time between two data points
+ * @return The data points in chronological order
+ */
+static Points randomPoints(std::mt19937& random, std::size_t count,
+                           qint64 startSecs, qint64 maxStepSecs)
+{
+    Points points;
+    qint64 time = startSecs;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        points.push_back({ time, float(randomInt(random, -20, 20)) });
+        time += randomInt(random, 1, maxStepSecs);
+    }
+
+    return points;
+}
+
+/**
+ * @brief toSeries creates a TimeSeries of data points.
+ * @param points: The data points in chronological order
+ * @return The TimeSeries
+ */
+static TimeSeries toSeries(const Points& points)
+{
+    TimeSeries series;
+
+    for (const Point& point : points)
+    {
+        series.append(point.time, point.value);
+    }
+
+    return series;
+}
+
+/**
+ * @brief toPoints copies the data points of a TimeSeries view.
+ * @param view: The view to copy
+ * @return The data points in chronological order
+ */
+static Points toPoints(const TimeSeriesView& view)
+{
+    Points points;
+
+    view.forEachPoint([&points](qint64 time, float value)
+    {
+        points.push_back({ time, value });
+    });
+
+    return points;
+}
+
+/**
+ * @brief toPoints copies the data points of a TimeSeries.
+ * @param series: The TimeSeries to copy
+ * @return The data points in chronological order
+ */
+static Points toPoints(const TimeSeries& series)
+{
+    Points points;
+
+    series.forEachPoint(0, series.size(), [&points](qint64 time, float value)
+    {
+        points.push_back({ time, value });
+    });
+
+    return points;
+}
+
+/**
+ * @brief slicePoints finds the data points taken in the given time range.
+ * @param points: The data points in chronological order
+ * @param startSecs: The start of the time range, inclusive
+ * @param endSecs: The end of the time range, inclusive
+ * @return The data points in the time range
+ */
+static Points slicePoints(const Points& points, qint64 startSecs,
+                          qint64 endSecs)
+{
+    Points slice;
+
+    for (const Point& point : points)
+    {
+        if (point.time >= startSecs && point.time <= endSecs)
+        {
+            slice.push_back(point);
+        }
+    }
+
+    return slice;
+}
+
+/**
+ * @brief replacePoints replaces the data points taken in the given time range
+ * with the data points of others taken in it, like TimeSeries::replaceRange.
+ * @param points: The data points to change
+ * @param startSecs: The start of the time range, inclusive
+ * @param endSecs: The end of the time range, inclusive
+ * @param others: The data points to put in the time range
+ */
+static void replacePoints(Points& points, qint64 startSecs, qint64 endSecs,
+                          const Points& others)
+{
+    Points replaced;
+
+    for (const Point& point : points)
+    {
+        if (point.time < startSecs)
+        {
+            replaced.push_back(point);
+        }
+    }
+
+    for (const Point& point : slicePoints(others, startSecs, endSecs))
+    {
+        replaced.push_back(point);
+    }
+
+    for (const Point& point : points)
+    {
+        if (point.time > endSecs)
+        {
+            replaced.push_back(point);
+        }
+    }
+
+    points.swap(replaced);
+}
+
+/**
+ * @brief energyOfPoints integrates the values of the data points taken in the
+ * given time range over time one pair of consecutive data points at a time.
+ * @param points: The data points in chronological order
+ * @param startSecs: The start of the time range, inclusive
+ * @param endSecs: The end of the time range, inclusive
+ * @return The integral in value times hours
+ */
+static double energyOfPoints(const Points& points, qint64 startSecs,
+                             qint64 endSecs)
+{
+    Points slice = slicePoints(points, startSecs, endSecs);
+    double energy = 0;
+
+    for (std::size_t i = 1; i < slice.size(); i++)
+    {
+        energy += (double(slice[i - 1].value) + slice[i].value) / 2
+                  * (slice[i].time - slice[i - 1].time) / 3600;
+    }
+
+    return energy;
+}
+
+/**
+ * @brief summarizePoints summarizes the data points taken in the given time
+ * range one by one.
+ * @param points: The data points in chronological order
+ * @param startSecs: The start of the time range, inclusive
+ * @param endSecs: The end of the time range, inclusive
+ * @return The summary, with the first smallest and largest data point
+ */
+static Rollup summarizePoints(const Points& points, qint64 startSecs,
+                              qint64 endSecs)
+{
+    Rollup summary = Rollup();
+
+    for (const Point& point : slicePoints(points, startSecs, endSecs))
+    {
+        if (summary.count == 0 || point.value < summary.minValue)
+        {
+            summary.minTime = point.time;
+            summary.minValue = point.value;
+        }
+
+        if (summary.count == 0 || point.value > summary.maxValue)
+        {
+            summary.maxTime = point.time;
+            summary.maxValue = point.value;
+        }
+
+        summary.sum += point.value;
+        summary.count++;
+    }
+
+    return summary;
+}
+
+/**
+ * @brief decimatePoints finds the first smallest and largest data point of
+ * every time bucket, like TimeSeriesView::forEachDecimatedPoint.
+ * @param points: The data points in chronological order
+ * @param bucketSecs: The length of a bucket in seconds
+ * @return The smallest and largest data points in chronological order
+ */
+static Points decimatePoints(const Points& points, qint64 bucketSecs)
+{
+    if (bucketSecs <= 1)
+    {
+        return points;
+    }
+
+    Points decimated;
+    std::size_t first = 0;
+
+    while (first < points.size())
+    {
+        // Round down, also for times before the epoch
+        qint64 bucket = points[first].time / bucketSecs
+                        - (points[first].time % bucketSecs < 0 ? 1 : 0);
+        qint64 bucketEnd = bucket * bucketSecs + bucketSecs - 1;
+        Points bucketPoints;
+
+        for (std::size_t i = first;
+             i < points.size() && points[i].time <= bucketEnd; i++)
+        {
+            bucketPoints.push_back(points[i]);
+        }
+
+        Rollup summary = summarizePoints(bucketPoints, points[first].time,
+                                         bucketEnd);
+
+        if (summary.minTime == summary.maxTime)
+        {
+            decimated.push_back({ summary.minTime, summary.minValue });
+        }
+        else if (summary.minTime < summary.maxTime)
+        {
+            decimated.push_back({ summary.minTime, summary.minValue });
+            decimated.push_back({ summary.maxTime, summary.maxValue });
+        }
+        else
+        {
+            decimated.push_back({ summary.maxTime, summary.maxValue });
+            decimated.push_back({ summary.minTime, summary.minValue });
+        }
+
+        first += summary.count;
+    }
+
+    return decimated;
+}
+
+/**
+ * @brief testWindows creates time windows of the given data points to test
+ * with: windows inside a single block of data points, windows spanning
+ * several blocks, empty windows and random windows.
+ * @param random: The random number generator to use
+ * @param points: The data points in chronological order, not empty
+ * @return The windows, some of which have their start after their end
+ */
+static std::vector<TimeInterval> testWindows(std::mt19937& random,
+                                             const Points& points)
+{
+    std::vector<TimeInterval> windows;
+    std::size_t size = points.size();
+    qint64 firstTime = points.front().time;
+    qint64 lastTime = points.back().time;
+
+    for (int i = 0; i < 20; i++)
+    {
+        // Inside a single block, from a data point to another
+        std::size_t block = randomInt(random, 0, (size - 1) / BLOCK_SIZE);
+        std::size_t blockEnd = std::min(size, (block + 1) * BLOCK_SIZE);
+        std::size_t first = randomInt(random, block * BLOCK_SIZE,
+                                      blockEnd - 1);
+        std::size_t last = randomInt(random, first, blockEnd - 1);
+
+        windows.push_back({ points[first].time, points[last].time });
+
+        // Spanning blocks, between data points
+        first = randomInt(random, 0, size - 1);
+        last = std::min(size - 1, first + std::size_t(randomInt(
+                                      random, BLOCK_SIZE, 8 * BLOCK_SIZE)));
+
+        windows.push_back({ points[first].time - randomInt(random, 0, 1),
+                            points[last].time + randomInt(random, 0, 1) });
+
+        // Random, possibly reaching outside the data
+        qint64 startSecs = randomInt(random, firstTime - 100, lastTime + 100);
+
+        windows.push_back({ startSecs, randomInt(random, startSecs,
+                                                 lastTime + 100) });
+    }
+
+    // Empty windows: reversed, between two data points and outside the data
+    for (int i = 0; i < 5; i++)
+    {
+        std::size_t index = randomInt(random, 0, size - 1);
+
+        windows.push_back({ points[index].time + 1, points[index].time });
+
+        if (index + 1 < size
+            && points[index + 1].time - points[index].time >= 2)
+        {
+            windows.push_back({ points[index].time + 1,
+                                points[index + 1].time - 1 });
+        }
+    }
+
+    windows.push_back({ firstTime - 1000, firstTime - 1 });
+    windows.push_back({ lastTime + 1, lastTime + 1000 });
+
+    return windows;
+}
+
+/**
+ * @brief coveredCells marks which unit cells between whole seconds the given
+ * intervals cover.
+ * @param intervals: The intervals
+ * @param cellCount: How many cells there are, starting from 0
+ * @return Whether each cell is covered
+ */
+static std::vector<bool> coveredCells(const std::vector<TimeInterval>& intervals,
+                                      qint64 cellCount)
+{
+    std::vector<bool> cells(cellCount, false);
+
+    for (const TimeInterval& interval : intervals)
+    {
+        for (qint64 cell = interval.first; cell < interval.second; cell++)
+        {
+            cells[cell] = true;
+        }
+    }
+
+    return cells;
+}
+
+/**
+ * @brief chartBucketSecs calculates the bucket length DataConnector decimates
+ * a time interval with, the same way as DataConnector::calcBucketSecs.
+ * @param intervalSecs: The length of the shown time interval
+ * @param resolution: About how many points the series is reduced to
+ * @return The bucket length in seconds
+ */
+static qint64 chartBucketSecs(qint64 intervalSecs, int resolution)
+{
+    qint64 bucketCount = resolution / 2;
+
+    return RollupPyramid::bucketLength((intervalSecs + bucketCount - 1)
+                                       / bucketCount);
+}
+
+/**
+ * @brief The TimestampParsingImporter class gives the tests the timestamp
+ * parsing of XmlDataImporter.
+ */
+class TimestampParsingImporter : public XmlDataImporter
+{
+public:
+    using XmlDataImporter::secsSinceEpochFromApiString;
+};
+
+/**
+ * @brief allocatingSecsSinceEpochFromApiString parses an API timestamp the
+ * way XmlDataImporter did before parsing in place: each component is
+ * gathered into a std::string of its own and a QDateTime is made of them.
+ * Only used as the baseline of the benchmark.
+ * @param dateTimeString: The timestamp, {year}-{month}-{day}T{hours}:
+ * {minutes}:{seconds}Z
+ * @return Seconds since the epoch matching the timestamp
+ */
+static qint64 allocatingSecsSinceEpochFromApiString(
+    const std::string& dateTimeString)
+{
+    const int componentCount = 6;
+
+    std::size_t charIndex = 0;
+    int componentIndex = 0;
+
+    char delimiter = '-';
+    char sectionEndChar = 'T';
+
+    std::string dateTimeComponents[componentCount];
+
+    while (charIndex < dateTimeString.length()
+           && componentIndex < componentCount)
+    {
+        char currentChar = dateTimeString[charIndex];
+
+        if (currentChar == delimiter)
+        {
+            componentIndex++;
+        }
+        else if (currentChar == sectionEndChar)
+        {
+            sectionEndChar = 'Z';
+            delimiter = ':';
+
+            componentIndex++;
+        }
+        else
+        {
+            dateTimeComponents[componentIndex] += currentChar;
+        }
+
+        charIndex++;
+    }
+
+    int dateTimeComponentsInt[componentCount];
+
+    for (int i = 0; i < componentCount; i++)
+    {
+        dateTimeComponentsInt[i] = std::stoi(dateTimeComponents[i]);
+    }
+
+    return QDateTime(QDate(dateTimeComponentsInt[0], dateTimeComponentsInt[1],
+                           dateTimeComponentsInt[2]),
+                     QTime(dateTimeComponentsInt[3], dateTimeComponentsInt[4],
+                           dateTimeComponentsInt[5]),
+                     Qt::UTC).toSecsSinceEpoch();
+}
+
+/**
+ * @brief The TestDataImporting class tests the data structures of
+ * DataImporting.
+ */
+class TestDataImporting : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief timeSeriesMatchesVector changes a TimeSeries randomly and checks
+     * that it always has the same data points as a vector changed the same
+     * way, and that searching, slicing and decimating it give the same
+     * results as going through the vector.
+     */
+    void timeSeriesMatchesVector();
+
+    /**
+     * @brief intervalSetMatchesCells adds and removes random intervals and
+     * checks that the IntervalSet covers the same cells as an array of them.
+     */
+    void intervalSetMatchesCells();
+
+    /**
+     * @brief minMaxTreeMatchesDeque changes a MinMaxTree randomly at both
+     * ends and checks its minimum and maximum against a deque.
+     */
+    void minMaxTreeMatchesDeque();
+
+    /**
+     * @brief windowAggregatesMatchBruteForce extends and changes a series
+     * randomly and checks that WindowAggregates summarize windows of it like
+     * going through the data points does.
+     */
+    void windowAggregatesMatchBruteForce();
+
+    /**
+     * @brief rollupPyramidMatchesBruteForce extends and changes a series
+     * randomly and checks that RollupPyramid summarizes windows of it like
+     * going through the data points does.
+     */
+    void rollupPyramidMatchesBruteForce();
+
+    /**
+     * @brief rollupsMatchRawData checks that after updating only the changed
+     * parts, the hourly, daily and weekly rollups still summarize whole
+     * buckets like the raw data points do, and that decimating with them
+     * gives the same data points as decimating the raw data.
+     */
+    void rollupsMatchRawData();
+
+    /**
+     * @brief decimationMatchesForChartBuckets decimates time intervals of
+     * different lengths with the bucket lengths DataConnector uses for
+     * different chart widths, and checks that decimating with rollups gives
+     * the same data points as decimating a view of the raw data.
+     */
+    void decimationMatchesForChartBuckets();
+
+    /**
+     * @brief apiTimestampsParse_data makes a row for each form of timezone
+     * designator and fractional seconds the APIs may send.
+     */
+    void apiTimestampsParse_data();
+
+    /**
+     * @brief apiTimestampsParse checks that secsSinceEpochFromApiString
+     * parses a timestamp into the right time.
+     */
+    void apiTimestampsParse();
+
+    /**
+     * @brief invalidApiTimestampsThrow_data makes a row for each kind of
+     * malformed timestamp.
+     */
+    void invalidApiTimestampsThrow_data();
+
+    /**
+     * @brief invalidApiTimestampsThrow checks that secsSinceEpochFromApiString
+     * rejects a malformed timestamp.
+     */
+    void invalidApiTimestampsThrow();
+
+    /**
+     * @brief apiTimestampParsingBenchmark_data makes a row for parsing in
+     * place and for the allocating parser it replaced.
+     */
+    void apiTimestampParsingBenchmark_data();
+
+    /**
+     * @brief apiTimestampParsingBenchmark benchmarks parsing a million
+     * timestamps.
+     */
+    void apiTimestampParsingBenchmark();
+
+    /**
+     * @brief yearOfMinutesIteration_data makes a row for TimeSeries and for
+     * a vector of QDateTime data points.
+     */
+    void yearOfMinutesIteration_data();
+
+    /**
+     * @brief yearOfMinutesIteration benchmarks going through a year of
+     * minute data.
+     */
+    void yearOfMinutesIteration();
+
+    /**
+     * @brief yearOfMinutesMemory_data makes a row for TimeSeries and for a
+     * vector of QDateTime data points.
+     */
+    void yearOfMinutesMemory_data();
+
+    /**
+     * @brief yearOfMinutesMemory measures how much memory a year of minute
+     * data takes.
+     */
+    void yearOfMinutesMemory();
+
+private:
+    /**
+     * @brief addLayoutRows makes a row for TimeSeries and for a vector of
+     * QDateTime data points.
+     */
+    void addLayoutRows();
+};
+
+void TestDataImporting::timeSeriesMatchesVector()
+{
+    std::mt19937 random(1);
+    TimeSeries series;
+    Points points;
+
+    for (int round = 0; round < 200; round++)
+    {
+        int operation = randomInt(random, 0, 29);
+        std::size_t count = randomInt(random, 0, 1000);
+
+        if (operation == 0)
+        {
+            series.clear();
+            points.clear();
+        }
+        else if (operation < 10)
+        {
+            // Add to the end one by one or all at once
+            qint64 startSecs = points.empty()
+                               ? START_SECS
+                               : points.back().time + randomInt(random, 1, 60);
+            Points added = randomPoints(random, count, startSecs, 60);
+
+            if (operation < 5)
+            {
+                for (const Point& point : added)
+                {
+                    series.append(point.time, point.value);
+                }
+            }
+            else
+            {
+                series.append(toSeries(added));
+            }
+
+            points.insert(points.end(), added.begin(), added.end());
+        }
+        else if (operation < 15)
+        {
+            // The added data points all come before the first one
+            qint64 startSecs = points.empty()
+                               ? START_SECS
+                               : points.front().time - qint64(count) * 60 - 1;
+            Points added = randomPoints(random, count, startSecs, 60);
+
+            series.prepend(toSeries(added));
+            points.insert(points.begin(), added.begin(), added.end());
+        }
+        else
+        {
+            qint64 firstTime = points.empty() ? START_SECS
+                                              : points.front().time;
+            qint64 lastTime = points.empty() ? START_SECS
+                                             : points.back().time;
+            qint64 startSecs = randomInt(random, firstTime - 1000,
+                                         lastTime + 1000);
+            qint64 endSecs = randomInt(random, startSecs, startSecs + 100000);
+            Points others = randomPoints(random, count,
+                                         startSecs - randomInt(random, 0, 50),
+                                         60);
+
+            series.replaceRange(startSecs, endSecs, toSeries(others));
+            replacePoints(points, startSecs, endSecs, others);
+        }
+
+        QCOMPARE(series.size(), points.size());
+        QCOMPARE(series.empty(), points.empty());
+        QVERIFY(toPoints(series) == points);
+
+        if (points.empty())
+        {
+            QCOMPARE(series.minMaxValues(), std::make_pair(0.0f, 0.0f));
+            continue;
+        }
+
+        Rollup summary = summarizePoints(points, points.front().time,
+                                         points.back().time);
+
+        QCOMPARE(series.minMaxValues(),
+                 std::make_pair(summary.minValue, summary.maxValue));
+
+        for (int query = 0; query < 20; query++)
+        {
+            std::size_t index = randomInt(random, 0, points.size() - 1);
+
+            QCOMPARE(series.timeAt(index), points[index].time);
+            QCOMPARE(series.valueAt(index), points[index].value);
+
+            qint64 time = randomInt(random, points.front().time - 10,
+                                    points.back().time + 10);
+            auto compareTime = [](const Point& point, qint64 time)
+            {
+                return point.time < time;
+            };
+            auto compareTimeAfter = [](qint64 time, const Point& point)
+            {
+                return time < point.time;
+            };
+
+            QCOMPARE(series.lowerBound(time),
+                     std::size_t(std::lower_bound(points.begin(), points.end(),
+                                                  time, compareTime)
+                                 - points.begin()));
+            QCOMPARE(series.upperBound(time),
+                     std::size_t(std::upper_bound(points.begin(), points.end(),
+                                                  time, compareTimeAfter)
+                                 - points.begin()));
+        }
+
+        for (const TimeInterval& window : testWindows(random, points))
+        {
+            Points expected = slicePoints(points, window.first,
+                                          window.second);
+            TimeSeriesView view = series.view(window.first, window.second);
+
+            QVERIFY(toPoints(series.slice(window.first, window.second))
+                    == expected);
+            QCOMPARE(view.size(), expected.size());
+            QVERIFY(toPoints(view) == expected);
+
+            qint64 bucketSecs = randomInt(random, 0, 2) == 0
+                                ? 1 : randomInt(random, 2, 7200);
+            Points decimated;
+
+            view.forEachDecimatedPoint(bucketSecs,
+                [&decimated](qint64 time, float value)
+            {
+                decimated.push_back({ time, value });
+            });
+
+            QVERIFY(decimated == decimatePoints(expected, bucketSecs));
+        }
+    }
+}
+
+void TestDataImporting::intervalSetMatchesCells()
+{
+    const qint64 cellCount = 64;
+
+    std::mt19937 random(2);
+    IntervalSet intervalSet;
+    std::vector<bool> cells(cellCount, false);
+
+    for (int round = 0; round < 2000; round++)
+    {
+        qint64 startSecs = randomInt(random, 0, cellCount - 1);
+        qint64 endSecs = randomInt(random, startSecs + 1,
+                                   std::min(cellCount, startSecs + 16));
+
+        if (randomInt(random, 0, 99) == 0)
+        {
+            intervalSet.clear();
+            cells.assign(cellCount, false);
+        }
+        else if (randomInt(random, 0, 1) == 0)
+        {
+            intervalSet.add(startSecs, endSecs);
+            std::fill(cells.begin() + startSecs, cells.begin() + endSecs,
+                      true);
+        }
+        else
+        {
+            // The ends of the removed interval stay covered, which doesn't
+            // change the cells
+            intervalSet.remove(startSecs, endSecs);
+            std::fill(cells.begin() + startSecs, cells.begin() + endSecs,
+                      false);
+        }
+
+        // The intervals are disjoint, don't touch and aren't empty
+        std::vector<TimeInterval> intervals = intervalSet.intervals();
+
+        for (std::size_t i = 0; i < intervals.size(); i++)
+        {
+            QVERIFY(intervals[i].first < intervals[i].second);
+            QVERIFY(i == 0 || intervals[i - 1].second < intervals[i].first);
+        }
+
+        QCOMPARE(intervalSet.empty(), intervals.empty());
+        QVERIFY(coveredCells(intervals, cellCount) == cells);
+
+        for (int query = 0; query < 10; query++)
+        {
+            qint64 queryStart = randomInt(random, 0, cellCount - 1);
+            qint64 queryEnd = randomInt(random, queryStart + 1, cellCount);
+
+            std::vector<bool> expectedCovered(cellCount, false);
+            std::vector<bool> expectedGaps(cellCount, false);
+            bool expectedCovers = true;
+
+            for (qint64 cell = queryStart; cell < queryEnd; cell++)
+            {
+                expectedCovered[cell] = cells[cell];
+                expectedGaps[cell] = !cells[cell];
+                expectedCovers = expectedCovers && cells[cell];
+            }
+
+            std::vector<TimeInterval> covered =
+                intervalSet.covered(queryStart, queryEnd);
+            std::vector<TimeInterval> gaps =
+                intervalSet.gaps(queryStart, queryEnd);
+
+            QCOMPARE(intervalSet.covers(queryStart, queryEnd),
+                     expectedCovers);
+            QVERIFY(coveredCells(covered, cellCount) == expectedCovered);
+            QVERIFY(coveredCells(gaps, cellCount) == expectedGaps);
+
+            for (const TimeInterval& part : covered)
+            {
+                QVERIFY(part.first < part.second);
+            }
+
+            for (const TimeInterval& gap : gaps)
+            {
+                QVERIFY(gap.first < gap.second);
+            }
+
+            // Empty query intervals have no parts
+            QVERIFY(intervalSet.covered(queryStart, queryStart).empty());
+            QVERIFY(intervalSet.gaps(queryEnd, queryStart).empty());
+        }
+    }
+}
+
+void TestDataImporting::minMaxTreeMatchesDeque()
+{
+    std::mt19937 random(3);
+    MinMaxTree tree;
+    std::deque<float> values;
+
+    for (int round = 0; round < 3000; round++)
+    {
+        int operation = randomInt(random, 0, 19);
+        int count = randomInt(random, 0, operation == 0 ? 300 : 100);
+        std::vector<float> added;
+
+        for (int i = 0; i < count; i++)
+        {
+            added.push_back(randomInt(random, -1000, 1000));
+        }
+
+        if (operation == 0)
+        {
+            tree.assign(added);
+            values.assign(added.begin(), added.end());
+        }
+        else if (operation < 6)
+        {
+            tree.append(added);
+            values.insert(values.end(), added.begin(), added.end());
+        }
+        else if (operation < 11)
+        {
+            tree.prepend(added);
+            values.insert(values.begin(), added.begin(), added.end());
+        }
+        else
+        {
+            // Sometimes remove more values than there are
+            int removed = randomInt(random, 0, values.size() + 5);
+            int removable = std::min<int>(removed, values.size());
+
+            if (operation < 16)
+            {
+                tree.removeFirst(removed);
+                values.erase(values.begin(), values.begin() + removable);
+            }
+            else
+            {
+                tree.removeLast(removed);
+                values.erase(values.end() - removable, values.end());
+            }
+        }
+
+        QCOMPARE(tree.size(), int(values.size()));
+
+        if (values.empty())
+        {
+            QCOMPARE(tree.minMaxValues(),
+                     std::make_pair(std::numeric_limits<float>::infinity(),
+                                    -std::numeric_limits<float>::infinity()));
+        }
+        else
+        {
+            QCOMPARE(tree.minMaxValues(),
+                     std::make_pair(*std::min_element(values.begin(),
+                                                      values.end()),
+                                    *std::max_element(values.begin(),
+                                                      values.end())));
+        }
+    }
+}
+
+void TestDataImporting::windowAggregatesMatchBruteForce()
+{
+    std::mt19937 random(4);
+    TimeSeries series;
+    Points points;
+    WindowAggregates aggregates;
+
+    for (int round = 0; round < 60; round++)
+    {
+        qint64 changedSecs = 0;
+
+        if (points.empty() || randomInt(random, 0, 2) > 0)
+        {
+            // Extend the series, mostly by less than a block
+            std::size_t count = randomInt(random, 1, randomInt(random, 0, 3)
+                                          == 0 ? 1000 : BLOCK_SIZE);
+            qint64 startSecs = points.empty()
+                               ? START_SECS
+                               : points.back().time + randomInt(random, 1, 600);
+            Points added = randomPoints(random, count, startSecs, 600);
+
+            for (const Point& point : added)
+            {
+                series.append(point.time, point.value);
+            }
+
+            points.insert(points.end(), added.begin(), added.end());
+            changedSecs = startSecs;
+        }
+        else
+        {
+            // Replace a part in the middle, which may change the number of
+            // data points after it
+            qint64 startSecs = randomInt(random, points.front().time,
+                                         points.back().time);
+            qint64 endSecs = randomInt(random, startSecs, startSecs + 50000);
+            Points others = randomPoints(random, randomInt(random, 0, 200),
+                                         startSecs, 600);
+
+            series.replaceRange(startSecs, endSecs, toSeries(others));
+            replacePoints(points, startSecs, endSecs, others);
+            changedSecs = startSecs;
+        }
+
+        aggregates.update(series, changedSecs);
+
+        if (points.empty())
+        {
+            continue;
+        }
+
+        for (const TimeInterval& window : testWindows(random, points))
+        {
+            WindowSummary summary = aggregates.summarize(series, window.first,
+                                                         window.second);
+            Rollup expected = summarizePoints(points, window.first,
+                                              window.second);
+
+            QCOMPARE(summary.count, expected.count);
+
+            if (expected.count == 0)
+            {
+                continue;
+            }
+
+            QCOMPARE(summary.sum, expected.sum);
+            QCOMPARE(summary.mean(), expected.sum / expected.count);
+            QCOMPARE(summary.minValue, expected.minValue);
+            QCOMPARE(summary.maxValue, expected.maxValue);
+
+            // The energies are summed in another order, so they can differ
+            // by rounding
+            double expectedEnergy = energyOfPoints(points, window.first,
+                                                   window.second);
+            QVERIFY(std::abs(summary.energy - expectedEnergy)
+                    <= 1e-9 * std::max(1.0, std::abs(expectedEnergy)));
+        }
+    }
+
+    // Clearing starts over
+    aggregates.clear();
+    series.clear();
+    QCOMPARE(aggregates.summarize(series, START_SECS, START_SECS + 1).count,
+             qint64(0));
+}
+
+void TestDataImporting::rollupPyramidMatchesBruteForce()
+{
+    std::mt19937 random(5);
+    TimeSeries series;
+    Points points;
+    RollupPyramid rollups;
+
+    for (int round = 0; round < 40; round++)
+    {
+        qint64 startSecs = 0;
+        qint64 endSecs = 0;
+
+        if (points.empty() || randomInt(random, 0, 1) == 0)
+        {
+            // Extend the series by up to a few days
+            qint64 firstSecs = points.empty()
+                               ? START_SECS
+                               : points.back().time + randomInt(random, 1, 900);
+            Points added = randomPoints(random, randomInt(random, 1, 500),
+                                        firstSecs, 900);
+
+            for (const Point& point : added)
+            {
+                series.append(point.time, point.value);
+            }
+
+            points.insert(points.end(), added.begin(), added.end());
+            startSecs = added.front().time;
+            endSecs = added.back().time;
+        }
+        else
+        {
+            startSecs = randomInt(random, points.front().time,
+                                  points.back().time);
+            endSecs = randomInt(random, startSecs, startSecs + 200000);
+            Points others = randomPoints(random, randomInt(random, 0, 200),
+                                         startSecs, 900);
+
+            series.replaceRange(startSecs, endSecs, toSeries(others));
+            replacePoints(points, startSecs, endSecs, others);
+        }
+
+        rollups.update(series, startSecs, endSecs);
+
+        if (points.empty())
+        {
+            continue;
+        }
+
+        std::vector<TimeInterval> windows = testWindows(random, points);
+
+        // Windows long enough to use daily and weekly rollups
+        for (int i = 0; i < 10; i++)
+        {
+            qint64 windowStart = randomInt(random, points.front().time,
+                                           points.back().time);
+
+            windows.push_back({ windowStart, windowStart
+                                + randomInt(random, 0, 4 * 7 * 24 * 60 * 60) });
+        }
+
+        for (const TimeInterval& window : windows)
+        {
+            Rollup summary = rollups.summarize(series, window.first,
+                                               window.second);
+            Rollup expected = summarizePoints(points, window.first,
+                                              window.second);
+
+            QCOMPARE(summary.count, expected.count);
+
+            if (expected.count == 0)
+            {
+                continue;
+            }
+
+            QCOMPARE(summary.sum, expected.sum);
+            QCOMPARE(summary.minValue, expected.minValue);
+            QCOMPARE(summary.minTime, expected.minTime);
+            QCOMPARE(summary.maxValue, expected.maxValue);
+            QCOMPARE(summary.maxTime, expected.maxTime);
+        }
+    }
+}
+
+void TestDataImporting::rollupsMatchRawData()
+{
+    const qint64 hourSecs = 60 * 60;
+    const qint64 weekSecs = 7 * 24 * hourSecs;
+    const qint64 levelSecs[] = { hourSecs, 24 * hourSecs, weekSecs };
+
+    std::mt19937 random(6);
+
+    // About ten weeks of data with varying gaps
+    Points points = randomPoints(random, 20000, START_SECS, 600);
+    TimeSeries series = toSeries(points);
+    RollupPyramid rollups;
+
+    rollups.update(series, points.front().time, points.back().time);
+
+    for (int round = 0; round < 20; round++)
+    {
+        // Change a part of the series, sometimes across a week boundary,
+        // and update only the rollups overlapping it
+        qint64 startSecs = randomInt(random, points.front().time,
+                                     points.back().time);
+        qint64 endSecs = startSecs + randomInt(random, 0, 2 * weekSecs);
+        Points others = randomPoints(random, randomInt(random, 0, 3000),
+                                     startSecs, 600);
+
+        series.replaceRange(startSecs, endSecs, toSeries(others));
+        replacePoints(points, startSecs, endSecs, others);
+        rollups.update(series, startSecs, endSecs);
+
+        qint64 firstTime = points.front().time;
+        qint64 lastTime = points.back().time;
+
+        // Whole buckets of every level, which are read from the rollups
+        for (qint64 bucketSecs : levelSecs)
+        {
+            for (int i = 0; i < 10; i++)
+            {
+                qint64 bucket = randomInt(random, firstTime / bucketSecs,
+                                          lastTime / bucketSecs);
+                qint64 bucketStart = bucket * bucketSecs;
+                qint64 bucketEnd = bucketStart + randomInt(random, 1, 3)
+                                   * bucketSecs - 1;
+
+                Rollup summary = rollups.summarize(series, bucketStart,
+                                                   bucketEnd);
+                Rollup expected = summarizePoints(points, bucketStart,
+                                                  bucketEnd);
+
+                QCOMPARE(summary.count, expected.count);
+                QCOMPARE(summary.mean(), expected.mean());
+
+                if (expected.count > 0)
+                {
+                    QCOMPARE(summary.sum, expected.sum);
+                    QCOMPARE(summary.minValue, expected.minValue);
+                    QCOMPARE(summary.minTime, expected.minTime);
+                    QCOMPARE(summary.maxValue, expected.maxValue);
+                    QCOMPARE(summary.maxTime, expected.maxTime);
+                }
+            }
+        }
+
+        // Decimating a random range with rollups gives the same data points
+        // as decimating the raw data points
+        for (int i = 0; i < 10; i++)
+        {
+            qint64 windowStart = randomInt(random, firstTime - hourSecs,
+                                           lastTime);
+            qint64 windowEnd = windowStart + randomInt(random, 0,
+                                                       4 * weekSecs);
+            qint64 bucketSecs = RollupPyramid::bucketLength(
+                randomInt(random, 1, 2 * weekSecs));
+
+            Points decimated;
+            rollups.forEachDecimatedPoint(series, windowStart, windowEnd,
+                                          bucketSecs,
+                [&decimated](qint64 time, float value)
+            {
+                decimated.push_back({ time, value });
+            });
+
+            Points rawDecimated;
+            series.view(windowStart, windowEnd).forEachDecimatedPoint(
+                bucketSecs, [&rawDecimated](qint64 time, float value)
+            {
+                rawDecimated.push_back({ time, value });
+            });
+
+            QVERIFY(decimated == rawDecimated);
+            QVERIFY(decimated == decimatePoints(
+                        slicePoints(points, windowStart, windowEnd),
+                        bucketSecs));
+        }
+    }
+
+    // Clearing removes every rollup
+    rollups.clear();
+    series.clear();
+    QCOMPARE(rollups.summarize(series, START_SECS, START_SECS + weekSecs)
+             .count, qint64(0));
+}
+
+void TestDataImporting::decimationMatchesForChartBuckets()
+{
+    const qint64 hourSecs = 60 * 60;
+    const qint64 daySecs = 24 * hourSecs;
+    const qint64 intervalLengths[] = { hourSecs, 6 * hourSecs, daySecs,
+                                       3 * daySecs, 7 * daySecs,
+                                       30 * daySecs, 90 * daySecs,
+                                       365 * daySecs };
+    const int resolutions[] = { 2, 100, 1000, 1920, 4000 };
+
+    std::mt19937 random(7);
+
+    // Close to a year of data with varying gaps
+    Points points = randomPoints(random, 60000, START_SECS, 1000);
+    TimeSeries series = toSeries(points);
+    RollupPyramid rollups;
+
+    rollups.update(series, points.front().time, points.back().time);
+
+    for (qint64 intervalSecs : intervalLengths)
+    {
+        for (int resolution : resolutions)
+        {
+            qint64 bucketSecs = chartBucketSecs(intervalSecs, resolution);
+
+            for (int i = 0; i < 5; i++)
+            {
+                qint64 windowStart = randomInt(random,
+                                               points.front().time - daySecs,
+                                               points.back().time);
+                qint64 windowEnd = windowStart + intervalSecs;
+
+                Points decimated;
+                rollups.forEachDecimatedPoint(series, windowStart, windowEnd,
+                                              bucketSecs,
+                    [&decimated](qint64 time, float value)
+                {
+                    decimated.push_back({ time, value });
+                });
+
+                Points viewDecimated;
+                series.view(windowStart, windowEnd).forEachDecimatedPoint(
+                    bucketSecs, [&viewDecimated](qint64 time, float value)
+                {
+                    viewDecimated.push_back({ time, value });
+                });
+
+                QVERIFY(decimated == viewDecimated);
+                QVERIFY(decimated == decimatePoints(
+                            slicePoints(points, windowStart, windowEnd),
+                            bucketSecs));
+            }
+        }
+    }
+}
+
+void TestDataImporting::apiTimestampsParse_data()
+{
+    QTest::addColumn<QString>("timestamp");
+    QTest::addColumn<qint64>("expectedSecs");
+
+    // 2020-09-14T00:00:00Z
+    const qint64 midnightSecs = 1600041600;
+    const qint64 hourSecs = 60 * 60;
+
+    QTest::newRow("Z") << "2020-09-14T00:00:00Z" << midnightSecs;
+    QTest::newRow("no designator") << "2020-09-14T00:00:00" << midnightSecs;
+    QTest::newRow("+hh:mm") << "2020-09-14T03:30:00+03:30" << midnightSecs;
+    QTest::newRow("-hh:mm") << "2020-09-13T20:30:00-03:30" << midnightSecs;
+    QTest::newRow("+hhmm") << "2020-09-14T02:45:00+0245" << midnightSecs;
+    QTest::newRow("-hhmm") << "2020-09-13T21:15:00-0245" << midnightSecs;
+    QTest::newRow("+hh") << "2020-09-14T02:00:00+02" << midnightSecs;
+    QTest::newRow("-hh") << "2020-09-13T22:00:00-02" << midnightSecs;
+    QTest::newRow("+00:00") << "2020-09-14T00:00:00+00:00" << midnightSecs;
+    QTest::newRow("fraction") << "2020-09-14T00:00:05.999Z"
+                              << midnightSecs + 5;
+    QTest::newRow("fraction without designator") << "2020-09-14T00:00:05.5"
+                                                 << midnightSecs + 5;
+    QTest::newRow("fraction and offset") << "2020-09-14T03:00:05.123456+03:00"
+                                         << midnightSecs + 5;
+    QTest::newRow("leap day") << "2020-02-29T12:00:00Z"
+                              << midnightSecs - 198 * 24 * hourSecs
+                                 + 12 * hourSecs;
+    QTest::newRow("epoch") << "1970-01-01T00:00:00Z" << qint64(0);
+    QTest::newRow("before epoch") << "1969-12-31T23:59:59Z" << qint64(-1);
+}
+
+void TestDataImporting::apiTimestampsParse()
+{
+    QFETCH(QString, timestamp);
+    QFETCH(qint64, expectedSecs);
+
+    QCOMPARE(TimestampParsingImporter::secsSinceEpochFromApiString(timestamp),
+             expectedSecs);
+}
+
+void TestDataImporting::invalidApiTimestampsThrow_data()
+{
+    QTest::addColumn<QString>("timestamp");
+
+    QTest::newRow("empty") << "";
+    QTest::newRow("too short") << "2020-09-14T00:00";
+    QTest::newRow("wrong separator") << "2020-09-14 00:00:00Z";
+    QTest::newRow("letter in year") << "20x0-09-14T00:00:00Z";
+    QTest::newRow("month 13") << "2020-13-14T00:00:00Z";
+    QTest::newRow("hour 24") << "2020-09-14T24:00:00Z";
+    QTest::newRow("offset cut short") << "2020-09-14T00:00:00+0";
+    QTest::newRow("trailing text") << "2020-09-14T00:00:00Zabc";
+}
+
+void TestDataImporting::invalidApiTimestampsThrow()
+{
+    QFETCH(QString, timestamp);
+
+    QVERIFY_EXCEPTION_THROWN(
+        TimestampParsingImporter::secsSinceEpochFromApiString(timestamp),
+        std::invalid_argument);
+}
+
+void TestDataImporting::apiTimestampParsingBenchmark_data()
+{
+    QTest::addColumn<bool>("inPlace");
+
+    QTest::newRow("allocating") << false;
+    QTest::newRow("in place") << true;
+}
+
+void TestDataImporting::apiTimestampParsingBenchmark()
+{
+    QFETCH(bool, inPlace);
+
+    // A timestamp every minute like in the replies, made before measuring
+    std::vector<QString> timestamps;
+    std::vector<std::string> stdTimestamps;
+    timestamps.reserve(TIMESTAMP_COUNT);
+    stdTimestamps.reserve(TIMESTAMP_COUNT);
+
+    for (int i = 0; i < TIMESTAMP_COUNT; i++)
+    {
+        timestamps.push_back(QDateTime::fromSecsSinceEpoch(
+            START_SECS + i * 60, Qt::UTC).toString(Qt::ISODate));
+        stdTimestamps.push_back(timestamps.back().toStdString());
+    }
+
+    qint64 secsSum = 0;
+
+    QBENCHMARK
+    {
+        secsSum = 0;
+
+        for (int i = 0; i < TIMESTAMP_COUNT; i++)
+        {
+            secsSum += inPlace
+                ? TimestampParsingImporter::secsSinceEpochFromApiString(
+                      timestamps[i])
+                : allocatingSecsSinceEpochFromApiString(stdTimestamps[i]);
+        }
+    }
+
+    // Both parse every timestamp the same
+    qint64 expectedSum = qint64(TIMESTAMP_COUNT) * START_SECS
+                         + qint64(TIMESTAMP_COUNT) * (TIMESTAMP_COUNT - 1)
+                           / 2 * 60;
+    QCOMPARE(secsSum, expectedSum);
+}
+
+void TestDataImporting::yearOfMinutesIteration_data()
+{
+    addLayoutRows();
+}
+
+void TestDataImporting::yearOfMinutesIteration()
+{
+    QFETCH(bool, columnar);
+
+    TimeSeries series;
+    std::vector<DateTimePoint> points;
+
+    for (qint64 i = 0; i < MINUTES_PER_YEAR; i++)
+    {
+        qint64 time = START_SECS + i * 60;
+        float value = float(i % 50);
+
+        if (columnar)
+        {
+            series.append(time, value);
+        }
+        else
+        {
+            points.push_back({ QDateTime::fromSecsSinceEpoch(time, Qt::UTC),
+                               value });
+        }
+    }
+
+    qint64 timeSum = 0;
+    double valueSum = 0;
+
+    QBENCHMARK
+    {
+        timeSum = 0;
+        valueSum = 0;
+
+        if (columnar)
+        {
+            series.view(START_SECS, START_SECS + MINUTES_PER_YEAR * 60)
+                .forEachPoint([&](qint64 time, float value)
+            {
+                timeSum += time;
+                valueSum += value;
+            });
+        }
+        else
+        {
+            for (const DateTimePoint& point : points)
+            {
+                timeSum += point.time.toSecsSinceEpoch();
+                valueSum += point.value;
+            }
+        }
+    }
+
+    QCOMPARE(timeSum, MINUTES_PER_YEAR * START_SECS
+                      + MINUTES_PER_YEAR * (MINUTES_PER_YEAR - 1) / 2 * 60);
+}
+
+void TestDataImporting::yearOfMinutesMemory_data()
+{
+    addLayoutRows();
+}
+
+void TestDataImporting::yearOfMinutesMemory()
+{
+    QFETCH(bool, columnar);
+
+    qint64 bytesBefore = liveAllocatedBytes();
+
+    TimeSeries series;
+    std::vector<DateTimePoint> points;
+
+    for (qint64 i = 0; i < MINUTES_PER_YEAR; i++)
+    {
+        qint64 time = START_SECS + i * 60;
+        float value = float(i % 50);
+
+        if (columnar)
+        {
+            series.append(time, value);
+        }
+        else
+        {
+            points.push_back({ QDateTime::fromSecsSinceEpoch(time, Qt::UTC),
+                               value });
+        }
+    }
+
+    qint64 bytes = liveAllocatedBytes() - bytesBefore;
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+
+    // A time and a value take 12 bytes, the rest is bookkeeping
+    if (columnar)
+    {
+        QCOMPARE(series.size(), std::size_t(MINUTES_PER_YEAR));
+        QVERIFY(bytes < MINUTES_PER_YEAR * 13);
+    }
+}
+
+void TestDataImporting::addLayoutRows()
+{
+    QTest::addColumn<bool>("columnar");
+
+    QTest::newRow("QDateTime points") << false;
+    QTest::newRow("TimeSeries") << true;
+}
+
+QTEST_APPLESS_MAIN(TestDataImporting)
+
+#include "tst_dataimporting.moc"
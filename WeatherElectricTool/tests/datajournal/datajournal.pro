@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+TARGET = tst_datajournal
+
+SOURCES += \
+    tst_datajournal.cpp \
+    $$MAIN_DIR/DataImporting/datajournal.cpp \
+    $$MAIN_DIR/DataImporting/dataimporter.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/intervalset.cpp
+
+HEADERS += \
+    $$MAIN_DIR/DataImporting/datajournal.hh \
+    $$MAIN_DIR/DataImporting/dataimporter.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh \
+    $$MAIN_DIR/DataImporting/intervalset.hh
@@ -0,0 +1,319 @@
+/**
+  * @file tst_datajournal.cpp tests that DataJournal gives back what was
+  * appended to it, also after a torn write and after compaction.
+  * @date 16.10.2026
+  */
+
+#include "DataImporting/datajournal.hh"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <limits>
+#include <memory>
+
+using namespace DataImporting;
+
+// The data is from 2020, so it has settled long ago
+static const qint64 START_SECS = 1600000000;
+
+// Stores the time between the data points of the segments
+static const qint64 POINT_STEP_SECS = 60;
+
+// Stores how many records a journal can have before it's compacted
+static const int COMPACTION_RECORD_COUNT = 256;
+
+// Stores the whole time range for replaying every record
+static const qint64 MIN_SECS = std::numeric_limits<qint64>::min();
+static const qint64 MAX_SECS = std::numeric_limits<qint64>::max();
+
+/**
+ * @brief makeSegment creates the data of a segment with a data point every
+ * POINT_STEP_SECS seconds.
+ * @param startSecs: The time of the first data point
+ * @param endSecs: The time after which there are no data points
+ * @param valueOffset: Added to each value so that segments can be told apart
+ * @return The data of the segment
+ */
+static TimeSeries makeSegment(qint64 startSecs, qint64 endSecs,
+                              float valueOffset)
+{
+    TimeSeries data;
+
+    for (qint64 time = startSecs; time <= endSecs; time += POINT_STEP_SECS)
+    {
+        data.append(time, float(time / POINT_STEP_SECS % 100) + valueOffset);
+    }
+
+    return data;
+}
+
+/**
+ * @brief sameData checks whether two TimeSeries have the same data points.
+ * @param first: The first TimeSeries
+ * @param second: The second TimeSeries
+ * @return True if the data points are the same, otherwise false
+ */
+static bool sameData(const TimeSeries& first, const TimeSeries& second)
+{
+    if (first.size() != second.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < first.size(); i++)
+    {
+        if (first.timeAt(i) != second.timeAt(i)
+            || first.valueAt(i) != second.valueAt(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief The TestDataJournal class tests appending to and replaying
+ * journals.
+ */
+class TestDataJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief init gives each test an empty directory for its journals.
+     */
+    void init();
+
+    /**
+     * @brief appendedSegmentsAreReplayed appends segments and checks that a
+     * new DataJournal replays all of them.
+     */
+    void appendedSegmentsAreReplayed();
+
+    /**
+     * @brief laterSegmentsReplaceEarlierOnes appends overlapping segments and
+     * checks that the data of the later one is replayed.
+     */
+    void laterSegmentsReplaceEarlierOnes();
+
+    /**
+     * @brief replayKeepsOnlyTimeRange replays part of a journal and checks
+     * that nothing outside of it is kept.
+     */
+    void replayKeepsOnlyTimeRange();
+
+    /**
+     * @brief recentDataIsNotCovered appends data fetched just now and checks
+     * that it's replayed without being counted as covered.
+     */
+    void recentDataIsNotCovered();
+
+    /**
+     * @brief tornTailIsDropped cuts the last record of a journal short like a
+     * crash would and checks that it's dropped and that appending continues
+     * after the valid records.
+     */
+    void tornTailIsDropped();
+
+    /**
+     * @brief compactionKeepsData appends enough records for the journal to
+     * be compacted and checks that the file shrinks and replays the same.
+     */
+    void compactionKeepsData();
+
+private:
+    /**
+     * @brief append appends a segment of temperatures in Tampere.
+     * @param journal: The journal to append to
+     * @param startSecs: The start of the segment
+     * @param endSecs: The end of the segment
+     * @param valueOffset: Added to each value of the segment
+     */
+    void append(DataJournal& journal, qint64 startSecs, qint64 endSecs,
+                float valueOffset = 0);
+
+    /**
+     * @brief journalFilePath returns the path of the only journal file.
+     * @return The path, or an empty string if there isn't exactly one
+     */
+    QString journalFilePath() const;
+
+    // Stores the journals of the current test
+    std::unique_ptr<QTemporaryDir> directory_;
+};
+
+void TestDataJournal::init()
+{
+    directory_.reset(new QTemporaryDir());
+    QVERIFY(directory_->isValid());
+}
+
+void TestDataJournal::appendedSegmentsAreReplayed()
+{
+    {
+        DataJournal journal(directory_->path());
+        append(journal, START_SECS, START_SECS + 3600);
+        append(journal, START_SECS + 3600, START_SECS + 7200);
+        append(journal, START_SECS + 10800, START_SECS + 14400);
+    }
+
+    std::vector<JournalEntry> entries =
+        DataJournal(directory_->path()).replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(entries.size(), std::size_t(1));
+
+    const JournalEntry& entry = entries.front();
+    QCOMPARE(entry.sourceName, std::string("FMI"));
+    QCOMPARE(entry.dataType, Temperature);
+    QCOMPARE(entry.dataLocation, std::string("Tampere"));
+    QCOMPARE(entry.unitOfMeasurement, std::string("C"));
+
+    std::vector<TimeInterval> expectedCoverage =
+        { { START_SECS, START_SECS + 7200 },
+          { START_SECS + 10800, START_SECS + 14400 } };
+    QVERIFY(entry.coverage.intervals() == expectedCoverage);
+
+    TimeSeries expectedData = makeSegment(START_SECS, START_SECS + 7200, 0);
+    expectedData.append(makeSegment(START_SECS + 10800, START_SECS + 14400,
+                                    0));
+    QVERIFY(sameData(entry.data, expectedData));
+
+    std::pair<float, float> minMax = expectedData.minMaxValues();
+    QCOMPARE(entry.maxValue, minMax.second);
+    QCOMPARE(entry.minValue, minMax.first);
+}
+
+void TestDataJournal::laterSegmentsReplaceEarlierOnes()
+{
+    DataJournal journal(directory_->path());
+    append(journal, START_SECS, START_SECS + 7200);
+    append(journal, START_SECS + 1800, START_SECS + 3600, 1000);
+
+    std::vector<JournalEntry> entries = journal.replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(entries.size(), std::size_t(1));
+
+    TimeSeries expectedData = makeSegment(START_SECS, START_SECS + 7200, 0);
+    expectedData.replaceRange(START_SECS + 1800, START_SECS + 3600,
+        makeSegment(START_SECS + 1800, START_SECS + 3600, 1000));
+    QVERIFY(sameData(entries.front().data, expectedData));
+}
+
+void TestDataJournal::replayKeepsOnlyTimeRange()
+{
+    DataJournal journal(directory_->path());
+    append(journal, START_SECS, START_SECS + 7200);
+    append(journal, START_SECS + 86400, START_SECS + 90000);
+
+    std::vector<JournalEntry> entries =
+        journal.replay(START_SECS + 3600, START_SECS + 5400);
+    QCOMPARE(entries.size(), std::size_t(1));
+
+    std::vector<TimeInterval> expectedCoverage =
+        { { START_SECS + 3600, START_SECS + 5400 } };
+    QVERIFY(entries.front().coverage.intervals() == expectedCoverage);
+    QVERIFY(sameData(entries.front().data,
+                     makeSegment(START_SECS + 3600, START_SECS + 5400, 0)));
+
+    // Journals with nothing in the time range aren't replayed
+    QVERIFY(journal.replay(START_SECS - 7200, START_SECS - 3600).empty());
+}
+
+void TestDataJournal::recentDataIsNotCovered()
+{
+    qint64 currentSecs = QDateTime::currentSecsSinceEpoch();
+
+    DataJournal journal(directory_->path());
+    append(journal, currentSecs - 3600, currentSecs);
+
+    std::vector<JournalEntry> entries = journal.replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(entries.size(), std::size_t(1));
+    QVERIFY(entries.front().coverage.empty());
+    QVERIFY(sameData(entries.front().data,
+                     makeSegment(currentSecs - 3600, currentSecs, 0)));
+}
+
+void TestDataJournal::tornTailIsDropped()
+{
+    {
+        DataJournal journal(directory_->path());
+        append(journal, START_SECS, START_SECS + 3600);
+        append(journal, START_SECS + 7200, START_SECS + 10800);
+    }
+
+    // Cut the last record short
+    QString filePath = journalFilePath();
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 10));
+    file.close();
+
+    DataJournal journal(directory_->path());
+    std::vector<JournalEntry> entries = journal.replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(entries.size(), std::size_t(1));
+    QVERIFY(sameData(entries.front().data,
+                     makeSegment(START_SECS, START_SECS + 3600, 0)));
+
+    // New records follow the valid ones instead of the torn one
+    append(journal, START_SECS + 14400, START_SECS + 18000);
+    entries = journal.replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(entries.size(), std::size_t(1));
+
+    std::vector<TimeInterval> expectedCoverage =
+        { { START_SECS, START_SECS + 3600 },
+          { START_SECS + 14400, START_SECS + 18000 } };
+    QVERIFY(entries.front().coverage.intervals() == expectedCoverage);
+}
+
+void TestDataJournal::compactionKeepsData()
+{
+    DataJournal journal(directory_->path());
+
+    // Every record rewrites the same hour, so compacting leaves one
+    for (int i = 0; i < COMPACTION_RECORD_COUNT - 1; i++)
+    {
+        append(journal, START_SECS, START_SECS + 3600, i);
+    }
+
+    qint64 uncompactedSize = QFileInfo(journalFilePath()).size();
+    std::vector<JournalEntry> uncompacted =
+        journal.replay(MIN_SECS, MAX_SECS);
+
+    append(journal, START_SECS, START_SECS + 3600,
+           COMPACTION_RECORD_COUNT - 1);
+
+    qint64 compactedSize = QFileInfo(journalFilePath()).size();
+    QVERIFY(compactedSize < uncompactedSize / 100);
+
+    std::vector<JournalEntry> compacted =
+        DataJournal(directory_->path()).replay(MIN_SECS, MAX_SECS);
+    QCOMPARE(compacted.size(), std::size_t(1));
+    QVERIFY(compacted.front().coverage.intervals()
+            == uncompacted.front().coverage.intervals());
+    QVERIFY(sameData(compacted.front().data,
+                     makeSegment(START_SECS, START_SECS + 3600,
+                                 COMPACTION_RECORD_COUNT - 1)));
+}
+
+void TestDataJournal::append(DataJournal& journal, qint64 startSecs,
+                             qint64 endSecs, float valueOffset)
+{
+    journal.append("FMI", Temperature, "Tampere", "C", startSecs, endSecs,
+                   makeSegment(startSecs, endSecs, valueOffset));
+}
+
+QString TestDataJournal::journalFilePath() const
+{
+    QStringList fileNames = QDir(directory_->path()).entryList(
+        { "*.journal" }, QDir::Files);
+
+    return fileNames.size() == 1 ? directory_->filePath(fileNames.front())
+                                 : QString();
+}
+
+QTEST_APPLESS_MAIN(TestDataJournal)
+
+#include "tst_datajournal.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = tst_datasegmenter
+
+SOURCES += \
+    tst_datasegmenter.cpp \
+    $$MAIN_DIR/DataImporting/datasegmenter.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp
+
+HEADERS += \
+    $$MAIN_DIR/DataImporting/datasegmenter.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh
@@ -0,0 +1,460 @@
+/**
+  * @file tst_datasegmenter.cpp tests that DataSegmenter passes on the segments
+  * of multi-segment fetches and releases its receptables once they're done.
+  * @date 16.10.2026
+  */
+
+#include "DataImporting/datasegmenter.hh"
+
+#include <QtTest>
+
+#include <algorithm>
+
+using namespace DataImporting;
+
+// The data starts in 2020 so that the times don't fit in a float
+static const qint64 START_SECS = 1600000000;
+
+// Stores how long each segment of a fetch is
+static const qint64 SEGMENT_SECS = 7 * 24 * 60 * 60;
+
+// Stores the data points pushed into each segment
+static const int POINTS_PER_SEGMENT = 100;
+
+// The benchmarked fetch covers a year in 61 segments of six days, with FMI
+// observations every ten minutes
+static const int YEAR_SEGMENT_COUNT = 61;
+static const qint64 YEAR_SEGMENT_SECS = 6 * 24 * 60 * 60;
+static const qint64 OBSERVATION_STEP_SECS = 10 * 60;
+
+/**
+ * @brief The InspectedDataSegmenter class exposes how many receptables and
+ * URLs a DataSegmenter still holds.
+ */
+class InspectedDataSegmenter : public DataSegmenter
+{
+public:
+    /**
+     * @brief receptableCount returns the number of open receptables.
+     * @return The number of open receptables
+     */
+    std::size_t receptableCount() const
+    {
+        return receptables_.size();
+    }
+
+    /**
+     * @brief urlCount returns the number of URLs still waited for.
+     * @return The number of open URLs
+     */
+    std::size_t urlCount() const
+    {
+        return dataSegmentReceptablesPerUrl_.size();
+    }
+};
+
+/**
+ * @brief makeUrls creates the request URLs of a fetch.
+ * @param name: The name of the fetch
+ * @param count: How many segments the fetch has
+ * @return The URLs in chronological order
+ */
+static std::vector<std::string> makeUrls(const std::string& name, int count)
+{
+    std::vector<std::string> urls;
+
+    for (int i = 0; i < count; i++)
+    {
+        urls.push_back("https://example.com/" + name + "?segment="
+                       + std::to_string(i));
+    }
+
+    return urls;
+}
+
+/**
+ * @brief makeTimeFrames creates the time periods of consecutive segments.
+ * @param firstSegment: The index of the first segment counting from
+ * START_SECS
+ * @param count: How many segments to create
+ * @return The time periods in chronological order
+ */
+static std::vector<std::pair<QDateTime, QDateTime>> makeTimeFrames(
+    int firstSegment, int count)
+{
+    std::vector<std::pair<QDateTime, QDateTime>> timeFrames;
+
+    for (int i = firstSegment; i < firstSegment + count; i++)
+    {
+        timeFrames.push_back(
+            { QDateTime::fromSecsSinceEpoch(START_SECS + i * SEGMENT_SECS),
+              QDateTime::fromSecsSinceEpoch(START_SECS + (i + 1) * SEGMENT_SECS
+                                            - 1) });
+    }
+
+    return timeFrames;
+}
+
+/**
+ * @brief pointTime returns the time of a data point of a segment.
+ * @param segment: The index of the segment counting from START_SECS
+ * @param point: The index of the data point in the segment
+ * @return The time in seconds since the epoch
+ */
+static qint64 pointTime(int segment, int point)
+{
+    return START_SECS + segment * SEGMENT_SECS
+           + point * (SEGMENT_SECS / POINTS_PER_SEGMENT);
+}
+
+/**
+ * @brief pointValue returns the value of a data point of a segment. Values
+ * are small integers so that they're exact.
+ * @param segment: The index of the segment counting from START_SECS
+ * @param point: The index of the data point in the segment
+ * @return The value
+ */
+static float pointValue(int segment, int point)
+{
+    return float(segment * 10 + point % 7 - 3);
+}
+
+/**
+ * @brief pushSegment pushes the data points of a segment.
+ * @param segmenter: The DataSegmenter to push into
+ * @param url: The request URL of the segment
+ * @param dataType: The type of the data
+ * @param segment: The index of the segment counting from START_SECS
+ * @param firstPoint: The index of the first data point to push
+ * @param lastPoint: The index after the last data point to push
+ */
+static void pushSegment(DataSegmenter& segmenter, const std::string& url,
+                        ApiDataType dataType, int segment, int firstPoint,
+                        int lastPoint)
+{
+    for (int i = firstPoint; i < lastPoint; i++)
+    {
+        segmenter.pushParsedDataPoint({ pointTime(segment, i),
+                                        pointValue(segment, i) },
+                                      url, dataType);
+    }
+}
+
+/**
+ * @brief The TestDataSegmenter class tests DataSegmenter with fetches run to
+ * completion. Receptables and segments that aren't released or are released
+ * too early show up when the tests are built with CONFIG+=sanitize.
+ */
+class TestDataSegmenter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief segmentsArriveInAnyOrder runs a fetch whose segments arrive out
+     * of order and checks each segment as it's passed on.
+     */
+    void segmentsArriveInAnyOrder();
+
+    /**
+     * @brief receptablesShareUrls runs overlapping fetches of the same data
+     * and checks that every receptable gets all of the shared segments, but
+     * not data of other types.
+     */
+    void receptablesShareUrls();
+
+    /**
+     * @brief discardedAndCancelledSegments discards a segment to receive it
+     * again and cancels another, and checks that the receptable is still
+     * released.
+     */
+    void discardedAndCancelledSegments();
+
+    /**
+     * @brief yearFetchBenchmark runs a fetch of a year of observations split
+     * into 61 segments, from opening its receptable to passing on its last
+     * segment.
+     */
+    void yearFetchBenchmark();
+
+private:
+    /**
+     * @brief compareSegment checks a segment that was passed on.
+     * @param details: The passed segment
+     * @param dataType: The expected type of the data
+     * @param dataLocation: The expected location of the data
+     * @param segment: The index of the segment counting from START_SECS
+     */
+    void compareSegment(const SegmentedDataDetails& details,
+                        ApiDataType dataType, const std::string& dataLocation,
+                        int segment);
+};
+
+void TestDataSegmenter::segmentsArriveInAnyOrder()
+{
+    const int segmentCount = 4;
+    std::vector<std::string> urls = makeUrls("temperature", segmentCount);
+
+    InspectedDataSegmenter segmenter;
+    segmenter.openNewReceptable(Temperature, "Tampere", urls,
+                                makeTimeFrames(0, segmentCount));
+
+    QCOMPARE(segmenter.receptableCount(), std::size_t(1));
+    QCOMPARE(segmenter.urlCount(), std::size_t(segmentCount));
+
+    // The requests answer in parts and in a different order than sent
+    for (int half = 0; half < 2; half++)
+    {
+        for (int segment : { 2, 0, 3, 1 })
+        {
+            pushSegment(segmenter, urls.at(segment), Temperature, segment,
+                        half * POINTS_PER_SEGMENT / 2,
+                        (half + 1) * POINTS_PER_SEGMENT / 2);
+        }
+    }
+
+    // Data of an unknown URL is ignored
+    segmenter.pushParsedDataPoint({ START_SECS, 1 }, "https://example.com/",
+                                  Temperature);
+
+    int receivedCount = 0;
+
+    for (int segment : { 3, 0, 2, 1 })
+    {
+        std::vector<ReceptableProgress> progress =
+            segmenter.getReceptableProgress(urls.at(segment));
+
+        QCOMPARE(progress.size(), std::size_t(1));
+        QCOMPARE(progress.front().dataType, Temperature);
+        QCOMPARE(progress.front().dataLocation, std::string("Tampere"));
+        QCOMPARE(progress.front().receivedSegmentCount, receivedCount + 1);
+        QCOMPARE(progress.front().segmentCount, segmentCount);
+
+        std::vector<SegmentedDataDetails> received =
+            segmenter.getReceivedSegments(urls.at(segment));
+        receivedCount++;
+
+        QCOMPARE(received.size(), std::size_t(1));
+        compareSegment(received.front(), Temperature, "Tampere", segment);
+
+        // A closed URL isn't waited for anymore
+        QVERIFY(segmenter.getReceptableProgress(urls.at(segment)).empty());
+        QVERIFY(segmenter.getReceivedSegments(urls.at(segment)).empty());
+    }
+
+    QCOMPARE(segmenter.receptableCount(), std::size_t(0));
+    QCOMPARE(segmenter.urlCount(), std::size_t(0));
+}
+
+void TestDataSegmenter::receptablesShareUrls()
+{
+    std::vector<std::string> urls = makeUrls("temperature", 4);
+    std::vector<SegmentedDataDetails> passed;
+
+    {
+        InspectedDataSegmenter segmenter;
+
+        // The first fetch covers segments 0 to 2 and has received half of
+        // segment 1 when the second fetch asks for segments 1 to 3
+        segmenter.openNewReceptable(
+            Temperature, "Tampere",
+            { urls.at(0), urls.at(1), urls.at(2) }, makeTimeFrames(0, 3));
+        pushSegment(segmenter, urls.at(1), Temperature, 1, 0,
+                    POINTS_PER_SEGMENT / 2);
+
+        segmenter.openNewReceptable(
+            Temperature, "Tampere",
+            { urls.at(1), urls.at(2), urls.at(3) }, makeTimeFrames(1, 3));
+
+        // Another type of data waits for the same URL
+        segmenter.openNewReceptable(WindSpeed, "Tampere", { urls.at(1) },
+                                    makeTimeFrames(1, 1));
+
+        QCOMPARE(segmenter.receptableCount(), std::size_t(3));
+        QCOMPARE(segmenter.urlCount(), std::size_t(4));
+
+        pushSegment(segmenter, urls.at(1), Temperature, 1,
+                    POINTS_PER_SEGMENT / 2, POINTS_PER_SEGMENT);
+        for (int segment : { 0, 2, 3 })
+        {
+            pushSegment(segmenter, urls.at(segment), Temperature, segment, 0,
+                        POINTS_PER_SEGMENT);
+        }
+        pushSegment(segmenter, urls.at(1), WindSpeed, 1, 0, 10);
+
+        std::vector<ReceptableProgress> progress =
+            segmenter.getReceptableProgress(urls.at(1));
+        QCOMPARE(progress.size(), std::size_t(3));
+
+        // Segment 1 releases the wind speed receptable, the first fetch is
+        // released by segment 0 and the second by segment 3
+        std::vector<SegmentedDataDetails> received =
+            segmenter.getReceivedSegments(urls.at(1));
+        QCOMPARE(received.size(), std::size_t(3));
+
+        for (const SegmentedDataDetails& details : received)
+        {
+            if (details.dataType == WindSpeed)
+            {
+                QVERIFY(details.data != nullptr);
+                QCOMPARE(details.data->size(), std::size_t(10));
+                continue;
+            }
+
+            compareSegment(details, Temperature, "Tampere", 1);
+            passed.push_back(details);
+        }
+        QCOMPARE(segmenter.receptableCount(), std::size_t(2));
+
+        received = segmenter.getReceivedSegments(urls.at(2));
+        QCOMPARE(received.size(), std::size_t(2));
+        passed.insert(passed.end(), received.begin(), received.end());
+
+        received = segmenter.getReceivedSegments(urls.at(0));
+        QCOMPARE(received.size(), std::size_t(1));
+        passed.insert(passed.end(), received.begin(), received.end());
+        QCOMPARE(segmenter.receptableCount(), std::size_t(1));
+
+        received = segmenter.getReceivedSegments(urls.at(3));
+        QCOMPARE(received.size(), std::size_t(1));
+        passed.insert(passed.end(), received.begin(), received.end());
+
+        QCOMPARE(segmenter.receptableCount(), std::size_t(0));
+        QCOMPARE(segmenter.urlCount(), std::size_t(0));
+    }
+
+    // The passed segments stay valid after the segmenter is gone
+    QCOMPARE(passed.size(), std::size_t(6));
+
+    for (const SegmentedDataDetails& details : passed)
+    {
+        int segment = int((details.startDateTime.toSecsSinceEpoch()
+                           - START_SECS) / SEGMENT_SECS);
+        compareSegment(details, Temperature, "Tampere", segment);
+    }
+}
+
+void TestDataSegmenter::discardedAndCancelledSegments()
+{
+    std::vector<std::string> urls = makeUrls("consumption", 3);
+
+    InspectedDataSegmenter segmenter;
+    segmenter.openNewReceptable(ElectricityConsumption, "Finland", urls,
+                                makeTimeFrames(0, 3));
+
+    // A failed request leaves bad data behind, it's discarded and the
+    // segment is received again
+    pushSegment(segmenter, urls.at(0), ElectricityConsumption, 2, 0,
+                POINTS_PER_SEGMENT);
+    segmenter.discardSegment(urls.at(0));
+    pushSegment(segmenter, urls.at(0), ElectricityConsumption, 0, 0,
+                POINTS_PER_SEGMENT);
+
+    std::vector<SegmentedDataDetails> received =
+        segmenter.getReceivedSegments(urls.at(0));
+    QCOMPARE(received.size(), std::size_t(1));
+    compareSegment(received.front(), ElectricityConsumption, "Finland", 0);
+
+    // Whatever arrived before cancelling isn't passed on
+    pushSegment(segmenter, urls.at(1), ElectricityConsumption, 1, 0,
+                POINTS_PER_SEGMENT / 2);
+    received = segmenter.cancelSegment(urls.at(1));
+    QCOMPARE(received.size(), std::size_t(1));
+    QVERIFY(received.front().data == nullptr);
+    QCOMPARE(received.front().startDateTime.toSecsSinceEpoch(),
+             START_SECS + SEGMENT_SECS);
+
+    // Nothing could be parsed from the last segment
+    received = segmenter.getReceivedSegments(urls.at(2));
+    QCOMPARE(received.size(), std::size_t(1));
+    QVERIFY(received.front().data != nullptr);
+    QVERIFY(received.front().data->empty());
+
+    QCOMPARE(segmenter.receptableCount(), std::size_t(0));
+    QCOMPARE(segmenter.urlCount(), std::size_t(0));
+}
+
+void TestDataSegmenter::yearFetchBenchmark()
+{
+    std::vector<std::string> urls = makeUrls("year", YEAR_SEGMENT_COUNT);
+    std::vector<std::pair<QDateTime, QDateTime>> timeFrames;
+
+    for (int i = 0; i < YEAR_SEGMENT_COUNT; i++)
+    {
+        timeFrames.push_back(
+            { QDateTime::fromSecsSinceEpoch(START_SECS + i * YEAR_SEGMENT_SECS),
+              QDateTime::fromSecsSinceEpoch(START_SECS
+                                            + (i + 1) * YEAR_SEGMENT_SECS
+                                            - 1) });
+    }
+
+    const qint64 pointsPerSegment = YEAR_SEGMENT_SECS / OBSERVATION_STEP_SECS;
+    std::size_t passedPointCount = 0;
+
+    QBENCHMARK
+    {
+        InspectedDataSegmenter segmenter;
+        segmenter.openNewReceptable(Temperature, "Tampere", urls, timeFrames);
+        passedPointCount = 0;
+
+        for (int segment = 0; segment < YEAR_SEGMENT_COUNT; segment++)
+        {
+            qint64 segmentStartSecs = START_SECS + segment * YEAR_SEGMENT_SECS;
+
+            for (qint64 i = 0; i < pointsPerSegment; i++)
+            {
+                segmenter.pushParsedDataPoint(
+                    { segmentStartSecs + i * OBSERVATION_STEP_SECS,
+                      float(i % 50) },
+                    urls.at(segment), Temperature);
+            }
+
+            for (const SegmentedDataDetails& details :
+                 segmenter.getReceivedSegments(urls.at(segment)))
+            {
+                passedPointCount += details.data->size();
+            }
+        }
+
+        QCOMPARE(segmenter.receptableCount(), std::size_t(0));
+    }
+
+    QCOMPARE(passedPointCount,
+             std::size_t(YEAR_SEGMENT_COUNT * pointsPerSegment));
+}
+
+void TestDataSegmenter::compareSegment(const SegmentedDataDetails& details,
+                                       ApiDataType dataType,
+                                       const std::string& dataLocation,
+                                       int segment)
+{
+    QCOMPARE(details.dataType, dataType);
+    QCOMPARE(details.dataLocation, dataLocation);
+    QCOMPARE(details.startDateTime.toSecsSinceEpoch(),
+             START_SECS + segment * SEGMENT_SECS);
+    QCOMPARE(details.endDateTime.toSecsSinceEpoch(),
+             START_SECS + (segment + 1) * SEGMENT_SECS - 1);
+
+    QVERIFY(details.data != nullptr);
+    const TimeSeries& data = *details.data;
+    QCOMPARE(data.size(), std::size_t(POINTS_PER_SEGMENT));
+
+    float minValue = pointValue(segment, 0);
+    float maxValue = minValue;
+
+    for (int i = 0; i < POINTS_PER_SEGMENT; i++)
+    {
+        QCOMPARE(data.timeAt(i), pointTime(segment, i));
+        QVERIFY(data.valueAt(i) == pointValue(segment, i));
+
+        minValue = std::min(minValue, pointValue(segment, i));
+        maxValue = std::max(maxValue, pointValue(segment, i));
+    }
+
+    QVERIFY(details.minValue == minValue);
+    QVERIFY(details.maxValue == maxValue);
+}
+
+QTEST_APPLESS_MAIN(TestDataSegmenter)
+
+#include "tst_datasegmenter.moc"
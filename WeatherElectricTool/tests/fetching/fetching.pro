@@ -0,0 +1,43 @@
+include(../tests.pri)
+
+# The importers fetch from a stub server on the local host
+QT += network xml
+
+TARGET = tst_fetching
+
+SOURCES += \
+    tst_fetching.cpp \
+    $$COMMON_DIR/httpstubserver.cpp \
+    $$COMMON_DIR/fmistub.cpp \
+    $$MAIN_DIR/DataImporting/dataimporter.cpp \
+    $$MAIN_DIR/DataImporting/xmlfetcher.cpp \
+    $$MAIN_DIR/DataImporting/xmldataimporter.cpp \
+    $$MAIN_DIR/DataImporting/fmidataimporter.cpp \
+    $$MAIN_DIR/DataImporting/datasegmenter.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/requestscheduler.cpp \
+    $$MAIN_DIR/DataImporting/intervalset.cpp \
+    $$MAIN_DIR/DataImporting/segmentcache.cpp \
+    $$MAIN_DIR/DataImporting/cachingdataimporter.cpp \
+    $$MAIN_DIR/DataImporting/rolluppyramid.cpp \
+    $$MAIN_DIR/DataImporting/xmlparser.cpp \
+    $$MAIN_DIR/DataImporting/minmaxtree.cpp \
+    $$MAIN_DIR/DataImporting/windowaggregates.cpp
+
+HEADERS += \
+    $$COMMON_DIR/httpstubserver.hh \
+    $$COMMON_DIR/fmistub.hh \
+    $$MAIN_DIR/DataImporting/dataimporter.hh \
+    $$MAIN_DIR/DataImporting/xmlfetcher.hh \
+    $$MAIN_DIR/DataImporting/xmldataimporter.hh \
+    $$MAIN_DIR/DataImporting/fmidataimporter.hh \
+    $$MAIN_DIR/DataImporting/datasegmenter.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh \
+    $$MAIN_DIR/DataImporting/requestscheduler.hh \
+    $$MAIN_DIR/DataImporting/intervalset.hh \
+    $$MAIN_DIR/DataImporting/segmentcache.hh \
+    $$MAIN_DIR/DataImporting/cachingdataimporter.hh \
+    $$MAIN_DIR/DataImporting/rolluppyramid.hh \
+    $$MAIN_DIR/DataImporting/xmlparser.hh \
+    $$MAIN_DIR/DataImporting/minmaxtree.hh \
+    $$MAIN_DIR/DataImporting/windowaggregates.hh
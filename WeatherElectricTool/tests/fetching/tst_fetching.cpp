@@ -0,0 +1,590 @@
+/**
+  * @file tst_fetching.cpp tests how the data importers fetch from the network
+  * by pointing them to a stub server on the local host.
+  * @date 16.10.2026
+  */
+
+#include "DataImporting/cachingdataimporter.hh"
+#include "DataImporting/fmidataimporter.hh"
+#include "DataImporting/requestscheduler.hh"
+#include "fmistub.hh"
+#include "httpstubserver.hh"
+
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtTest>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace DataImporting;
+
+// Times are counted in days from here
+static const qint64 START_SECS = 1600041600;
+static const qint64 DAY_SECS = 24 * 60 * 60;
+
+// The stub server sends a data point every this many seconds
+static const qint64 POINT_STEP_SECS = 60 * 60;
+
+// Stores the seed of the random order replies are sent in, fixed so that a
+// failure can be repeated
+static const unsigned RANDOM_SEED = 4;
+
+// Stores how many requests the importers send to a host at once
+static const int MAX_REQUESTS_IN_FLIGHT = 4;
+
+// Stores how long a failed request waits before its first retry
+static const qint64 FIRST_RETRY_DELAY_MILLISECONDS = 1000;
+
+// Stores how early Qt may fire a coarse timer, in parts of its interval
+static const double TIMER_SLACK = 0.05;
+
+// The recorded large reply has a data point every this many seconds, which
+// makes six days of temperatures about 50 MB of XML
+static const qint64 LARGE_REPLY_STEP_SECS = 2;
+
+// Stores how often the event loop is checked for stalls while parsing
+static const int EVENT_LOOP_TICK_MILLISECONDS = 10;
+
+// Stores the longest the event loop may stall while a reply is parsed
+static const qint64 MAX_EVENT_LOOP_STALL_MILLISECONDS = 200;
+
+/**
+ * @brief day returns the time some days after START_SECS.
+ * @param days: The number of days
+ * @return The time in seconds since the epoch
+ */
+static qint64 day(qint64 days)
+{
+    return START_SECS + days * DAY_SECS;
+}
+
+/**
+ * @brief dateTime converts seconds since the epoch into a QDateTime.
+ * @param secs: The time in seconds since the epoch
+ * @return The QDateTime
+ */
+static QDateTime dateTime(qint64 secs)
+{
+    return QDateTime::fromSecsSinceEpoch(secs);
+}
+
+/**
+ * @brief interiorsOverlap checks whether any two of the given time intervals
+ * share more than an end.
+ * @param intervals: The time intervals
+ * @return True if two of them overlap, otherwise false
+ */
+static bool interiorsOverlap(std::vector<TimeInterval> intervals)
+{
+    std::sort(intervals.begin(), intervals.end());
+
+    for (std::size_t i = 1; i < intervals.size(); i++)
+    {
+        if (intervals.at(i).first < intervals.at(i - 1).second)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief covers checks whether the given time intervals cover a time range
+ * together.
+ * @param intervals: The time intervals
+ * @param startSecs: The start of the time range
+ * @param endSecs: The end of the time range
+ * @return True if the time range is covered, otherwise false
+ */
+static bool covers(const std::vector<TimeInterval>& intervals,
+                   qint64 startSecs, qint64 endSecs)
+{
+    IntervalSet coverage;
+
+    for (const TimeInterval& interval : intervals)
+    {
+        coverage.add(interval.first, interval.second);
+    }
+
+    return coverage.covers(startSecs, endSecs);
+}
+
+/**
+ * @brief The TestFetching class tests the data importers against a stub
+ * server.
+ */
+class TestFetching : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief initTestCase keeps the cache away from the user's data.
+     */
+    void initTestCase();
+
+    /**
+     * @brief init starts every test with an empty cache.
+     */
+    void init();
+
+    /**
+     * @brief completedFetchEmitsOnlyUnsentParts fetches a range around a
+     * cached part, answers the requests in a random order and checks that no
+     * part of the range is emitted twice.
+     */
+    void completedFetchEmitsOnlyUnsentParts();
+
+    /**
+     * @brief schedulerCapsRequestsPerHost schedules more requests than can
+     * be in flight at once and checks that the server never has more open.
+     */
+    void schedulerCapsRequestsPerHost();
+
+    /**
+     * @brief schedulerSendsVisibleRequestsFirst queues requests outside and
+     * inside the visible time range while the host is busy and checks that
+     * the visible ones are sent first.
+     */
+    void schedulerSendsVisibleRequestsFirst();
+
+    /**
+     * @brief schedulerRetriesTransientFailures answers requests with 429 and
+     * 5xx statuses and checks that they are retried with a growing delay,
+     * and that other failures aren't retried.
+     */
+    void schedulerRetriesTransientFailures();
+
+    /**
+     * @brief sameRangeFetchesShareRequest fetches two data types of the same
+     * place and time range with separate calls and checks that they are
+     * fetched with a single request.
+     */
+    void sameRangeFetchesShareRequest();
+
+    /**
+     * @brief sameUrlIsRequestedOnce fetches the same data again while its
+     * request is still in flight and checks that the server gets one request
+     * per unique URL and that every fetch gets the data.
+     */
+    void sameUrlIsRequestedOnce();
+
+    /**
+     * @brief parsingKeepsEventLoopResponsive fetches a recorded reply of
+     * about 50 MB and checks that the event loop doesn't stall while it's
+     * parsed.
+     */
+    void parsingKeepsEventLoopResponsive();
+
+private:
+    /**
+     * @brief recordEmittedIntervals records the time range of every
+     * dataFetched an importer emits.
+     * @param importer: The importer
+     * @param emitted: Where to record the time ranges
+     */
+    void recordEmittedIntervals(DataImporter* importer,
+                                std::vector<TimeInterval>& emitted);
+
+    /**
+     * @brief scheduleRequests schedules a request for each given path.
+     * @param scheduler: The scheduler to schedule the requests with
+     * @param server: The server to send the requests to
+     * @param paths: The paths to request
+     * @param startSecs: The start of the time period of the requested data
+     * @param endSecs: The end of the time period of the requested data
+     */
+    void scheduleRequests(RequestScheduler& scheduler,
+                          const HttpStubServer& server,
+                          const std::vector<std::string>& paths,
+                          qint64 startSecs, qint64 endSecs);
+};
+
+void TestFetching::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestFetching::init()
+{
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+        .removeRecursively();
+}
+
+void TestFetching::completedFetchEmitsOnlyUnsentParts()
+{
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+
+    CachingDataImporter importer(new FmiDataImporter(server.baseUrl()));
+
+    std::vector<TimeInterval> emitted;
+    recordEmittedIntervals(&importer, emitted);
+
+    importer.fetchData(Temperature, dateTime(day(10)), dateTime(day(16)),
+                       "Tampere");
+    QTRY_COMPARE(emitted.size(), std::size_t(1));
+    emitted.clear();
+
+    std::size_t cachedRequestCount = server.requestPaths().size();
+
+    // The parts before and after the cached one are fetched in five
+    // segments, of which four are sent at once
+    server.setHoldReplies(true);
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(30)),
+                       "Tampere");
+
+    std::mt19937 random(RANDOM_SEED);
+
+    for (int unanswered = 5; unanswered > 0; unanswered--)
+    {
+        QTRY_COMPARE(server.heldReplyCount(),
+                     std::min(unanswered, MAX_REQUESTS_IN_FLIGHT));
+        QVERIFY(server.releaseRandomHeldReply(random));
+    }
+
+    QTRY_VERIFY(covers(emitted, day(0), day(30)));
+    QCOMPARE(server.requestPaths().size(), cachedRequestCount + 5);
+
+    // The data of the cached part is emitted once the fetch completes
+    QVERIFY(covers(emitted, day(10), day(16)));
+    QVERIFY(!interiorsOverlap(emitted));
+}
+
+void TestFetching::schedulerCapsRequestsPerHost()
+{
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+    server.setHoldReplies(true);
+
+    RequestScheduler scheduler;
+    std::vector<std::string> finishedUrls;
+    connect(&scheduler, &RequestScheduler::requestFinished, this,
+            [&finishedUrls](const std::string& url)
+    {
+        finishedUrls.push_back(url);
+    });
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 10; i++)
+    {
+        paths.push_back("/wfs?starttime=2020-09-14T00:00:00Z"
+                        "&endtime=2020-09-15T00:00:00Z&request="
+                        + std::to_string(i));
+    }
+    scheduleRequests(scheduler, server, paths, day(0), day(1));
+
+    // Waiting doesn't let more requests through
+    QTRY_COMPARE(server.heldReplyCount(), MAX_REQUESTS_IN_FLIGHT);
+    QTest::qWait(200);
+    QCOMPARE(server.requestPaths().size(), std::size_t(MAX_REQUESTS_IN_FLIGHT));
+
+    // Every answered request makes room for one more
+    for (int unanswered = int(paths.size()); unanswered > 0; unanswered--)
+    {
+        QTRY_COMPARE(server.heldReplyCount(),
+                     std::min(unanswered, MAX_REQUESTS_IN_FLIGHT));
+        QVERIFY(server.releaseFirstHeldReply());
+    }
+
+    QTRY_COMPARE(finishedUrls.size(), paths.size());
+    QCOMPARE(server.requestPaths().size(), paths.size());
+    QCOMPARE(server.maxOpenRequestCount(), MAX_REQUESTS_IN_FLIGHT);
+}
+
+void TestFetching::schedulerSendsVisibleRequestsFirst()
+{
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+    server.setHoldReplies(true);
+
+    RequestScheduler scheduler;
+    scheduler.setVisibleTimeRange(day(10), day(20));
+
+    // Keep the host busy so that the rest have to be queued
+    scheduleRequests(scheduler, server,
+                     { "/busy0", "/busy1", "/busy2", "/busy3" },
+                     day(0), day(1));
+    QTRY_COMPARE(server.heldReplyCount(), MAX_REQUESTS_IN_FLIGHT);
+
+    scheduleRequests(scheduler, server,
+                     { "/hidden0", "/hidden1", "/hidden2", "/hidden3" },
+                     day(0), day(1));
+    scheduleRequests(scheduler, server,
+                     { "/visible0", "/visible1", "/visible2", "/visible3" },
+                     day(12), day(13));
+
+    // Each answered request makes room for a visible one
+    for (int i = 0; i < MAX_REQUESTS_IN_FLIGHT; i++)
+    {
+        QVERIFY(server.releaseFirstHeldReply());
+        QTRY_COMPARE(server.requestPaths().size(),
+                     std::size_t(MAX_REQUESTS_IN_FLIGHT + i + 1));
+        QVERIFY(server.requestPaths().back().startsWith("/visible"));
+    }
+
+    // The hidden ones are sent once the visible ones are done
+    for (int i = 0; i < MAX_REQUESTS_IN_FLIGHT; i++)
+    {
+        QVERIFY(server.releaseFirstHeldReply());
+        QTRY_COMPARE(server.requestPaths().size(),
+                     std::size_t(2 * MAX_REQUESTS_IN_FLIGHT + i + 1));
+        QVERIFY(server.requestPaths().back().startsWith("/hidden"));
+    }
+}
+
+void TestFetching::schedulerRetriesTransientFailures()
+{
+    // Stores how many times each path has been requested
+    std::map<QByteArray, int> attemptCounts;
+
+    HttpStubServer server([&attemptCounts](const QByteArray& path)
+    {
+        int attempt = ++attemptCounts[path];
+
+        if (path == "/unavailable")
+        {
+            return HttpStubReply{ attempt <= 2 ? 503 : 200, "<ok/>" };
+        }
+        else if (path == "/throttled")
+        {
+            return HttpStubReply{ attempt <= 1 ? 429 : 200, "<ok/>" };
+        }
+        else if (path == "/broken")
+        {
+            return HttpStubReply{ 500, "<error/>" };
+        }
+        return HttpStubReply{ 404, "<error/>" };
+    });
+
+    RequestScheduler scheduler;
+    std::vector<std::string> finishedUrls;
+    std::vector<std::string> failedUrls;
+    connect(&scheduler, &RequestScheduler::requestFinished, this,
+            [&finishedUrls](const std::string& url)
+    {
+        finishedUrls.push_back(url);
+    });
+    connect(&scheduler, &RequestScheduler::requestFailed, this,
+            [&failedUrls](const std::string& url)
+    {
+        failedUrls.push_back(url);
+    });
+
+    scheduleRequests(scheduler, server,
+                     { "/unavailable", "/throttled", "/broken", "/missing" },
+                     day(0), day(1));
+
+    // A request that always fails is given up after three retries, which
+    // take 1 + 2 + 4 seconds
+    QTRY_COMPARE_WITH_TIMEOUT(failedUrls.size(), std::size_t(2),
+                              10 * FIRST_RETRY_DELAY_MILLISECONDS);
+    QCOMPARE(finishedUrls.size(), std::size_t(2));
+
+    QCOMPARE(attemptCounts["/unavailable"], 3);
+    QCOMPARE(attemptCounts["/throttled"], 2);
+    QCOMPARE(attemptCounts["/broken"], 4);
+    QCOMPARE(attemptCounts["/missing"], 1);
+
+    // The delay doubles after every failed attempt
+    std::vector<qint64> brokenTimes;
+    for (std::size_t i = 0; i < server.requestPaths().size(); i++)
+    {
+        if (server.requestPaths().at(i) == "/broken")
+        {
+            brokenTimes.push_back(server.requestTimes().at(i));
+        }
+    }
+
+    qint64 expectedDelay = FIRST_RETRY_DELAY_MILLISECONDS;
+    for (std::size_t i = 1; i < brokenTimes.size(); i++)
+    {
+        QVERIFY(brokenTimes.at(i) - brokenTimes.at(i - 1)
+                >= expectedDelay * (1 - TIMER_SLACK));
+        expectedDelay *= 2;
+    }
+}
+
+void TestFetching::sameRangeFetchesShareRequest()
+{
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+
+    CachingDataImporter importer(new FmiDataImporter(server.baseUrl()));
+
+    std::vector<ApiDataType> fetchedTypes;
+    connect(&importer, &DataImporter::dataFetched, this,
+            [&fetchedTypes](DataFetchDetails fetchDetails,
+                            std::shared_ptr<TimeSeries> data)
+    {
+        QVERIFY(!data->empty());
+        fetchedTypes.push_back(fetchDetails.dataType);
+    });
+
+    // Like DataConnector adding two data sources, one call each
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+    importer.fetchData(WindSpeed, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+
+    QTRY_COMPARE(fetchedTypes.size(), std::size_t(2));
+    QVERIFY(std::count(fetchedTypes.begin(), fetchedTypes.end(),
+                       Temperature) == 1);
+    QVERIFY(std::count(fetchedTypes.begin(), fetchedTypes.end(),
+                       WindSpeed) == 1);
+
+    QCOMPARE(server.requestPaths().size(), std::size_t(1));
+    QVERIFY(server.requestPaths().front().contains("t2m"));
+    QVERIFY(server.requestPaths().front().contains("ws_10min"));
+}
+
+void TestFetching::sameUrlIsRequestedOnce()
+{
+    HttpStubServer server([](const QByteArray& path)
+    {
+        return makeFmiReply(path, POINT_STEP_SECS);
+    });
+    server.setHoldReplies(true);
+
+    FmiDataImporter importer(server.baseUrl());
+
+    // Stores how many times the data starting at each time has been fetched
+    std::map<qint64, int> fetchCounts;
+    connect(&importer, &DataImporter::dataFetched, this,
+            [&fetchCounts](DataFetchDetails fetchDetails,
+                           std::shared_ptr<TimeSeries> data)
+    {
+        QVERIFY(!data->empty());
+        fetchCounts[fetchDetails.startDateTime.toSecsSinceEpoch()]++;
+    });
+
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+    importer.fetchData(Temperature, dateTime(day(6)), dateTime(day(12)),
+                       "Tampere");
+
+    QTRY_COMPARE(server.heldReplyCount(), 2);
+
+    // A later fetch of a URL still in flight waits for the same reply
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+    QTest::qWait(100);
+
+    QCOMPARE(server.requestPaths().size(), std::size_t(2));
+    QVERIFY(server.requestPaths().at(0) != server.requestPaths().at(1));
+
+    while (server.releaseFirstHeldReply())
+    {
+    }
+
+    QTRY_COMPARE(fetchCounts[day(0)], 3);
+    QCOMPARE(fetchCounts[day(6)], 1);
+
+    // Once the reply has arrived, fetching the URL again sends a new request
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+    QTRY_COMPARE(server.requestPaths().size(), std::size_t(3));
+    QCOMPARE(server.requestPaths().at(2), server.requestPaths().at(0));
+}
+
+void TestFetching::parsingKeepsEventLoopResponsive()
+{
+    // Record the reply first, making it would stall the event loop itself
+    QByteArray recordedPath = "/wfs?starttime="
+        + dateTime(day(0)).toUTC().toString(Qt::ISODate).toLatin1()
+        + "&endtime="
+        + dateTime(day(6)).toUTC().toString(Qt::ISODate).toLatin1()
+        + "&parameters=t2m";
+    HttpStubReply recordedReply = makeFmiReply(recordedPath,
+                                               LARGE_REPLY_STEP_SECS);
+    QVERIFY(recordedReply.body.size() > 45 * 1000 * 1000);
+
+    HttpStubServer server([&recordedReply](const QByteArray& path)
+    {
+        Q_UNUSED(path);
+        return recordedReply;
+    });
+
+    FmiDataImporter importer(server.baseUrl());
+
+    std::size_t fetchedPointCount = 0;
+    bool fetched = false;
+    connect(&importer, &DataImporter::dataFetched, this,
+            [&](DataFetchDetails fetchDetails,
+                std::shared_ptr<TimeSeries> data)
+    {
+        Q_UNUSED(fetchDetails);
+        fetchedPointCount += data->size();
+        fetched = true;
+    });
+
+    // Measure the longest time between the ticks of a timer
+    QElapsedTimer clock;
+    qint64 lastTickMilliseconds = 0;
+    qint64 longestStallMilliseconds = 0;
+    QTimer ticker;
+    ticker.setInterval(EVENT_LOOP_TICK_MILLISECONDS);
+    connect(&ticker, &QTimer::timeout, this, [&]()
+    {
+        qint64 tickMilliseconds = clock.elapsed();
+        longestStallMilliseconds = std::max(longestStallMilliseconds,
+            tickMilliseconds - lastTickMilliseconds);
+        lastTickMilliseconds = tickMilliseconds;
+    });
+
+    clock.start();
+    ticker.start();
+    importer.fetchData(Temperature, dateTime(day(0)), dateTime(day(6)),
+                       "Tampere");
+
+    QTRY_VERIFY_WITH_TIMEOUT(fetched, 60000);
+    ticker.stop();
+
+    QCOMPARE(fetchedPointCount,
+             std::size_t(6 * DAY_SECS / LARGE_REPLY_STEP_SECS + 1));
+    QVERIFY2(longestStallMilliseconds < MAX_EVENT_LOOP_STALL_MILLISECONDS,
+             qPrintable(QString("The event loop stalled for %1 ms")
+                        .arg(longestStallMilliseconds)));
+}
+
+void TestFetching::recordEmittedIntervals(DataImporter* importer,
+                                          std::vector<TimeInterval>& emitted)
+{
+    connect(importer, &DataImporter::dataFetched, this,
+            [&emitted](DataFetchDetails fetchDetails,
+                       std::shared_ptr<TimeSeries>)
+    {
+        emitted.push_back({ fetchDetails.startDateTime.toSecsSinceEpoch(),
+                            fetchDetails.endDateTime.toSecsSinceEpoch() });
+    });
+}
+
+void TestFetching::scheduleRequests(RequestScheduler& scheduler,
+                                    const HttpStubServer& server,
+                                    const std::vector<std::string>& paths,
+                                    qint64 startSecs, qint64 endSecs)
+{
+    for (const std::string& path : paths)
+    {
+        scheduler.scheduleRequest(server.baseUrl() + path, "", "",
+                                  startSecs, endSecs);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFetching)
+
+#include "tst_fetching.moc"
@@ -0,0 +1,262 @@
+/**
+  * @file tst_parsing.cpp compares parsing API replies as a stream with
+  * XmlParser to building a DOM of the whole reply first, the way replies
+  * were parsed before.
+  * @date 16.10.2026
+  */
+
+#include "DataImporting/fmidataimporter.hh"
+#include "DataImporting/xmlparser.hh"
+#include "fmistub.hh"
+#include "memoryusage.hh"
+
+#include <QDomDocument>
+#include <QtTest>
+
+using namespace DataImporting;
+
+// The recorded reply starts here and lasts a month, like a multi-month pull
+// split into requests
+static const qint64 START_SECS = 1600041600;
+static const qint64 RECORDED_SECS = 30 * 24 * 60 * 60;
+
+// The recorded reply has a data point every this many seconds, which makes
+// it about 50 MB of XML
+static const qint64 POINT_STEP_SECS = 10;
+
+// Stores how large the chunks are that the stream is parsed in, about what
+// a network reply has available at a time
+static const int CHUNK_SIZE = 64 * 1024;
+
+// Stores the URL the recorded reply is parsed for
+static const std::string RECORDED_URL = "recorded";
+
+/**
+ * @brief The RecordParsingFmiDataImporter class gives the tests the record
+ * parsing of FmiDataImporter.
+ */
+class RecordParsingFmiDataImporter : public FmiDataImporter
+{
+public:
+    using FmiDataImporter::createRecordParser;
+    using FmiDataImporter::getRecordDepth;
+};
+
+/**
+ * @brief The TestParsing class tests and benchmarks parsing FMI replies.
+ */
+class TestParsing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief initTestCase records the reply the tests parse.
+     */
+    void initTestCase();
+
+    /**
+     * @brief streamMatchesDom checks that both ways of parsing give the same
+     * data points.
+     */
+    void streamMatchesDom();
+
+    /**
+     * @brief parseTime_data makes a row for both ways of parsing.
+     */
+    void parseTime_data();
+
+    /**
+     * @brief parseTime benchmarks how long parsing the recorded reply takes.
+     */
+    void parseTime();
+
+    /**
+     * @brief parsePeakMemory measures how much the peak memory use grows
+     * while the recorded reply is parsed and checks that the stream needs
+     * less than the DOM.
+     */
+    void parsePeakMemory();
+
+private:
+    /**
+     * @brief parseAsStream parses the recorded reply in chunks with
+     * XmlParser.
+     * @return The parsed data points
+     */
+    std::vector<ParsedDataPoint> parseAsStream();
+
+    /**
+     * @brief parseAsDom builds a DOM of the recorded reply and parses each
+     * record element of it.
+     * @return The parsed data points
+     */
+    std::vector<ParsedDataPoint> parseAsDom();
+
+    /**
+     * @brief peakGrowth measures how much the peak memory use grows while
+     * the recorded reply is parsed.
+     * @param parse: The way to parse the reply
+     * @return The growth in bytes
+     */
+    qint64 peakGrowth(std::vector<ParsedDataPoint> (TestParsing::*parse)());
+
+    RecordParsingFmiDataImporter importer_;
+
+    QByteArray recordedReply_;
+};
+
+void TestParsing::initTestCase()
+{
+    QByteArray path = "/wfs?starttime="
+        + QDateTime::fromSecsSinceEpoch(START_SECS, Qt::UTC)
+              .toString(Qt::ISODate).toLatin1()
+        + "&endtime="
+        + QDateTime::fromSecsSinceEpoch(START_SECS + RECORDED_SECS, Qt::UTC)
+              .toString(Qt::ISODate).toLatin1()
+        + "&parameters=t2m";
+
+    recordedReply_ = makeFmiReply(path, POINT_STEP_SECS).body;
+    QVERIFY(recordedReply_.size() > 45 * 1000 * 1000);
+}
+
+void TestParsing::streamMatchesDom()
+{
+    std::vector<ParsedDataPoint> streamed = parseAsStream();
+    std::vector<ParsedDataPoint> parsed = parseAsDom();
+
+    QCOMPARE(streamed.size(),
+             std::size_t(RECORDED_SECS / POINT_STEP_SECS + 1));
+    QCOMPARE(parsed.size(), streamed.size());
+
+    for (std::size_t i = 0; i < streamed.size(); i++)
+    {
+        QCOMPARE(streamed.at(i).dataType, Temperature);
+        QCOMPARE(parsed.at(i).dataType, Temperature);
+        QCOMPARE(streamed.at(i).dataPoint.secsSinceEpoch,
+                 START_SECS + qint64(i) * POINT_STEP_SECS);
+        QCOMPARE(parsed.at(i).dataPoint.secsSinceEpoch,
+                 streamed.at(i).dataPoint.secsSinceEpoch);
+        QCOMPARE(parsed.at(i).dataPoint.value, streamed.at(i).dataPoint.value);
+    }
+}
+
+void TestParsing::parseTime_data()
+{
+    QTest::addColumn<bool>("stream");
+
+    QTest::newRow("DOM") << false;
+    QTest::newRow("stream") << true;
+}
+
+void TestParsing::parseTime()
+{
+    QFETCH(bool, stream);
+
+    std::size_t pointCount = 0;
+
+    QBENCHMARK
+    {
+        pointCount = stream ? parseAsStream().size() : parseAsDom().size();
+    }
+
+    QCOMPARE(pointCount, std::size_t(RECORDED_SECS / POINT_STEP_SECS + 1));
+}
+
+void TestParsing::parsePeakMemory()
+{
+    if (!resetPeakResidentBytes() || peakResidentBytes() < 0)
+    {
+        QSKIP("Peak memory use can't be measured on this system");
+    }
+
+    qint64 domGrowth = peakGrowth(&TestParsing::parseAsDom);
+    qint64 streamGrowth = peakGrowth(&TestParsing::parseAsStream);
+
+    qInfo("Peak memory growth of a %d byte reply: DOM %lld bytes, "
+          "stream %lld bytes", recordedReply_.size(), domGrowth,
+          streamGrowth);
+
+    QVERIFY(streamGrowth < domGrowth);
+}
+
+std::vector<ParsedDataPoint> TestParsing::parseAsStream()
+{
+    std::vector<ParsedDataPoint> parsedDataPoints;
+
+    XmlParser parser(importer_.getRecordDepth(),
+                     importer_.createRecordParser());
+
+    // The parser lives in this thread here, so the signal is delivered
+    // right away
+    connect(&parser, &XmlParser::dataPointsParsed, this,
+            [&parsedDataPoints](const std::vector<ParsedDataPoint>& dataPoints,
+                                const std::string& url, quint64 generation)
+    {
+        Q_UNUSED(url);
+        Q_UNUSED(generation);
+
+        parsedDataPoints.insert(parsedDataPoints.end(), dataPoints.begin(),
+                                dataPoints.end());
+    });
+
+    for (int position = 0; position < recordedReply_.size();
+         position += CHUNK_SIZE)
+    {
+        parser.parseXmlData(recordedReply_.mid(position, CHUNK_SIZE),
+                            RECORDED_URL, 1);
+    }
+
+    parser.finishXml(RECORDED_URL, 1);
+
+    return parsedDataPoints;
+}
+
+std::vector<ParsedDataPoint> TestParsing::parseAsDom()
+{
+    std::vector<ParsedDataPoint> parsedDataPoints;
+
+    XmlRecordParser recordParser = importer_.createRecordParser();
+
+    QDomDocument document;
+    document.setContent(recordedReply_);
+
+    // The records are wfs:member/BsWfs:BsWfsElement elements
+    for (QDomElement member = document.documentElement().firstChildElement();
+         !member.isNull(); member = member.nextSiblingElement())
+    {
+        XmlRecord record;
+
+        for (QDomElement field = member.firstChildElement()
+                 .firstChildElement();
+             !field.isNull(); field = field.nextSiblingElement())
+        {
+            record[field.tagName()] = field.text();
+        }
+
+        ParsedDataPoint parsedDataPoint;
+
+        if (recordParser(record, RECORDED_URL, parsedDataPoint))
+        {
+            parsedDataPoints.push_back(parsedDataPoint);
+        }
+    }
+
+    return parsedDataPoints;
+}
+
+qint64 TestParsing::peakGrowth(
+    std::vector<ParsedDataPoint> (TestParsing::*parse)())
+{
+    resetPeakResidentBytes();
+    qint64 residentBefore = residentBytes();
+
+    std::size_t pointCount = (this->*parse)().size();
+    Q_UNUSED(pointCount);
+
+    return peakResidentBytes() - residentBefore;
+}
+
+QTEST_GUILESS_MAIN(TestParsing)
+
+#include "tst_parsing.moc"
@@ -0,0 +1,19 @@
+# Settings shared by every test, sources are compiled from WeatherElectricMain
+QT += testlib
+QT -= gui
+
+CONFIG += c++11 qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+include(../sanitize.pri)
+
+TEMPLATE = app
+
+MAIN_DIR = $$PWD/../WeatherElectricMain
+INCLUDEPATH += $$MAIN_DIR $$MAIN_DIR/DataImporting
+DEPENDPATH += $$MAIN_DIR $$MAIN_DIR/DataImporting
+
+# Helpers shared by the tests, such as the stub server
+COMMON_DIR = $$PWD/common
+INCLUDEPATH += $$COMMON_DIR
+DEPENDPATH += $$COMMON_DIR
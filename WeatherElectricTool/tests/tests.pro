@@ -0,0 +1,11 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    dataimporting \
+    datasegmenter \
+    datajournal \
+    cachefilehandler \
+    dataconnector \
+    fetching \
+    parsing \
+    weathergraph
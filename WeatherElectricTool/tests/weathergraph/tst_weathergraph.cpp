@@ -0,0 +1,321 @@
+/**
+  * @file tst_weathergraph.cpp benchmarks drawing WeatherGraph and updating
+  * the points of its series.
+  * @date 16.10.2026
+  */
+
+#include "weathergraph.hh"
+#include "DataImporting/rolluppyramid.hh"
+#include "DataImporting/timeseries.hh"
+
+#include <QtTest>
+
+#include <cmath>
+
+using namespace DataImporting;
+
+// The data starts here, the graph counts its times from the epoch like in
+// the program
+static const qint64 START_SECS = 1600041600;
+static const qint64 DAY_SECS = 24 * 60 * 60;
+static const qint64 MONTH_SECS = 30 * DAY_SECS;
+
+// The data has a point every minute
+static const qint64 MINUTE_SECS = 60;
+
+// Stores how many data points each benchmarked series has, and how many are
+// added to a series when it's updated
+static const int UPDATE_POINT_COUNT = 100000;
+
+// Stores how many data points the trimmed series has, and how many times
+// how many of them are trimmed
+static const int TRIMMED_POINT_COUNT = 1000000;
+static const int TRIM_COUNT = 100;
+static const int POINTS_PER_TRIM = 1000;
+
+// Stores the size of the chart view, the program uses its width as the
+// resolution of the series
+static const int VIEW_WIDTH = 1000;
+static const int VIEW_HEIGHT = 600;
+
+/**
+ * @brief minutePoints makes data points a minute apart that vary daily.
+ * @param startSecs: The time of the first data point
+ * @param count: How many data points to make
+ * @return The data points
+ */
+static QVector<QPointF> minutePoints(qint64 startSecs, int count)
+{
+    QVector<QPointF> points;
+    points.reserve(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        qint64 time = startSecs + i * MINUTE_SECS;
+
+        points.append(QPointF(time, 10 * std::sin(2 * M_PI * time / DAY_SECS)
+                                    + i % 7));
+    }
+
+    return points;
+}
+
+/**
+ * @brief decimatedPoints decimates data points the way DataConnector does
+ * for a chart as wide as the view.
+ * @param points: The data points in chronological order
+ * @param intervalSecs: The length of the shown time interval
+ * @return The smallest and largest data point of every bucket
+ */
+static QVector<QPointF> decimatedPoints(const QVector<QPointF>& points,
+                                        qint64 intervalSecs)
+{
+    // Like DataConnector::calcBucketSecs
+    qint64 bucketCount = VIEW_WIDTH / 2;
+    qint64 bucketSecs = RollupPyramid::bucketLength(
+        (intervalSecs + bucketCount - 1) / bucketCount);
+
+    TimeSeries series;
+
+    for (const QPointF& point : points)
+    {
+        series.append(qint64(point.x()), float(point.y()));
+    }
+
+    QVector<QPointF> decimated;
+    series.view(qint64(points.first().x()), qint64(points.last().x()))
+        .forEachDecimatedPoint(bucketSecs,
+                               [&decimated](qint64 time, float value)
+    {
+        decimated.append(QPointF(time, value));
+    });
+
+    return decimated;
+}
+
+/**
+ * @brief dataSeries makes a DataSeries of data points like DataConnector.
+ * @param points: The data points
+ * @return The DataSeries, whose line series the caller owns
+ */
+static DataSeries dataSeries(const QVector<QPointF>& points)
+{
+    QLineSeries* lineSeries = new QLineSeries;
+    lineSeries->replace(points);
+
+    float maxY = std::numeric_limits<float>::lowest();
+    float minY = std::numeric_limits<float>::max();
+
+    for (const QPointF& point : points)
+    {
+        maxY = std::max(maxY, float(point.y()));
+        minY = std::min(minY, float(point.y()));
+    }
+
+    return { "degC", lineSeries, nullptr, maxY, minY, 0, nullptr };
+}
+
+/**
+ * @brief The TestWeatherGraph class benchmarks WeatherGraph.
+ */
+class TestWeatherGraph : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief drawTime_data makes a row for a month of raw minute data and
+     * for the same month decimated for the chart.
+     */
+    void drawTime_data();
+
+    /**
+     * @brief drawTime benchmarks how long drawing a frame of the graph takes.
+     */
+    void drawTime();
+
+    /**
+     * @brief addPointsTime_data makes a row for adding points after and
+     * before the existing ones.
+     */
+    void addPointsTime_data();
+
+    /**
+     * @brief addPointsTime benchmarks adding 100 000 data points to a series
+     * of as many data points on the graph.
+     */
+    void addPointsTime();
+
+    /**
+     * @brief fourSeriesDrawTime_data makes a row for drawing the series as
+     * splines and as polylines with OpenGL.
+     */
+    void fourSeriesDrawTime_data();
+
+    /**
+     * @brief fourSeriesDrawTime benchmarks how long drawing a frame of a
+     * chart of four 100 000 point series takes.
+     */
+    void fourSeriesDrawTime();
+
+    /**
+     * @brief trimTime_data makes a row for trimming either end of a series.
+     */
+    void trimTime_data();
+
+    /**
+     * @brief trimTime benchmarks trimming a series of a million data points
+     * on the graph a hundred times.
+     */
+    void trimTime();
+};
+
+void TestWeatherGraph::drawTime_data()
+{
+    QTest::addColumn<bool>("decimated");
+
+    QTest::newRow("raw") << false;
+    QTest::newRow("decimated") << true;
+}
+
+void TestWeatherGraph::drawTime()
+{
+    QFETCH(bool, decimated);
+
+    QVector<QPointF> points = minutePoints(START_SECS,
+                                           MONTH_SECS / MINUTE_SECS);
+
+    if (decimated)
+    {
+        points = decimatedPoints(points, MONTH_SECS);
+        QVERIFY(points.size() <= VIEW_WIDTH + 2);
+    }
+
+    // The view owns the graph
+    WeatherGraph* graph = new WeatherGraph(QDateTime::fromSecsSinceEpoch(0));
+    QVERIFY(graph->addActiveSeries({ "Temperature", dataSeries(points) }));
+
+    QChartView view(graph);
+    view.resize(VIEW_WIDTH, VIEW_HEIGHT);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QBENCHMARK
+    {
+        view.grab();
+    }
+}
+
+void TestWeatherGraph::addPointsTime_data()
+{
+    QTest::addColumn<bool>("addBefore");
+
+    QTest::newRow("append") << false;
+    QTest::newRow("prepend") << true;
+}
+
+void TestWeatherGraph::addPointsTime()
+{
+    QFETCH(bool, addBefore);
+
+    // The graph owns the series it shows
+    WeatherGraph graph(QDateTime::fromSecsSinceEpoch(0));
+    DataSeries shownSeries = dataSeries(minutePoints(START_SECS,
+                                                     UPDATE_POINT_COUNT));
+    QVERIFY(graph.addActiveSeries({ "Temperature", shownSeries }));
+
+    // The added points are made before the benchmark, like DataConnector
+    // makes them before the graph gets them
+    qint64 addedStartSecs = addBefore
+        ? START_SECS - UPDATE_POINT_COUNT * MINUTE_SECS
+        : START_SECS + UPDATE_POINT_COUNT * MINUTE_SECS;
+    DataSeries addedSeries = dataSeries(minutePoints(addedStartSecs,
+                                                     UPDATE_POINT_COUNT));
+
+    QBENCHMARK_ONCE
+    {
+        graph.addPointsToSeries("Temperature", addedSeries, addBefore);
+    }
+
+    // The points are added to the shown series in place
+    QCOMPARE(shownSeries.lineSeries->count(), 2 * UPDATE_POINT_COUNT);
+    QCOMPARE(qint64(shownSeries.lineSeries->at(0).x()),
+             std::min(START_SECS, addedStartSecs));
+}
+
+void TestWeatherGraph::fourSeriesDrawTime_data()
+{
+    QTest::addColumn<bool>("spline");
+
+    QTest::newRow("spline") << true;
+    QTest::newRow("OpenGL polyline") << false;
+}
+
+void TestWeatherGraph::fourSeriesDrawTime()
+{
+    QFETCH(bool, spline);
+
+    // A plain chart, since WeatherGraph would pick the polylines itself for
+    // this many points. The view owns the chart and the chart its series.
+    QChart* chart = new QChart;
+
+    for (int i = 0; i < MAX_SERIES; i++)
+    {
+        QLineSeries* series = spline ? new QSplineSeries : new QLineSeries;
+        series->replace(minutePoints(START_SECS + i * MINUTE_SECS / 4,
+                                     UPDATE_POINT_COUNT));
+        series->setUseOpenGL(!spline);
+        chart->addSeries(series);
+    }
+    chart->createDefaultAxes();
+
+    QChartView view(chart);
+    view.resize(VIEW_WIDTH, VIEW_HEIGHT);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QBENCHMARK
+    {
+        view.grab();
+    }
+}
+
+void TestWeatherGraph::trimTime_data()
+{
+    QTest::addColumn<bool>("delBefore");
+
+    QTest::newRow("front") << true;
+    QTest::newRow("back") << false;
+}
+
+void TestWeatherGraph::trimTime()
+{
+    QFETCH(bool, delBefore);
+
+    // The graph owns the series it shows
+    WeatherGraph graph(QDateTime::fromSecsSinceEpoch(0));
+    DataSeries shownSeries = dataSeries(minutePoints(START_SECS,
+                                                     TRIMMED_POINT_COUNT));
+    QVERIFY(graph.addActiveSeries({ "Temperature", shownSeries }));
+
+    QBENCHMARK_ONCE
+    {
+        for (int i = 0; i < TRIM_COUNT; i++)
+        {
+            int delIndex = delBefore
+                ? POINTS_PER_TRIM
+                : shownSeries.lineSeries->count() - POINTS_PER_TRIM;
+            graph.removePointsFromSeries("Temperature", delIndex, delBefore);
+        }
+    }
+
+    int trimmedCount = TRIM_COUNT * POINTS_PER_TRIM;
+    QCOMPARE(shownSeries.lineSeries->count(),
+             TRIMMED_POINT_COUNT - trimmedCount);
+    QCOMPARE(qint64(shownSeries.lineSeries->at(0).x()),
+             START_SECS + (delBefore ? trimmedCount * MINUTE_SECS : 0));
+}
+
+QTEST_MAIN(TestWeatherGraph)
+
+#include "tst_weathergraph.moc"
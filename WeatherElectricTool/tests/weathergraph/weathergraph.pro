@@ -0,0 +1,21 @@
+include(../tests.pri)
+
+# The graphs are drawn in a chart view
+QT += gui charts widgets
+
+TARGET = tst_weathergraph
+
+SOURCES += \
+    tst_weathergraph.cpp \
+    $$MAIN_DIR/weatherchartbase.cpp \
+    $$MAIN_DIR/weathergraph.cpp \
+    $$MAIN_DIR/DataImporting/timeseries.cpp \
+    $$MAIN_DIR/DataImporting/rolluppyramid.cpp \
+    $$MAIN_DIR/DataImporting/minmaxtree.cpp
+
+HEADERS += \
+    $$MAIN_DIR/weatherchartbase.hh \
+    $$MAIN_DIR/weathergraph.hh \
+    $$MAIN_DIR/DataImporting/timeseries.hh \
+    $$MAIN_DIR/DataImporting/rolluppyramid.hh \
+    $$MAIN_DIR/DataImporting/minmaxtree.hh